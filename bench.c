@@ -0,0 +1,645 @@
+/*
+ * Неинтерактивные замеры операций над многочленами.
+ *
+ *   lab3_bench [-d СТЕПЕНИ] [-m МОДУЛИ] [-k СТЕПЕНЬ_M] [-o ОПЕРАЦИИ]
+ *              [-r ПОВТОРЫ] [-w ПРОГРЕВ] [-f csv|json] [-O ФАЙЛ] ...
+ *   lab3_bench --tune pol_tune.cfg
+ *
+ * Для каждой тройки (операция, модуль, степень) делается несколько
+ * прогревочных запусков, затем ПОВТОРЫ замеров. Короткие операции в одном
+ * замере повторяются, пока он не займёт не меньше --min-time мкс, и время
+ * делится на число повторений. По замерам выводятся медиана, 95-й процентиль
+ * и минимум нс/операцию, пропускная способность и счётчики mem_tracker.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/polynomial.h"
+#include "include/string_utils.h"
+#include "include/pol_par.h"
+#include "include/pol_tune.h"
+#include "include/pol_rng.h"
+#include "include/pol_io.h"
+#include "include/mem_tracker.h"
+
+#define BENCH_MAX_LIST 64
+
+typedef struct BenchConfig
+{
+    size_t degrees[BENCH_MAX_LIST];
+    size_t degree_count;
+    ULL moduli[BENCH_MAX_LIST];
+    size_t modulus_count;
+    long mod_degree;            // -1 — степень + 1
+    const char* ops;            // NULL — все операции
+    size_t reps;
+    size_t warmup;
+    size_t min_time_us;
+    size_t batch;
+    int threads;
+    int json;
+    const char* output;
+    const char* config;         // файл порогов для pol_tune_load
+    const char* tune;           // подобрать пороги и записать в этот файл
+    ULL seed;
+} BenchConfig;
+
+/* Данные одного замера: операнды, результат и вся вспомогательная память */
+typedef struct BenchCase
+{
+    ULL modulo;
+    size_t degree;
+    Polynomial A, B, M, W, R;      // W — делимое степени 2 * degree для mod
+    PolModCtx ctx;
+    PolModulusCtx modulus;
+    PolWorkspace ws;
+    char* text;                     // A в виде строки для from_str
+    size_t text_size;
+    Polynomial* batch_a;
+    Polynomial* batch_b;
+    Polynomial* batch_r;
+    size_t batch;
+    ULL scalar;
+} BenchCase;
+
+typedef struct BenchOp
+{
+    const char* name;
+    int (*run)(BenchCase* c);
+    size_t per_call;            // произведений за вызов (для batch)
+    int threaded;               // работу делят потоки OpenMP: память считается по всему процессу
+} BenchOp;
+
+/*--------------------- ОПЕРАЦИИ ---------------------*/
+
+static int op_copy(BenchCase* c)        { return copy_pol(&c->A, &c->R); }
+static int op_sum(BenchCase* c)         { return sum_pol(&c->A, &c->B, &c->R); }
+static int op_sub(BenchCase* c)         { return sub_pol(&c->A, &c->B, &c->R); }
+static int op_scalar(BenchCase* c)      { return scalar_mul_pol(&c->A, c->scalar, &c->R); }
+static int op_dot(BenchCase* c)         { ULL r; return dot_pol(&c->A, &c->B, &r); }
+static int op_mul(BenchCase* c)         { return pol_mul_pol(&c->A, &c->B, &c->R); }
+static int op_mul_ctx(BenchCase* c)     { return pol_mul_pol_ctx(&c->A, &c->B, &c->R, &c->ctx); }
+static int op_mul_ws(BenchCase* c)      { return pol_mul_pol_ws(&c->A, &c->B, &c->R, &c->ws, &c->ctx); }
+static int op_mod(BenchCase* c)         { return modulo_unit_pol(&c->W, &c->M, &c->R); }
+static int op_mulmod(BenchCase* c)      { return pol_mul_mod_unit(&c->A, &c->B, &c->M, &c->R); }
+static int op_mulmod_ctx(BenchCase* c)  { return pol_mul_mod_unit_ctx(&c->A, &c->B, &c->M, &c->R, &c->ctx); }
+static int op_mulmod_ws(BenchCase* c)   { return pol_mul_mod_unit_ws(&c->A, &c->B, &c->M, &c->R, &c->ws, &c->ctx); }
+static int op_modulus(BenchCase* c)     { return pol_mul_mod_ctx(&c->A, &c->B, &c->modulus, &c->R); }
+
+static int op_modulus_init(BenchCase* c)
+{
+    PolModulusCtx ctx;
+    int status = pol_modulus_init(&ctx, &c->M);
+    if (status == POL_SUCCESS)
+        pol_modulus_free(&ctx);
+    return status;
+}
+
+static int op_batch(BenchCase* c)
+{
+    return pol_mul_mod_batch_ctx(c->batch_a, c->batch_b, c->batch, &c->modulus, c->batch_r);
+}
+
+static int op_to_str(BenchCase* c)
+{
+    char* str = NULL;
+    size_t size = 0;
+    int status = pol_to_str(&c->A, &str, &size);
+    if (status == POL_SUCCESS)
+        free(str, size);
+    return status;
+}
+
+/* Та же строка в готовый буфер c->text (его размер — оценка pol_str_bound) */
+static int op_to_str_buf(BenchCase* c)  { return pol_to_str_buf(&c->A, c->text, c->text_size, NULL); }
+static int op_from_str(BenchCase* c)    { return str_to_pol(c->text, c->modulo, &c->R); }
+
+/* Двоичный файл с A; case_init записывает его заранее для load_bin и map_bin */
+#define BENCH_BIN_FILE "lab3_bench.polb"
+
+static int op_save_bin(BenchCase* c)    { return pol_save_bin(BENCH_BIN_FILE, &c->A, 0); }
+static int op_load_bin(BenchCase* c)    { return pol_load_bin(BENCH_BIN_FILE, &c->R); }
+
+static int op_map_bin(BenchCase* c)
+{
+    (void)c;
+    PolMapping map;
+    Polynomial P = { NULL, 0, 0, 0 };
+    int status = pol_map_bin(BENCH_BIN_FILE, &map, &P);
+    free_pol(&P);
+    pol_unmap_bin(&map);
+    return status;
+}
+
+static const BenchOp g_ops[] =
+{
+    { "copy",          op_copy,          1, 0 },
+    { "sum",           op_sum,           1, 0 },
+    { "sub",           op_sub,           1, 0 },
+    { "scalar",        op_scalar,        1, 0 },
+    { "dot",           op_dot,           1, 0 },
+    { "mul",           op_mul,           1, 0 },
+    { "mul_ctx",       op_mul_ctx,       1, 0 },
+    { "mul_ws",        op_mul_ws,        1, 0 },
+    { "mod",           op_mod,           1, 0 },
+    { "mulmod",        op_mulmod,        1, 0 },
+    { "mulmod_ctx",    op_mulmod_ctx,    1, 0 },
+    { "mulmod_ws",     op_mulmod_ws,     1, 0 },
+    { "modulus_init",  op_modulus_init,  1, 0 },
+    { "modulus",       op_modulus,       1, 0 },
+    { "batch",         op_batch,         0, 1 },   // per_call = размер пакета
+    { "to_str",        op_to_str,        1, 0 },
+    { "to_str_buf",    op_to_str_buf,    1, 0 },
+    { "from_str",      op_from_str,      1, 0 },
+    { "save_bin",      op_save_bin,      1, 0 },
+    { "load_bin",      op_load_bin,      1, 0 },
+    { "map_bin",       op_map_bin,       1, 0 },
+};
+
+#define BENCH_OP_COUNT (sizeof(g_ops) / sizeof(g_ops[0]))
+
+/*--------------------- ПОДГОТОВКА ДАННЫХ ---------------------*/
+
+static PolRng g_rng;    // воспроизводимые данные при одном --seed
+
+static void case_free(BenchCase* c)
+{
+    free_pol(&c->A); free_pol(&c->B); free_pol(&c->M); free_pol(&c->W); free_pol(&c->R);
+    pol_modulus_free(&c->modulus);
+    pol_ws_free(&c->ws);
+
+    if (c->text != NULL)
+        free(c->text, c->text_size);
+    remove(BENCH_BIN_FILE);
+
+    Polynomial* arrays[3] = { c->batch_a, c->batch_b, c->batch_r };
+    for (size_t k = 0; k < 3; k++)
+    {
+        if (arrays[k] == NULL)
+            continue;
+        for (size_t i = 0; i < c->batch; i++)
+            free_pol(&arrays[k][i]);
+        free(arrays[k], c->batch * sizeof(Polynomial));
+    }
+}
+
+static int case_init(BenchCase* c, ULL modulo, size_t degree, size_t mod_degree, size_t batch)
+{
+    memset(c, 0, sizeof(*c));
+    c->modulo = modulo;
+    c->degree = degree;
+    c->batch = batch;
+    c->scalar = pol_rng_below(&g_rng, modulo);
+
+    int status = pol_modctx_init(&c->ctx, modulo);
+    if (status == POL_SUCCESS) status = pol_rng_pol(&g_rng, &c->A, degree, modulo);
+    if (status == POL_SUCCESS) status = pol_rng_pol(&g_rng, &c->B, degree, modulo);
+    if (status == POL_SUCCESS) status = pol_rng_pol(&g_rng, &c->W, 2 * degree, modulo);
+    if (status == POL_SUCCESS) status = pol_rng_pol(&g_rng, &c->M, mod_degree, modulo);
+    if (status == POL_SUCCESS) status = new_pol(&c->R, 0, modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    c->M.coeffs[mod_degree] = 1;
+
+    status = pol_modulus_init(&c->modulus, &c->M);
+    if (status == POL_SUCCESS)
+        status = pol_to_str(&c->A, &c->text, &c->text_size);
+    if (status == POL_SUCCESS)
+        status = pol_save_bin(BENCH_BIN_FILE, &c->A, 0);
+    if (status != POL_SUCCESS)
+        return status;
+
+    c->batch_a = calloc(batch, sizeof(Polynomial));
+    c->batch_b = calloc(batch, sizeof(Polynomial));
+    c->batch_r = calloc(batch, sizeof(Polynomial));
+    if (c->batch_a == NULL || c->batch_b == NULL || c->batch_r == NULL)
+        return POL_MEMORY_ERROR;
+
+    status = pol_rng_pols(&g_rng, c->batch_a, batch, degree, modulo);
+    if (status == POL_SUCCESS)
+        status = pol_rng_pols(&g_rng, c->batch_b, batch, degree, modulo);
+    for (size_t i = 0; i < batch && status == POL_SUCCESS; i++)
+        status = new_pol(&c->batch_r[i], 0, modulo);
+    return status;
+}
+
+/*--------------------- ЗАМЕР ---------------------*/
+
+typedef struct BenchResult
+{
+    int status;
+    size_t inner;               // вызовов в одном замере
+    double median_ns;           // нс на операцию
+    double p95_ns;
+    double min_ns;
+    double ops_per_s;
+    double coeffs_per_s;        // коэффициентов операнда степени degree в секунду
+    double allocs_per_op;
+    double bytes_per_op;
+    size_t peak_bytes;          // наибольший рабочий объём сверх занятого до замеров
+} BenchResult;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int run_op(const BenchOp* op, BenchCase* c, const BenchConfig* cfg, BenchResult* res)
+{
+    memset(res, 0, sizeof(*res));
+    size_t per_call = (op->per_call != 0) ? op->per_call : c->batch;
+
+    // прогрев; заодно подбираем число вызовов на замер
+    size_t inner = 1;
+    for (size_t w = 0; w <= cfg->warmup; w++)
+    {
+        double start = now_ns();
+        for (size_t i = 0; i < inner; i++)
+        {
+            res->status = op->run(c);
+            if (res->status != POL_SUCCESS)
+                return res->status;
+        }
+        double elapsed = now_ns() - start;
+
+        while (elapsed * 1e-3 < (double)cfg->min_time_us && inner < ((size_t)1 << 30))
+        {
+            inner *= 2;
+            elapsed *= 2;
+        }
+    }
+
+    double* samples = malloc(cfg->reps * sizeof(double));
+    if (samples == NULL)
+    {
+        res->status = POL_MEMORY_ERROR;
+        return res->status;
+    }
+
+    // выделения потоков OpenMP не видны в счётчиках вызывающего потока
+    void (*snapshot)(MemStats*) = op->threaded ? mem_snapshot : mem_thread_snapshot;
+
+    MemStats before, after, d;
+    mem_reset_peak();
+    snapshot(&before);
+
+    for (size_t r = 0; r < cfg->reps && res->status == POL_SUCCESS; r++)
+    {
+        double start = now_ns();
+        for (size_t i = 0; i < inner && res->status == POL_SUCCESS; i++)
+            res->status = op->run(c);
+        samples[r] = (now_ns() - start) / (double)(inner * per_call);
+    }
+
+    if (res->status != POL_SUCCESS)
+    {
+        free(samples, cfg->reps * sizeof(double));
+        return res->status;
+    }
+
+    snapshot(&after);
+    mem_diff(&before, &after, &d);
+
+    qsort(samples, cfg->reps, sizeof(double), cmp_double);
+    size_t n = cfg->reps;
+    size_t p95 = (n * 95 + 99) / 100;
+
+    double calls = (double)n * (double)inner;
+    double ops = calls * (double)per_call;
+
+    res->inner = inner;
+    res->median_ns = (n % 2) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    res->p95_ns = samples[(p95 > 0 ? p95 : 1) - 1];
+    res->min_ns = samples[0];
+    res->ops_per_s = 1e9 / res->median_ns;
+    res->coeffs_per_s = res->ops_per_s * (double)(c->degree + 1);
+    res->allocs_per_op = (double)d.alloc_count / ops;
+    res->bytes_per_op = (double)d.total_allocated / ops;
+    res->peak_bytes = d.peak;
+
+    free(samples, cfg->reps * sizeof(double));
+    return POL_SUCCESS;
+}
+
+/*--------------------- ВЫВОД ---------------------*/
+
+static void print_header(FILE* out, const BenchConfig* cfg)
+{
+    if (cfg->json)
+        fprintf(out, "[\n");
+    else
+        fprintf(out, "op,modulo,degree,mod_degree,status,reps,inner,median_ns,p95_ns,min_ns,"
+                     "ops_per_s,coeffs_per_s,allocs_per_op,bytes_per_op,peak_bytes,backend,threads\n");
+}
+
+static void print_row(FILE* out, const BenchConfig* cfg, const BenchOp* op, const BenchCase* c,
+                      const BenchResult* res, int first)
+{
+    if (cfg->json)
+    {
+        fprintf(out, "%s  {\"op\": \"%s\", \"modulo\": %llu, \"degree\": %zu, \"mod_degree\": %zu, "
+                     "\"status\": %d, \"reps\": %zu, \"inner\": %zu, \"median_ns\": %.1f, "
+                     "\"p95_ns\": %.1f, \"min_ns\": %.1f, \"ops_per_s\": %.1f, "
+                     "\"coeffs_per_s\": %.1f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f, "
+                     "\"peak_bytes\": %zu, \"backend\": \"%s\", \"threads\": %d}",
+                first ? "" : ",\n", op->name, c->modulo, c->degree, c->M.degree,
+                res->status, cfg->reps, res->inner, res->median_ns, res->p95_ns, res->min_ns,
+                res->ops_per_s, res->coeffs_per_s, res->allocs_per_op, res->bytes_per_op,
+                res->peak_bytes, mem_backend_name(), pol_get_num_threads());
+    }
+    else
+    {
+        fprintf(out, "%s,%llu,%zu,%zu,%d,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.1f,%zu,%s,%d\n",
+                op->name, c->modulo, c->degree, c->M.degree,
+                res->status, cfg->reps, res->inner, res->median_ns, res->p95_ns, res->min_ns,
+                res->ops_per_s, res->coeffs_per_s, res->allocs_per_op, res->bytes_per_op,
+                res->peak_bytes, mem_backend_name(), pol_get_num_threads());
+    }
+    fflush(out);
+}
+
+/*--------------------- АРГУМЕНТЫ ---------------------*/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -d, --degrees LIST    степени: 64,256,1024 или от:до[:множитель] (64:65536:4)\n"
+        "  -m, --moduli LIST     модули через запятую\n"
+        "  -k, --mod-degree N    степень модуля M (по умолчанию степень + 1)\n"
+        "  -o, --ops LIST        операции через запятую (по умолчанию все)\n"
+        "  -r, --reps N          число замеров (21)\n"
+        "  -w, --warmup N        число прогревочных запусков (3)\n"
+        "  -t, --min-time US     наименьшая длительность замера, мкс (2000)\n"
+        "  -b, --batch N         размер пакета для batch (64)\n"
+        "  -j, --threads N       число потоков (0 — по умолчанию OpenMP)\n"
+        "  -s, --seed N          начальное значение генератора (1)\n"
+        "  -f, --format FMT      csv или json (csv)\n"
+        "  -O, --output FILE     файл результатов (stdout)\n"
+        "  -c, --config FILE     файл порогов (по умолчанию $POL_TUNE_FILE или "
+                                 POL_TUNE_DEFAULT_FILE ")\n"
+        "  -T, --tune FILE       подобрать пороги на этой машине и записать в FILE\n"
+        "  -l, --list            список операций\n",
+        prog);
+}
+
+static int parse_size(const char* s, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || s[0] == '-')
+        return 0;
+    *out = (size_t)v;
+    return 1;
+}
+
+/* "a,b,c" или "от:до[:множитель]" */
+static int parse_degrees(const char* s, BenchConfig* cfg)
+{
+    if (strchr(s, ':') != NULL)
+    {
+        size_t from, to, factor = 2;
+        char tail;
+        int fields = sscanf(s, "%zu:%zu:%zu%c", &from, &to, &factor, &tail);
+        if (fields < 2 || fields > 3 || factor < 2 || from > to)
+            return 0;
+
+        cfg->degree_count = 0;
+        for (size_t d = from; d <= to && cfg->degree_count < BENCH_MAX_LIST;
+             d = (d == 0) ? 1 : d * factor)
+            cfg->degrees[cfg->degree_count++] = d;
+        return 1;
+    }
+
+    cfg->degree_count = 0;
+    const char* p = s;
+    while (*p != '\0' && cfg->degree_count < BENCH_MAX_LIST)
+    {
+        char* end;
+        cfg->degrees[cfg->degree_count++] = (size_t)strtoull(p, &end, 10);
+        if (end == p || (*end != ',' && *end != '\0'))
+            return 0;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return cfg->degree_count > 0;
+}
+
+static int parse_moduli(const char* s, BenchConfig* cfg)
+{
+    cfg->modulus_count = 0;
+    const char* p = s;
+    while (*p != '\0' && cfg->modulus_count < BENCH_MAX_LIST)
+    {
+        char* end;
+        ULL m = strtoull(p, &end, 10);
+        if (end == p || m <= 1 || (*end != ',' && *end != '\0'))
+            return 0;
+        cfg->moduli[cfg->modulus_count++] = m;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return cfg->modulus_count > 0;
+}
+
+/* Имя операции входит в список через запятую */
+static int op_selected(const char* list, const char* name)
+{
+    if (list == NULL)
+        return 1;
+
+    size_t len = strlen(name);
+    for (const char* p = list; *p != '\0'; )
+    {
+        const char* end = strchr(p, ',');
+        size_t n = (end != NULL) ? (size_t)(end - p) : strlen(p);
+        if (n == len && strncmp(p, name, len) == 0)
+            return 1;
+        p += n + (end != NULL);
+    }
+    return 0;
+}
+
+static int parse_args(int argc, char** argv, BenchConfig* cfg)
+{
+    static const size_t default_degrees[] = { 16, 64, 256, 1024, 4096 };
+    static const ULL default_moduli[] = { 998244353ULL, 1000000007ULL, 18446744073709551557ULL };
+
+    memset(cfg, 0, sizeof(*cfg));
+    for (size_t i = 0; i < sizeof(default_degrees) / sizeof(default_degrees[0]); i++)
+        cfg->degrees[cfg->degree_count++] = default_degrees[i];
+    for (size_t i = 0; i < sizeof(default_moduli) / sizeof(default_moduli[0]); i++)
+        cfg->moduli[cfg->modulus_count++] = default_moduli[i];
+    cfg->mod_degree = -1;
+    cfg->reps = 21;
+    cfg->warmup = 3;
+    cfg->min_time_us = 2000;
+    cfg->batch = 64;
+    cfg->seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        size_t n;
+        int ok = 1;
+
+        if (!strcmp(a, "-l") || !strcmp(a, "--list"))
+        {
+            for (size_t k = 0; k < BENCH_OP_COUNT; k++)
+                printf("%s\n", g_ops[k].name);
+            exit(0);
+        }
+        if (!strcmp(a, "-h") || !strcmp(a, "--help"))
+        {
+            usage(argv[0]);
+            exit(0);
+        }
+        if (v == NULL)
+        {
+            usage(argv[0]);
+            return 0;
+        }
+
+        if (!strcmp(a, "-d") || !strcmp(a, "--degrees"))          ok = parse_degrees(v, cfg);
+        else if (!strcmp(a, "-m") || !strcmp(a, "--moduli"))      ok = parse_moduli(v, cfg);
+        else if (!strcmp(a, "-k") || !strcmp(a, "--mod-degree"))
+        {
+            ok = parse_size(v, &n) && n >= 1;
+            cfg->mod_degree = (long)n;
+        }
+        else if (!strcmp(a, "-o") || !strcmp(a, "--ops"))         cfg->ops = v;
+        else if (!strcmp(a, "-r") || !strcmp(a, "--reps"))        ok = parse_size(v, &cfg->reps) && cfg->reps > 0;
+        else if (!strcmp(a, "-w") || !strcmp(a, "--warmup"))      ok = parse_size(v, &cfg->warmup);
+        else if (!strcmp(a, "-t") || !strcmp(a, "--min-time"))    ok = parse_size(v, &cfg->min_time_us);
+        else if (!strcmp(a, "-b") || !strcmp(a, "--batch"))       ok = parse_size(v, &cfg->batch) && cfg->batch > 0;
+        else if (!strcmp(a, "-j") || !strcmp(a, "--threads"))
+        {
+            ok = parse_size(v, &n);
+            cfg->threads = (int)n;
+        }
+        else if (!strcmp(a, "-s") || !strcmp(a, "--seed"))
+        {
+            ok = parse_size(v, &n);
+            cfg->seed = n;
+        }
+        else if (!strcmp(a, "-f") || !strcmp(a, "--format"))
+        {
+            ok = !strcmp(v, "csv") || !strcmp(v, "json");
+            cfg->json = !strcmp(v, "json");
+        }
+        else if (!strcmp(a, "-O") || !strcmp(a, "--output"))      cfg->output = v;
+        else if (!strcmp(a, "-c") || !strcmp(a, "--config"))      cfg->config = v;
+        else if (!strcmp(a, "-T") || !strcmp(a, "--tune"))        cfg->tune = v;
+        else ok = 0;
+
+        if (!ok)
+        {
+            fprintf(stderr, "bad argument: %s %s\n", a, v);
+            usage(argv[0]);
+            return 0;
+        }
+        i++;
+    }
+
+    for (size_t k = 0; cfg->ops != NULL && k < BENCH_OP_COUNT; k++)
+        if (op_selected(cfg->ops, g_ops[k].name))
+            return 1;
+    if (cfg->ops != NULL)
+    {
+        fprintf(stderr, "no known operations in \"%s\" (see --list)\n", cfg->ops);
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig cfg;
+    if (!parse_args(argc, argv, &cfg))
+        return 2;
+
+    // явно указанный файл порогов обязан загрузиться, файл по умолчанию — нет
+    int tune_status = pol_tune_load(cfg.config);
+    if (cfg.config != NULL && tune_status != POL_SUCCESS)
+    {
+        fprintf(stderr, "cannot load thresholds from %s: error %d\n", cfg.config, tune_status);
+        return 1;
+    }
+
+    pol_set_num_threads(cfg.threads);
+
+    if (cfg.tune != NULL)
+    {
+        tune_status = pol_tune_run(stderr);
+        if (tune_status == POL_SUCCESS)
+            tune_status = pol_tune_save(cfg.tune);
+        if (tune_status != POL_SUCCESS)
+        {
+            fprintf(stderr, "tuning failed: error %d\n", tune_status);
+            return 1;
+        }
+        return 0;
+    }
+
+    FILE* out = stdout;
+    if (cfg.output != NULL && (out = fopen(cfg.output, "w")) == NULL)
+    {
+        perror(cfg.output);
+        return 1;
+    }
+
+    pol_rng_seed(&g_rng, cfg.seed);
+    print_header(out, &cfg);
+
+    int first = 1;
+    int failed = 0;
+
+    for (size_t mi = 0; mi < cfg.modulus_count; mi++)
+    {
+        for (size_t di = 0; di < cfg.degree_count; di++)
+        {
+            size_t degree = cfg.degrees[di];
+            size_t mod_degree = (cfg.mod_degree > 0) ? (size_t)cfg.mod_degree : degree + 1;
+
+            BenchCase c;
+            if (case_init(&c, cfg.moduli[mi], degree, mod_degree, cfg.batch) != POL_SUCCESS)
+            {
+                fprintf(stderr, "setup failed: modulo %llu, degree %zu\n", cfg.moduli[mi], degree);
+                case_free(&c);
+                failed = 1;
+                continue;
+            }
+
+            for (size_t k = 0; k < BENCH_OP_COUNT; k++)
+            {
+                if (!op_selected(cfg.ops, g_ops[k].name))
+                    continue;
+
+                BenchResult res;
+                if (run_op(&g_ops[k], &c, &cfg, &res) != POL_SUCCESS)
+                    failed = 1;
+                print_row(out, &cfg, &g_ops[k], &c, &res, first);
+                first = 0;
+            }
+
+            case_free(&c);
+        }
+    }
+
+    if (cfg.json)
+        fprintf(out, "\n]\n");
+
+    if (out != stdout)
+        fclose(out);
+    return failed;
+}
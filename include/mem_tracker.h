@@ -3,17 +3,109 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdatomic.h>
 
-extern size_t g_total_allocated;
-extern size_t g_total_freed;
-extern size_t g_current_allocated;
+/*
+ * Счётчики памяти общие для всех потоков и обновляются атомарно, поэтому
+ * разность двух чтений остаётся верной при вызовах из нескольких потоков
+ * (в неё попадают и выделения других потоков; для замера одной операции
+ * см. mem_thread_snapshot).
+ */
+extern _Atomic size_t g_total_allocated;
+extern _Atomic size_t g_total_freed;
+extern _Atomic size_t g_current_allocated;
+extern _Atomic size_t g_peak_allocated;
 
+/* Гистограмма размеров: корзина k — выделения размером [2^(k-1), 2^k), последняя — все большие */
+#define MEM_HIST_BUCKETS 40
+
+/* Снимок счётчиков (всего процесса или одного потока) */
+typedef struct MemStats
+{
+    size_t total_allocated;     // байт выделено
+    size_t total_freed;         // байт освобождено
+    size_t current;             // байт занято сейчас
+    size_t peak;                // наибольшее значение current с последнего mem_reset_peak
+    size_t alloc_count;         // число выделений
+    size_t free_count;          // число освобождений
+    size_t histogram[MEM_HIST_BUCKETS];
+} MemStats;
+
+/*
+ * Выделение и освобождение с учётом в счётчиках. size в track_free обязан
+ * совпадать с размером при выделении (для calloc — num * size).
+ *
+ * При сборке с POL_USE_POOL память берётся из пула: размеры до
+ * MEM_POOL_MAX_BLOCK байт округляются до степени двойки (не меньше
+ * MEM_POOL_MIN_BLOCK), освобождённые блоки кладутся в список свободных
+ * блоков своего класса у текущего потока и без блокировок отдаются
+ * следующему выделению того же класса. Все блоки выровнены на 64 байта.
+ * Без POL_USE_POOL используется malloc/calloc/free библиотеки C.
+ */
 void* track_malloc(size_t size);
 void* track_calloc(size_t num, size_t size);
 void  track_free(void* ptr, size_t size);
 
+#define MEM_POOL_MIN_BLOCK 64
+#define MEM_POOL_MAX_BLOCK (1u << 20)
+
+/*
+ * Возвращает системе свободные блоки пула, накопленные вызывающим потоком
+ * (при завершении потока это происходит автоматически).
+ * Без POL_USE_POOL ничего не делает.
+ */
+void mem_pool_trim(void);
+
+
+/*
+ * Имя используемого распределителя: "pool" или "libc".
+ */
+const char* mem_backend_name(void);
+
+
+/*
+ * Снимок общих счётчиков процесса.
+ *
+ * [OUT]     s       текущие значения; поля читаются по отдельности, поэтому при
+ *                   параллельной работе снимок согласован только приблизительно
+ */
+void mem_snapshot(MemStats* s);
+
+
+/*
+ * Снимок счётчиков вызывающего потока: только его собственные выделения
+ * и освобождения.
+ *
+ * [OUT]     s       значения для текущего потока
+ *
+ * [NOTE]    Память, выделенная одним потоком и освобождённая другим, уменьшает
+ *           current второго потока; разность снимков до и после операции
+ *           в одном потоке от этого не страдает.
+ */
+void mem_thread_snapshot(MemStats* s);
+
+
+/*
+ * Разность снимков after - before: сколько выделено и освобождено между ними,
+ * изменение current и прирост пика над исходным current
+ * (peak - before->current, то есть наибольший рабочий объём операции,
+ * если перед ней был вызван mem_reset_peak).
+ *
+ * [IN]      before, after   снимки одного источника (процесс или поток)
+ * [OUT]     d               разность; current — знаковая разность,
+ *                           приведённая к size_t
+ */
+void mem_diff(const MemStats* before, const MemStats* after, MemStats* d);
+
+
+/*
+ * Сбрасывает пик (процесса и вызывающего потока) до текущего значения,
+ * чтобы следующий снимок показал пик отдельной операции.
+ */
+void mem_reset_peak(void);
+
 #define malloc(x) track_malloc(x)
 #define calloc(n,x) track_calloc(n,x)
 #define free(ptr,x) track_free(ptr,x)
 
-#endif //LAB3_MEM_TRACKER_H
\ No newline at end of file
+#endif //LAB3_MEM_TRACKER_H
@@ -0,0 +1,143 @@
+#ifndef LAB3_NTT_H
+#define LAB3_NTT_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Порог перехода на NTT: если длина меньшего множителя (степень + 1)
+ * не превышает порога, используется Карацуба или школьное умножение.
+ */
+#define POL_NTT_THRESHOLD 32
+
+/*
+ * Число одновременно хранимых таблиц корней (модуль, размер). Кэш общий
+ * для всех потоков: функции этого модуля можно вызывать параллельно.
+ */
+#define NTT_CACHE_SIZE 16
+
+/*
+ * Порог перехода на многомодульное NTT с восстановлением по КТО
+ * для модулей, не подходящих для прямого NTT.
+ */
+#define POL_NTT_CRT_THRESHOLD 128
+
+/* Число фиксированных простых для многомодульного умножения */
+#define NTT_CRT_PRIMES 3
+
+extern size_t g_ntt_threshold;
+extern size_t g_ntt_crt_threshold;
+
+/*
+ * Детерминированная проверка простоты (Миллер — Рабин) для 64-битных чисел.
+ *
+ * [RETURN]  1 — n простое, 0 — составное
+ */
+int ntt_is_prime(ULL n);
+
+
+/*
+ * Наибольшее k, для которого существует преобразование длины 2^k по модулю p,
+ * то есть p простое и 2^k делит p - 1.
+ *
+ * [RETURN]  k, или 0 если p не простое
+ *
+ * [NOTE]    Результат кэшируется для последних использованных модулей.
+ */
+unsigned ntt_max_log(ULL p);
+
+
+/*
+ * Длина преобразования для произведения na x nb коэффициентов.
+ * Выбирается либо степень двойки >= na + nb - 1 (дополнение нулями), либо
+ * вдвое меньшая длина (усечение), если лишних коэффициентов мало и их
+ * дешевле досчитать напрямую.
+ *
+ * [RETURN]  длина преобразования, или 0 если модуль p не подходит для NTT
+ */
+size_t ntt_length(ULL p, size_t na, size_t nb);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для ntt_mul(na, nb).
+ */
+size_t ntt_scratch_size(ULL p, size_t na, size_t nb);
+
+
+/*
+ * Умножение массивов коэффициентов через теоретико-числовое преобразование:
+ * r = a * b mod p, где p — простое вида c * 2^k + 1.
+ *
+ * [IN]      a, na    первый множитель (na >= 1)
+ * [IN]      b, nb    второй множитель (nb >= 1)
+ * [IN]      p        простой модуль, ntt_length(p, na, nb) != 0
+ * [IN]      scratch  рабочий буфер не менее ntt_scratch_size(p, na, nb) элементов
+ * [OUT]     r        na + nb - 1 коэффициентов произведения (перезаписываются)
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_INVALID_MODULO — p не подходит для NTT такой длины
+ *           POL_MEMORY_ERROR   — не удалось выделить таблицу корней
+ */
+int ntt_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+            ULL* r, ULL* scratch, ULL p);
+
+
+/*
+ * Прямое преобразование длины len на месте. Результат записывается в
+ * бит-реверсном порядке: он годится для поточечного умножения и обратного
+ * преобразования ntt_inverse_transform, но не для чтения по индексам.
+ *
+ * [IN/OUT]  a        len приведённых по модулю p коэффициентов (дополненных нулями)
+ * [IN]      len      степень двойки, 2 <= len <= 2^ntt_max_log(p)
+ * [IN]      p        простой модуль
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_INVALID_MODULO — p не подходит для NTT такой длины
+ *           POL_MEMORY_ERROR   — не удалось выделить таблицу корней
+ */
+int ntt_transform(ULL* a, size_t len, ULL p);
+
+
+/*
+ * Обратное преобразование длины len на месте, включая деление на len:
+ * ntt_inverse_transform(ntt_transform(a)) == a. Коды возврата — как у ntt_transform.
+ */
+int ntt_inverse_transform(ULL* a, size_t len, ULL p);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для ntt_crt_mul(na, nb).
+ *
+ * [RETURN]  размер буфера, или 0 если произведение слишком длинное для набора простых
+ */
+size_t ntt_crt_scratch_size(size_t na, size_t nb);
+
+
+/*
+ * Умножение по произвольному модулю m = ctx->modulo через несколько NTT
+ * по фиксированным 62-битным простым и восстановление по китайской теореме
+ * об остатках (схема Гарнера). Число простых выбирается по оценке
+ * na * max(a) * max(b), так что для малых модулей хватает одного-двух
+ * преобразований. Точные коэффициенты произведения (до 2^183) не строятся:
+ * смешанное представление сразу сворачивается по модулю m.
+ *
+ * [IN]      a, na    первый множитель (na >= 1)
+ * [IN]      b, nb    второй множитель (nb >= 1)
+ * [IN]      ctx      контекст модуля кольца
+ * [IN]      scratch  рабочий буфер не менее ntt_crt_scratch_size(na, nb) элементов
+ * [OUT]     r        na + nb - 1 коэффициентов произведения (перезаписываются)
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_INVALID_ARG    — произведение слишком длинное для набора простых
+ *           POL_MEMORY_ERROR   — не удалось выделить таблицу корней
+ */
+int ntt_crt_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+                ULL* r, ULL* scratch, const PolModCtx* ctx);
+
+
+/*
+ * Освобождает все закэшированные таблицы корней, кроме тех, что в этот
+ * момент используются преобразованиями в других потоках.
+ */
+void ntt_cache_clear(void);
+
+#endif //LAB3_NTT_H
@@ -0,0 +1,154 @@
+#ifndef LAB3_POL_ARITH_H
+#define LAB3_POL_ARITH_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Внутренние операции над коэффициентами в Z_m.
+ * Все функции ожидают уже приведённые аргументы (0 <= a, b < m).
+ */
+
+/* (a + b) mod m без переполнения для любого m */
+static inline ULL add_mod(ULL a, ULL b, ULL m)
+{
+    ULL s = a + b;
+    if (s >= m || s < a)
+        s -= m;
+    return s;
+}
+
+/* (a - b) mod m */
+static inline ULL sub_mod(ULL a, ULL b, ULL m)
+{
+    return (a >= b) ? a - b : a + (m - b);
+}
+
+/*
+ * (hi * 2^64 + lo) mod m для любых 64-битных hi, lo, m.
+ * Если hi < m, частное помещается в 64 бита и хватает одной инструкции divq.
+ */
+static inline ULL mod128(ULL hi, ULL lo, ULL m)
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    if (hi >= m)
+        hi %= m;
+
+    ULL q, r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(m) : "cc");
+    (void)q;
+    return r;
+#else
+    return (ULL)((((unsigned __int128)hi << 64) | lo) % m);
+#endif
+}
+
+/*
+ * (a * b) mod m для любых 64-битных a, b, m.
+ * Если произведение помещается в 64 бита, хватает обычного деления,
+ * иначе 128-битное произведение делится через mod128.
+ */
+static inline ULL mul_mod(ULL a, ULL b, ULL m)
+{
+    if ((a | b) <= 0xFFFFFFFFULL)
+        return (a * b) % m;
+
+    unsigned __int128 p = (unsigned __int128)a * b;
+    return mod128((ULL)(p >> 64), (ULL)p, m);
+}
+
+/* Число значащих битов x */
+static inline unsigned bit_length(ULL x)
+{
+    unsigned bits = 0;
+    while (x != 0)
+    {
+        bits++;
+        x >>= 1;
+    }
+    return bits;
+}
+
+/* a^e mod m */
+static inline ULL pow_mod(ULL a, ULL e, ULL m)
+{
+    ULL res = 1 % m;
+    a %= m;
+    while (e > 0)
+    {
+        if (e & 1)
+            res = mul_mod(res, a, m);
+        a = mul_mod(a, a, m);
+        e >>= 1;
+    }
+    return res;
+}
+
+/*--------------------- ОПЕРАЦИИ ЧЕРЕЗ КОНТЕКСТ МОДУЛЯ ---------------------*/
+
+/* Старшие 64 бита произведения a * b */
+static inline ULL mulhi64(ULL a, ULL b)
+{
+    return (ULL)(((unsigned __int128)a * b) >> 64);
+}
+
+/* Приведение Барретта для x < 2^64 и modulo < 2^32: остаток после q не больше 3m */
+static inline ULL barrett_reduce(const PolModCtx* c, ULL x)
+{
+    ULL m = c->modulo;
+    ULL r = x - mulhi64(x, c->barrett) * m;
+    if (r >= m) r -= m;
+    if (r >= m) r -= m;
+    return r;
+}
+
+/* REDC: t * 2^(-64) mod m для t < m * 2^64 */
+static inline ULL mont_redc(const PolModCtx* c, unsigned __int128 t)
+{
+    ULL q = (ULL)t * c->mont_inv;
+    ULL h = mulhi64(q, c->modulo);
+    ULL hi = (ULL)(t >> 64);
+    return (hi >= h) ? hi - h : hi - h + c->modulo;
+}
+
+/* x mod m для произвольного 64-битного x */
+static inline ULL ctx_reduce(const PolModCtx* c, ULL x)
+{
+    if (x < c->modulo)
+        return x;
+    if (c->kind == POL_RED_BARRETT)
+        return barrett_reduce(c, x);
+    return x % c->modulo;
+}
+
+/*
+ * Подготовка множителя b < m для многократного умножения через ctx_mul_prep.
+ * Для Монтгомери это b * 2^64 mod m, для остальных способов — само b.
+ */
+static inline ULL ctx_prep(const PolModCtx* c, ULL b)
+{
+    if (c->kind == POL_RED_MONTGOMERY)
+        return mont_redc(c, (unsigned __int128)b * c->mont_r2);
+    return b;
+}
+
+/* a * b mod m, где bp = ctx_prep(c, b), a < m */
+static inline ULL ctx_mul_prep(const PolModCtx* c, ULL a, ULL bp)
+{
+    switch (c->kind)
+    {
+        case POL_RED_BARRETT:
+            return barrett_reduce(c, a * bp);
+        case POL_RED_MONTGOMERY:
+            return mont_redc(c, (unsigned __int128)a * bp);
+        default:
+            return mul_mod(a, bp, c->modulo);
+    }
+}
+
+/* a * b mod m для a, b < m */
+static inline ULL ctx_mul(const PolModCtx* c, ULL a, ULL b)
+{
+    return ctx_mul_prep(c, a, ctx_prep(c, b));
+}
+
+#endif //LAB3_POL_ARITH_H
@@ -0,0 +1,105 @@
+#ifndef LAB3_POL_DIV_H
+#define LAB3_POL_DIV_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Порог перехода на деление через обращение ряда по Ньютону: если длина
+ * частного или делителя (степень + 1) не превышает порога, используется
+ * деление столбиком. Первый порог — для модулей, по которым работает
+ * прямое NTT, второй — для остальных (умножение через КТО дороже).
+ */
+#define POL_NEWTON_THRESHOLD 384
+#define POL_NEWTON_CRT_THRESHOLD 1536
+
+extern size_t g_newton_threshold;
+extern size_t g_newton_crt_threshold;
+
+/*
+ * Наибольшее число ненулевых младших членов делителя, при котором остаток
+ * считается разреженным приведением: каждый исключаемый член затрагивает
+ * только эти позиции, и деление стоит O(nq * w) вместо O(nq * nd).
+ */
+#define POL_SPARSE_MAX_WEIGHT 16
+
+/*
+ * Вес делителя: число ненулевых (после приведения) коэффициентов d[0 .. nd-2].
+ * Подсчёт прекращается, как только вес превысит limit.
+ *
+ * [IN]      d, nd    делитель (nd >= 1)
+ * [IN]      limit    верхняя граница, после которой счёт не нужен
+ * [IN]      ctx      контекст модуля кольца
+ *
+ * [RETURN]  вес, или limit + 1 если он больше limit
+ */
+size_t sparse_weight(const ULL* d, size_t nd, size_t limit, const PolModCtx* ctx);
+
+/*
+ * Обращение степенного ряда: g = f^(-1) mod x^n итерацией Ньютона
+ * g <- g - g * (f * g - 1), удваивающей точность на каждом шаге.
+ * Стоимость — O(M(n)), где M(n) — стоимость умножения (см. mul_coeffs).
+ *
+ * [IN]      f, nf    первые nf коэффициентов ряда (недостающие считаются нулями)
+ * [IN]      n        требуемая точность, n >= 1
+ * [IN]      ctx      контекст модуля кольца
+ * [OUT]     g        n коэффициентов обратного ряда
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NO_INVERSE     — f[0] необратим по модулю
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int inv_series(const ULL* f, size_t nf, size_t n, ULL* g, const PolModCtx* ctx);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для inv_series_ws(nf, n)
+ * при текущих порогах; 0 — буфер не нужен.
+ */
+size_t inv_series_scratch_size(size_t nf, size_t n, const PolModCtx* ctx);
+
+
+/*
+ * То же, что inv_series, но с рабочим буфером вызывающей стороны
+ * (не менее inv_series_scratch_size(nf, n, ctx) элементов), без выделения памяти.
+ */
+int inv_series_ws(const ULL* f, size_t nf, size_t n, ULL* g, ULL* scratch,
+                  const PolModCtx* ctx);
+
+
+/*
+ * Остаток от деления на месте: w = w mod d.
+ * Если вес d не больше POL_SPARSE_MAX_WEIGHT (трёхчлены, пятичлены, x^n +- c),
+ * старшие члены сворачиваются только на ненулевые позиции d; для x^n - 1
+ * и x^n + 1 свёртка сводится к поэлементному сложению и вычитанию блоков.
+ * Выше порога g_newton_threshold (g_newton_crt_threshold) частное находится как
+ * rev(Q) = rev(w) * rev(d)^(-1) mod x^(nw - nd + 1), а остаток — как w - Q * d,
+ * то есть за два умножения и одно обращение ряда; иначе — делением столбиком.
+ *
+ * [IN/OUT]  w, nw    делимое с приведёнными коэффициентами; на выходе первые
+ *                    nd - 1 элементов содержат остаток, остальные обнулены
+ * [IN]      d, nd    делитель, старший коэффициент d[nd - 1] обратим (nd >= 1)
+ * [IN]      ctx      контекст модуля кольца
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NO_INVERSE     — старший коэффициент делителя необратим
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int rem_coeffs(ULL* w, size_t nw, const ULL* d, size_t nd, const PolModCtx* ctx);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для rem_coeffs_ws(nw, nd)
+ * при текущих порогах; 0 — буфер не нужен. Разреженность делителя не
+ * учитывается, поэтому оценка не меньше фактической потребности.
+ */
+size_t rem_coeffs_scratch_size(size_t nw, size_t nd, const PolModCtx* ctx);
+
+
+/*
+ * То же, что rem_coeffs, но с рабочим буфером вызывающей стороны
+ * (не менее rem_coeffs_scratch_size(nw, nd, ctx) элементов), без выделения памяти.
+ */
+int rem_coeffs_ws(ULL* w, size_t nw, const ULL* d, size_t nd, ULL* scratch,
+                  const PolModCtx* ctx);
+
+#endif //LAB3_POL_DIV_H
@@ -0,0 +1,161 @@
+#ifndef LAB3_POL_GF2_H
+#define LAB3_POL_GF2_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Многочлены над GF(2) в упакованном виде: коэффициент при x^i — бит i % 64
+ * слова i / 64. Сложение и вычитание совпадают и сводятся к XOR слов,
+ * умножение — к умножению слов без переносов (PCLMULQDQ, если процессор
+ * его поддерживает, иначе переносимая табличная версия) с Карацубой поверх.
+ *
+ * pol_mul_mod_unit и его варианты с контекстом и рабочей памятью при
+ * modulo == 2 сами переходят на это представление; функции ниже нужны,
+ * когда многочлены над GF(2) удобнее держать упакованными постоянно.
+ */
+
+/*
+ * Порог перехода на Карацубу (в словах по 64 коэффициента): если меньший
+ * множитель короче порога, слова перемножаются школьным способом.
+ */
+#define POL_GF2_KARATSUBA_THRESHOLD 8
+
+/*
+ * Порог перехода на деление через обращение ряда (в коэффициентах частного):
+ * если модуль не разреженный, а частное не короче порога, остаток находится
+ * за два умножения и обращение ряда вместо сдвига модуля на каждый бит.
+ */
+#define POL_GF2_NEWTON_THRESHOLD 32
+
+extern size_t g_gf2_karatsuba_threshold;
+extern size_t g_gf2_newton_threshold;
+
+/* Число слов для коэффициентов степеней 0..degree */
+#define POL_GF2_WORDS(degree) ((degree) / 64 + 1)
+
+typedef struct PolGF2
+{
+    ULL* words;         // коэффициенты, биты выше degree равны нулю
+    size_t degree;      // степень; у нулевого многочлена 0 и words[0] == 0
+    size_t capacity;    // выделено слов
+} PolGF2;
+
+
+/*
+ * Создаёт нулевой многочлен с местом под коэффициенты до степени degree.
+ *
+ * [RETURN]  POL_SUCCESS, POL_NULL_PTR или POL_MEMORY_ERROR
+ */
+int pol_gf2_new(PolGF2* P, size_t degree);
+
+
+/* Освобождает коэффициенты; повторный вызов безопасен */
+void pol_gf2_free(PolGF2* P);
+
+
+/*
+ * Упаковывает многочлен по модулю 2 (берётся младший бит коэффициента).
+ *
+ * [IN]      A       многочлен с A->modulo == 2
+ * [OUT]     P       инициализированный (pol_gf2_new) многочлен
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — A или P == NULL
+ *           POL_INVALID_MODULO — A->modulo != 2
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int pol_gf2_from_pol(const Polynomial* A, PolGF2* P);
+
+
+/*
+ * Распаковывает многочлен в обычное представление с modulo == 2.
+ *
+ * [RETURN]  POL_SUCCESS, POL_NULL_PTR или POL_MEMORY_ERROR
+ */
+int pol_gf2_to_pol(const PolGF2* P, Polynomial* R);
+
+
+/*
+ * R = A + B (оно же A - B). R может совпадать с A или B.
+ *
+ * [RETURN]  POL_SUCCESS, POL_NULL_PTR или POL_MEMORY_ERROR
+ */
+int pol_gf2_add(const PolGF2* A, const PolGF2* B, PolGF2* R);
+
+
+/*
+ * R = A * B. R может совпадать с A или B.
+ *
+ * [RETURN]  POL_SUCCESS, POL_NULL_PTR или POL_MEMORY_ERROR
+ */
+int pol_gf2_mul(const PolGF2* A, const PolGF2* B, PolGF2* R);
+
+
+/*
+ * R = A mod M. Для разреженного M (трёхчлены, пятичлены, в общем случае —
+ * POL_SPARSE_MAX_WEIGHT ненулевых младших членов) старшие биты сворачиваются
+ * блоками до 64 бит сразу на позиции этих членов.
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — один из аргументов == NULL
+ *           POL_ZERO_DIV       — M — нулевой многочлен
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int pol_gf2_rem(const PolGF2* A, const PolGF2* M, PolGF2* R);
+
+
+/*
+ * R = (A * B) mod M. R может совпадать с любым из аргументов.
+ *
+ * [RETURN]  как pol_gf2_rem
+ */
+int pol_gf2_mul_mod(const PolGF2* A, const PolGF2* B, const PolGF2* M, PolGF2* R);
+
+
+/*
+ * Упаковка n коэффициентов в (n + 63) / 64 слов (берётся младший бит
+ * коэффициента) и обратная распаковка в n коэффициентов 0 и 1.
+ */
+void pol_gf2_pack(const ULL* c, size_t n, ULL* words);
+void pol_gf2_unpack(const ULL* words, size_t n, ULL* c);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера pol_gf2_mul_mod_coeffs.
+ */
+size_t pol_gf2_mul_mod_coeffs_scratch_size(size_t na, size_t nb, size_t nm);
+
+
+/*
+ * Ядро pol_mul_mod_unit при modulo == 2 над обычными массивами коэффициентов:
+ * множители и модуль упаковываются в scratch, перемножаются и приводятся.
+ * Остаток остаётся упакованным, чтобы вызывающая сторона могла подготовить
+ * место под результат уже после того, как множители прочитаны.
+ *
+ * [IN]      a, na    первый множитель (na >= 1)
+ * [IN]      b, nb    второй множитель (nb >= 1)
+ * [IN]      m, nm    модуль, m[nm - 1] нечётен (nm >= 1)
+ * [IN]      scratch  рабочий буфер не менее
+ *                    pol_gf2_mul_mod_coeffs_scratch_size(na, nb, nm) элементов
+ *
+ * [RETURN]  слова остатка внутри scratch: min(na + nb - 1, nm - 1) младших
+ *           бит (распаковываются pol_gf2_unpack)
+ */
+const ULL* pol_gf2_mul_mod_coeffs(const ULL* a, size_t na, const ULL* b, size_t nb,
+                                  const ULL* m, size_t nm, ULL* scratch);
+
+
+/*
+ * Включает или выключает PCLMULQDQ (например, чтобы сравнить скорость или
+ * проверить переносимую версию). По умолчанию включено, если поддерживается.
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_INVALID_ARG    — enable != 0, а процессор или сборка без PCLMULQDQ
+ */
+int pol_gf2_set_clmul(int enable);
+
+
+/* "pclmul" или "portable" — текущее умножение слов */
+const char* pol_gf2_kernel(void);
+
+#endif //LAB3_POL_GF2_H
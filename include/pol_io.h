@@ -0,0 +1,130 @@
+#ifndef LAB3_POL_IO_H
+#define LAB3_POL_IO_H
+
+#include <stdio.h>
+
+#include "../include/polynomial.h"
+
+/*
+ * Двоичный формат многочлена (все числа little-endian):
+ *
+ *     смещение  размер  поле
+ *      0        4       "POLB"
+ *      4        2       версия формата (POL_BIN_VERSION)
+ *      6        1       ширина коэффициента в байтах: 1, 2, 4 или 8
+ *      7        1       флаги, сейчас 0
+ *      8        8       modulo
+ *     16        8       degree
+ *     24        8       резерв, 0
+ *     32        ...     degree + 1 коэффициентов c0, c1, ..., cn
+ *
+ * Заголовок кратен 8 байтам, поэтому коэффициенты ширины 8 в отображённом
+ * файле выровнены и могут использоваться напрямую.
+ */
+#define POL_BIN_MAGIC       "POLB"
+#define POL_BIN_VERSION     1
+#define POL_BIN_HEADER_SIZE 32
+
+/* Отображение файла в память, созданное pol_map_bin */
+typedef struct PolMapping
+{
+    void* addr;     // начало отображения; NULL — отображения нет
+    size_t size;    // длина в байтах
+} PolMapping;
+
+/*
+ * Записывает многочлен в двоичном формате. Коэффициенты упаковываются
+ * порциями через буфер фиксированного размера, без копии всего многочлена.
+ *
+ * [IN]      f       открытый на запись поток (двоичный режим)
+ * [IN]      P       многочлен; коэффициенты должны быть меньше P->modulo
+ * [IN]      width   ширина коэффициента: 1, 2, 4, 8 или 0 — наименьшая,
+ *                   вмещающая P->modulo - 1
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — f == NULL, P == NULL или P->coeffs == NULL
+ *           POL_INVALID_MODULO — P->modulo <= 1
+ *           POL_INVALID_ARG    — недопустимая ширина, modulo - 1 в неё не помещается
+ *                                или коэффициент не меньше modulo (проверяется до
+ *                                записи, в поток ничего не попадает)
+ *           POL_IO_ERROR       — ошибка записи (в поток может попасть часть данных)
+ */
+int pol_write_bin(FILE* f, const Polynomial* P, int width);
+
+
+/*
+ * pol_write_bin в файл path (файл создаётся или перезаписывается).
+ * При любой ошибке после открытия файл удаляется, так что недописанный
+ * файл с верным заголовком не остаётся.
+ *
+ * [RETURN]  как pol_write_bin; POL_IO_ERROR — также ошибка открытия или закрытия
+ */
+int pol_save_bin(const char* path, const Polynomial* P, int width);
+
+
+/*
+ * Читает многочлен в двоичном формате из потока (годится и для каналов,
+ * перемотка не нужна). Коэффициенты копируются в собственный буфер P.
+ * Поток остаётся сразу за прочитанным многочленом, так что несколько
+ * многочленов можно записать и прочитать подряд. Если поток — файл,
+ * его длина сверяется с заголовком до выделения памяти.
+ *
+ * [IN]      f       открытый на чтение поток, стоящий на начале заголовка
+ * [OUT]     P       результат; буфер переиспользуется, если хватает ёмкости
+ *                   (P должен быть инициализирован, например new_pol)
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — f == NULL или P == NULL
+ *           POL_IO_ERROR       — ошибка чтения или данные оборвались
+ *           POL_SYNTAX_ERROR   — не тот формат, версия или ширина, либо
+ *                                коэффициент не меньше modulo
+ *           POL_INVALID_MODULO — modulo в заголовке <= 1
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ *
+ * [NOTE]    При ошибке P остаётся корректным многочленом и освобождается free_pol.
+ */
+int pol_read_bin(FILE* f, Polynomial* P);
+
+
+/*
+ * pol_read_bin из файла path.
+ */
+int pol_load_bin(const char* path, Polynomial* P);
+
+
+/*
+ * Отображает файл в память и настраивает P на его коэффициенты без
+ * копирования: P->coeffs указывает внутрь отображения, P->capacity = 0
+ * (чужой массив: free_pol его не освобождает). Любая операция, которая
+ * пишет результат в P, сначала выделяет P собственный буфер по размеру
+ * результата, а отображение не трогает. Отображение частное: запись
+ * в P->coeffs не меняет файл.
+ *
+ * Без копирования отображаются только коэффициенты ширины 8 на
+ * little-endian машине; иначе, как и на системах без mmap, коэффициенты
+ * распаковываются в собственный буфер P (P->capacity > 0), а map остаётся
+ * пустым. Проверяются заголовок, длина файла (меньше, чем задаёт заголовок, —
+ * POL_IO_ERROR, длиннее — POL_SYNTAX_ERROR) и то, что все коэффициенты
+ * меньше modulo.
+ *
+ * [IN]      path    путь к файлу
+ * [OUT]     map     отображение; освобождается pol_unmap_bin после того,
+ *                   как P больше не используется
+ * [IN/OUT]  P       инициализированный многочлен; при отображении без
+ *                   копирования его прежний буфер освобождается
+ *
+ * [RETURN]  как pol_read_bin; при ошибке map пуст, а P прежний или
+ *           (если ошибка найдена при распаковке) нулевой
+ *
+ * [WARNING] Отображённая память не учитывается счётчиками mem_tracker.
+ */
+int pol_map_bin(const char* path, PolMapping* map, Polynomial* P);
+
+
+/*
+ * Снимает отображение, созданное pol_map_bin (пустое — ничего не делает).
+ * Многочлены, указывающие на него, после этого использовать нельзя.
+ */
+void pol_unmap_bin(PolMapping* map);
+
+#endif //LAB3_POL_IO_H
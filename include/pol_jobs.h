@@ -0,0 +1,60 @@
+#ifndef LAB3_POL_JOBS_H
+#define LAB3_POL_JOBS_H
+
+#include <stdio.h>
+
+#include "../include/polynomial.h"
+
+/* Заданий в обработке на одного вычисляющего потока, если глубина не задана */
+#define POL_JOBS_QUEUE_PER_WORKER 4
+
+/* Параметры pol_jobs_run */
+typedef struct PolJobsConfig
+{
+    ULL modulo;         // модуль кольца для всех заданий (> 1)
+    int workers;        // вычисляющих потоков; <= 0 — по числу процессоров
+    size_t queue;       // заданий в обработке одновременно; 0 — POL_JOBS_QUEUE_PER_WORKER * workers
+} PolJobsConfig;
+
+/* Итоги pol_jobs_run */
+typedef struct PolJobsStats
+{
+    size_t jobs;        // записано строк результата
+    size_t failed;      // из них с ошибкой
+    double seconds;     // время работы
+    int workers;        // фактическое число вычисляющих потоков
+} PolJobsStats;
+
+/*
+ * Пакетная обработка файла заданий. Каждая строка входа — одно задание
+ * из трёх многочленов "(a0,...) (b0,...) (m0,...,1)"; для него вычисляется
+ * R = (A * B) mod M (pol_mul_mod_unit) и в выход пишется строка "(r0,...)",
+ * а для ошибочного задания — "error <код POL_Error>". Строки выхода идут
+ * в порядке строк входа; пустые строки входа пропускаются.
+ *
+ * Работа идёт конвейером: один поток разбирает вход, workers потоков
+ * вычисляют, вызывающий поток пишет результаты. Между стадиями — кольцо из
+ * queue ячеек: разбор ждёт, пока запись не освободит ячейку, поэтому
+ * в памяти одновременно не больше queue заданий при любой длине файла.
+ * Буферы многочленов в ячейках переиспользуются от задания к заданию.
+ *
+ * [IN]      in      вход (читается порциями, годится и канал)
+ * [IN]      out     выход
+ * [IN]      cfg     параметры
+ * [OUT]     stats   итоги (NULL — не нужны)
+ *
+ * [RETURN]  POL_SUCCESS        — весь вход обработан (ошибки отдельных
+ *                                заданий отражены в выходе и stats->failed)
+ *           POL_NULL_PTR       — in, out или cfg == NULL
+ *           POL_INVALID_MODULO — cfg->modulo <= 1
+ *           POL_MEMORY_ERROR   — не удалось выделить кольцо или буферы
+ *           POL_IO_ERROR       — ошибка чтения входа, записи выхода или
+ *                                запуска потоков; обработка прекращена
+ *
+ * [NOTE]    При нескольких вычисляющих потоках каждый из них считает свои
+ *           задания без внутреннего распараллеливания OpenMP; при одном
+ *           большие задания распараллеливаются как обычно.
+ */
+int pol_jobs_run(FILE* in, FILE* out, const PolJobsConfig* cfg, PolJobsStats* stats);
+
+#endif //LAB3_POL_JOBS_H
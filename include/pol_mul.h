@@ -0,0 +1,101 @@
+#ifndef LAB3_POL_MUL_H
+#define LAB3_POL_MUL_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Порог перехода на алгоритм Карацубы: если длина меньшего множителя
+ * (степень + 1) не превышает порога, используется школьное умножение.
+ */
+#define POL_KARATSUBA_THRESHOLD 32
+
+extern size_t g_karatsuba_threshold;
+
+/*
+ * Школьное умножение массивов коэффициентов: r = a * b.
+ * Произведения для каждого коэффициента r копятся в 64- или 128-битном
+ * накопителе без промежуточных приведений (ширина выбирается по максимумам
+ * a и b), и делится на модуль только итоговая сумма.
+ *
+ * [IN]      a, na   первый множитель и число его коэффициентов (na >= 1)
+ * [IN]      b, nb   второй множитель и число его коэффициентов (nb >= 1)
+ * [IN]      ctx     контекст модуля кольца
+ * [OUT]     r       na + nb - 1 коэффициентов произведения (перезаписываются)
+ *
+ * [WARNING] r не должен пересекаться с a и b.
+ */
+void schoolbook_mul(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                    const PolModCtx* ctx);
+
+
+/*
+ * Скалярное произведение массивов: (a[0] * b[0] + ... + a[n-1] * b[n-1]) mod m.
+ * Как и schoolbook_mul, приводит по модулю только итоговую сумму.
+ *
+ * [IN]      a, b    массивы коэффициентов (приведённость не требуется)
+ * [IN]      n       число слагаемых
+ * [IN]      ctx     контекст модуля кольца
+ *
+ * [RETURN]  сумма по модулю ctx->modulo
+ */
+ULL dot_coeffs(const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для karatsuba_mul(na, nb).
+ * Буфер выделяется один раз и переиспользуется на всех уровнях рекурсии.
+ */
+size_t karatsuba_scratch_size(size_t na, size_t nb);
+
+
+/*
+ * Умножение массивов коэффициентов алгоритмом Карацубы: r = a * b.
+ * Несбалансированные множители делятся на куски длины меньшего из них.
+ * Ниже порога g_karatsuba_threshold используется schoolbook_mul,
+ * поэтому результат совпадает со школьным умножением поразрядно.
+ *
+ * [IN]      a, na    первый множитель (na >= 1)
+ * [IN]      b, nb    второй множитель (nb >= 1)
+ * [IN]      ctx      контекст модуля кольца
+ * [IN]      scratch  рабочий буфер не менее karatsuba_scratch_size(na, nb) элементов
+ * [OUT]     r        na + nb - 1 коэффициентов произведения (перезаписываются)
+ *
+ * [WARNING] r и scratch не должны пересекаться с a, b и друг с другом.
+ */
+void karatsuba_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+                   ULL* r, ULL* scratch, const PolModCtx* ctx);
+
+
+/*
+ * Выбирает алгоритм умножения по степеням множителей и модулю и вычисляет r = a * b:
+ * NTT для подходящих простых модулей выше g_ntt_threshold, многомодульное
+ * NTT с КТО для остальных модулей выше g_ntt_crt_threshold, Карацуба выше
+ * g_karatsuba_threshold, иначе школьное умножение.
+ * Если меньший множитель длиннее g_par_threshold (pol_par.h), произведение
+ * считается несколькими потоками: параллельно выполняются подзадачи верхних
+ * уровней Карацубы, половины преобразований NTT и умножения по разным простым
+ * КТО. Результат не зависит от числа потоков.
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_MEMORY_ERROR   — не удалось выделить рабочий буфер
+ */
+int mul_coeffs(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+               const PolModCtx* ctx);
+
+
+/*
+ * Размер (в элементах ULL) рабочего буфера для mul_coeffs_ws(na, nb)
+ * при текущих порогах; 0 — буфер не нужен.
+ */
+size_t mul_coeffs_scratch_size(size_t na, size_t nb, const PolModCtx* ctx);
+
+
+/*
+ * То же, что mul_coeffs, но с рабочим буфером вызывающей стороны
+ * (не менее mul_coeffs_scratch_size(na, nb, ctx) элементов), без выделения памяти
+ * (кроме первого построения таблиц корней NTT).
+ */
+int mul_coeffs_ws(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                  ULL* scratch, const PolModCtx* ctx);
+
+#endif //LAB3_POL_MUL_H
@@ -0,0 +1,65 @@
+#ifndef LAB3_POL_PAR_H
+#define LAB3_POL_PAR_H
+
+#include <stddef.h>
+
+/*
+ * Порог параллельного умножения: если длина меньшего множителя (степень + 1)
+ * не превышает порога, одно произведение считается в одном потоке.
+ */
+#define POL_PAR_THRESHOLD 32768
+
+/*
+ * Наименьшая длина части работы, выделяемой в отдельную задачу: подпреобразования
+ * NTT, куски поэлементных циклов, подзадачи Карацубы короче неё не делятся.
+ */
+#define POL_PAR_GRAIN 8192
+
+/*
+ * Число верхних уровней рекурсии Карацубы, подзадачи которых выполняются
+ * параллельно (3^depth задач); каждому такому уровню нужна своя рабочая память.
+ */
+#define POL_PAR_KARATSUBA_DEPTH 2
+
+extern size_t g_par_threshold;
+
+/*
+ * Задаёт число потоков для параллельных операций (пакетных и отдельных
+ * больших умножений).
+ *
+ * [IN]      n       число потоков; n <= 0 — значение OpenMP по умолчанию
+ *                   (OMP_NUM_THREADS или число ядер)
+ *
+ * [NOTE]    Без OpenMP настройка ни на что не влияет.
+ */
+void pol_set_num_threads(int n);
+
+
+/*
+ * Число потоков, которое будет использовано параллельными операциями.
+ *
+ * [RETURN]  число потоков, 1 — сборка без OpenMP
+ */
+int pol_get_num_threads(void);
+
+
+/*
+ * Можно ли раздавать подзадачи другим потокам: вызов выполняется в команде
+ * OpenMP из нескольких потоков (своей или пакетной). Задачи планируются
+ * средой OpenMP: свободные потоки команды забирают их из общей очереди,
+ * поэтому вложенный вызов не создаёт новых потоков.
+ *
+ * [RETURN]  1 — да, 0 — подзадачи выполняются сразу в текущем потоке
+ */
+int par_in_team(void);
+
+
+/*
+ * Нужно ли открывать собственную команду потоков: вызов идёт вне параллельной
+ * области и разрешено больше одного потока.
+ *
+ * [RETURN]  1 — да, 0 — нет
+ */
+int par_can_fork(void);
+
+#endif //LAB3_POL_PAR_H
@@ -0,0 +1,101 @@
+#ifndef LAB3_POL_RNG_H
+#define LAB3_POL_RNG_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Генератор xoshiro256** (Blackman, Vigna): период 2^256 - 1, четыре
+ * 64-битных слова состояния, на выходное число — сдвиги и два умножения.
+ * Не криптографический; предназначен для тестовых и замерных данных.
+ */
+typedef struct PolRng
+{
+    ULL s[4];
+} PolRng;
+
+/*
+ * Задаёт состояние по 64-битному seed (расширение через splitmix64, так что
+ * близкие seed дают несвязанные последовательности).
+ */
+void pol_rng_seed(PolRng* rng, ULL seed);
+
+
+/*
+ * Сдвигает последовательность на 2^128 чисел вперёд. Последовательности
+ * после 0, 1, 2, ... сдвигов не пересекаются и годятся как независимые потоки.
+ */
+void pol_rng_jump(PolRng* rng);
+
+
+/*
+ * Поток номер stream для seed: pol_rng_seed и stream сдвигов pol_rng_jump.
+ */
+void pol_rng_stream(PolRng* rng, ULL seed, size_t stream);
+
+
+/* Следующее 64-битное число */
+ULL pol_rng_next(PolRng* rng);
+
+
+/*
+ * Равномерное число из [0, m) без смещения и без деления в общем случае
+ * (метод Лемира: старшие 64 бита произведения x * m, редкий отказ по
+ * младшим битам; деление — только когда младшие биты попали в зону отказа).
+ *
+ * [IN]      m       граница, m >= 1
+ */
+ULL pol_rng_below(PolRng* rng, ULL m);
+
+
+/*
+ * Заполняет массив равномерными числами из [0, m). Порог отказа считается
+ * один раз на массив, сам цикл деления не содержит; при m = 2^k — маска.
+ *
+ * [IN]      m       граница, m >= 1
+ * [OUT]     dst     n чисел
+ */
+void pol_rng_fill(PolRng* rng, ULL* dst, size_t n, ULL m);
+
+
+/*
+ * Случайный многочлен степени ровно degree: коэффициенты равномерны в
+ * [0, modulo), старший — в [1, modulo). Буфер P переиспользуется, если
+ * хватает ёмкости.
+ *
+ * [IN/OUT]  P       инициализированный многочлен (например, new_pol)
+ * [IN]      degree  степень
+ * [IN]      modulo  модуль (> 1)
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — rng == NULL или P == NULL
+ *           POL_INVALID_MODULO — modulo <= 1
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int pol_rng_pol(PolRng* rng, Polynomial* P, size_t degree, ULL modulo);
+
+
+/*
+ * Пакет из count случайных многочленов степени degree, как pol_rng_pol.
+ * Из rng берётся одно число, а каждый P[i] заполняется своим генератором,
+ * полученным из этого числа и i, поэтому результат не зависит от числа
+ * потоков; при сборке с OpenMP большие пакеты заполняются параллельно.
+ *
+ * [RETURN]  как pol_rng_pol; при ошибке часть P может быть уже заполнена
+ */
+int pol_rng_pols(PolRng* rng, Polynomial* P, size_t count, size_t degree, ULL modulo);
+
+
+/*
+ * Генератор текущего потока. Каждый поток получает свой поток pol_rng_stream
+ * от общего seed (по умолчанию 1) с номером в порядке первого обращения.
+ */
+PolRng* pol_rng_local(void);
+
+
+/*
+ * Меняет общий seed. Генераторы потоков пересоздаются при следующем
+ * обращении к pol_rng_local, вызывающий поток получает поток номер 0.
+ */
+void pol_rng_global_seed(ULL seed);
+
+#endif //LAB3_POL_RNG_H
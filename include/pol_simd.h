@@ -0,0 +1,76 @@
+#ifndef LAB3_POL_SIMD_H
+#define LAB3_POL_SIMD_H
+
+#include "../include/polynomial.h"
+
+/*
+ * Векторные ядра поэлементных операций над массивами коэффициентов.
+ * Набор инструкций выбирается при первом обращении по CPUID, поэтому
+ * один и тот же исполняемый файл работает на любом x86-64 процессоре;
+ * на других архитектурах доступна только скалярная реализация.
+ *
+ * Все ядра принимают неприведённые коэффициенты и дают тот же результат,
+ * что и скалярная версия: блоки с элементами >= m обрабатываются поэлементно.
+ */
+
+enum POL_Isa
+{
+    POL_ISA_SCALAR = 0,
+    POL_ISA_AVX2,
+    POL_ISA_AVX512,
+    POL_ISA_COUNT
+};
+
+typedef struct PolVecOps
+{
+    const char* name;
+
+    /* r[i] = (a[i] + b[i]) mod m */
+    void (*add)(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx);
+
+    /* r[i] = (a[i] - b[i]) mod m */
+    void (*sub)(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx);
+
+    /* r[i] = a[i] mod m */
+    void (*reduce)(ULL* r, const ULL* a, size_t n, const PolModCtx* ctx);
+
+    /* r[i] = (a[i] * k) mod m */
+    void (*scale)(ULL* r, const ULL* a, ULL k, size_t n, const PolModCtx* ctx);
+
+    /* (a[0] * b[0] + ... + a[n-1] * b[n-1]) mod m */
+    ULL (*dot)(const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx);
+} PolVecOps;
+
+
+/*
+ * Таблица ядер для текущего процессора (самый широкий поддерживаемый набор
+ * инструкций или заданный через pol_vec_set_isa).
+ *
+ * [RETURN]  указатель на таблицу, не NULL
+ */
+const PolVecOps* pol_vec_ops(void);
+
+
+/*
+ * Таблица ядер для конкретного набора инструкций.
+ *
+ * [IN]      isa      значение из POL_Isa
+ *
+ * [RETURN]  указатель на таблицу, или NULL если набор не поддерживается
+ *           процессором или сборкой
+ */
+const PolVecOps* pol_vec_ops_for(int isa);
+
+
+/*
+ * Принудительно выбирает набор инструкций для pol_vec_ops
+ * (например, для сравнения скорости).
+ *
+ * [IN]      isa      значение из POL_Isa
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_INVALID_ARG    — набор не поддерживается
+ */
+int pol_vec_set_isa(int isa);
+
+#endif //LAB3_POL_SIMD_H
@@ -0,0 +1,81 @@
+#ifndef LAB3_POL_TUNE_H
+#define LAB3_POL_TUNE_H
+
+#include <stdio.h>
+
+#include "../include/polynomial.h"
+
+/*
+ * Файл порогов, который читает pol_tune_load(NULL), если не задана
+ * переменная окружения POL_TUNE_FILE.
+ */
+#define POL_TUNE_DEFAULT_FILE "pol_tune.cfg"
+
+/*
+ * Загружает пороги переключения алгоритмов из файла вида
+ *
+ *     # комментарий
+ *     karatsuba     = 32
+ *     ntt           = 32
+ *     ntt_crt       = 128
+ *     newton        = 384
+ *     newton_crt    = 1536
+ *     parallel      = 32768
+ *     gf2_karatsuba = 8
+ *     gf2_newton    = 32
+ *
+ * Ключи соответствуют g_karatsuba_threshold, g_ntt_threshold,
+ * g_ntt_crt_threshold, g_newton_threshold, g_newton_crt_threshold,
+ * g_par_threshold, g_gf2_karatsuba_threshold и g_gf2_newton_threshold
+ * (pol_gf2.h); отсутствующие ключи сохраняют текущие значения
+ * (по умолчанию — вкомпилированные POL_*_THRESHOLD). Вызывается один раз при
+ * запуске программы, до первых операций; по этим порогам выбирают алгоритм
+ * pol_mul_pol, modulo_unit_pol и остальные операции.
+ *
+ * [IN]      path    путь к файлу; NULL — $POL_TUNE_FILE или POL_TUNE_DEFAULT_FILE
+ *
+ * [RETURN]  POL_SUCCESS        — пороги загружены
+ *           POL_IO_ERROR       — файла нет или его не удалось прочитать
+ *                                (пороги не меняются)
+ *           POL_SYNTAX_ERROR   — строка не вида "ключ = число" или неизвестный
+ *                                ключ (пороги не меняются)
+ *
+ * [WARNING] Функция меняет глобальные пороги и не должна выполняться
+ *           одновременно с операциями в других потоках.
+ */
+int pol_tune_load(const char* path);
+
+
+/*
+ * Записывает текущие пороги в файл в формате pol_tune_load.
+ *
+ * [IN]      path    путь к файлу; NULL — $POL_TUNE_FILE или POL_TUNE_DEFAULT_FILE
+ *
+ * [RETURN]  POL_SUCCESS        — файл записан
+ *           POL_IO_ERROR       — ошибка открытия или записи
+ */
+int pol_tune_save(const char* path);
+
+
+/*
+ * Подбирает пороги на текущей машине: для каждой пары соседних алгоритмов
+ * замеряет оба на сетке длин и берёт наибольшую длину, до которой более
+ * простой алгоритм ещё не проигрывает:
+ *   школьное умножение -> Карацуба (NTT отключено);
+ *   Карацуба -> NTT по простому 998244353;
+ *   Карацуба -> NTT с КТО по модулю 10^9 + 7;
+ *   деление столбиком -> деление Ньютоном для тех же двух модулей;
+ *   над GF(2): школьное умножение слов -> Карацуба, деление сдвигами ->
+ *   деление Ньютоном (модуль — многочлен из одних единиц);
+ *   один поток -> несколько (только если pol_get_num_threads() > 1).
+ * Найденные значения сразу устанавливаются; сохранить их — pol_tune_save.
+ * Занимает несколько секунд.
+ *
+ * [IN]      log     куда печатать замеры (NULL — не печатать)
+ *
+ * [RETURN]  POL_SUCCESS        — пороги подобраны
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти (пороги не меняются)
+ */
+int pol_tune_run(FILE* log);
+
+#endif //LAB3_POL_TUNE_H
@@ -13,9 +13,10 @@ typedef unsigned long long ULL;
 
 typedef struct Polynomial
 {
-    ULL *coeffs;    // массив коэффициентов: coeffs[i] соответствует x^i
-    size_t degree;  // степень многочлена
-    ULL modulo;     // характеристика кольца Z_modulo, modulo > 1
+    ULL *coeffs;      // массив коэффициентов: coeffs[i] соответствует x^i
+    size_t degree;    // степень многочлена
+    ULL modulo;       // характеристика кольца Z_modulo, modulo > 1
+    size_t capacity;  // число выделенных элементов coeffs; 0 — массив чужой и не освобождается
 } Polynomial;
 
 enum POL_Error
@@ -29,20 +30,78 @@ enum POL_Error
     POL_NO_INVERSE,       /* нет мультипликативного обратного для старшего коэффициента */
     POL_BUFFER_SMALL,     /* буфер для строкового представления слишком мал */
     POL_SYNTAX_ERROR,     /* синтаксическая ошибка при парсинг строки */
-    POL_INVALID_ARG       /* Некорректный аргумент */
+    POL_INVALID_ARG,      /* Некорректный аргумент */
+    POL_IO_ERROR          /* ошибка открытия, чтения или записи файла */
+};
+
+/* Способ приведения произведений в контексте модуля */
+enum POL_Reduction
+{
+    POL_RED_BARRETT = 0,  /* modulo < 2^32: умножение и сдвиг по Барретту */
+    POL_RED_MONTGOMERY,   /* нечётный modulo >= 2^32: редукция Монтгомери, R = 2^64 */
+    POL_RED_GENERIC       /* чётный modulo >= 2^32: 128-битное деление */
 };
 
+/*
+ * Контекст модуля: константы, вычисляемые один раз для modulo и позволяющие
+ * заменить деление в горячих циклах умножениями и сдвигами.
+ */
+typedef struct PolModCtx
+{
+    ULL modulo;     // характеристика кольца Z_modulo, modulo > 1
+    int kind;       // значение из POL_Reduction
+    ULL barrett;    // floor((2^64 - 1) / modulo) для POL_RED_BARRETT
+    ULL mont_inv;   // modulo^(-1) mod 2^64 для POL_RED_MONTGOMERY
+    ULL mont_r2;    // 2^128 mod modulo для POL_RED_MONTGOMERY
+} PolModCtx;
+
+/*
+ * Контекст приведения по фиксированному унитарному многочлену M степени n:
+ * приведённые коэффициенты M, обратный ряд rev(M)^(-1) и, если модуль
+ * допускает прямое NTT, их готовые образы. Строится pol_modulus_init.
+ */
+typedef struct PolModulusCtx
+{
+    PolModCtx mod;        // контекст модуля кольца коэффициентов
+    size_t degree;        // n = deg M
+    ULL* m;               // n + 1 приведённых коэффициентов M
+    ULL* inv;             // rev(M)^(-1) mod x^(n-1); NULL — деление столбиком
+    size_t ntt_len;       // длина NTT для A * B; 0 — NTT не применяется
+    size_t ntt_len_low;   // длина циклической свёртки Q * M, не меньше n
+    ULL* inv_hat;         // образ inv длины ntt_len (ctx_prep)
+    ULL* m_hat;           // образ M mod (x^ntt_len_low - 1) (ctx_prep)
+    ULL* work;            // рабочий буфер, растёт при необходимости
+    size_t work_len;
+} PolModulusCtx;
+
+/*
+ * Рабочая память (арена) для временных массивов операций: буфер вызывающей
+ * стороны, из которого промежуточные массивы выделяются сдвигом указателя
+ * и целиком возвращаются по окончании операции.
+ */
+typedef struct PolWorkspace
+{
+    ULL* base;            // буфер арены
+    size_t capacity;      // размер буфера в элементах ULL
+    size_t used;          // занято элементов с начала буфера
+} PolWorkspace;
+
 /*----------------- ВСПОМОГАТЕЛЬНЫЕ ОПЕРАЦИИ -----------------*/
 
 /*
  * Перевыделяет память под коэффициенты многочлена, если текущей ёмкости недостаточно.
  * Гарантирует, что в R->coeffs будет как минимум (required_degree + 1) элементов.
- * Если память уже выделена и достаточна, ничего не делает.
+ * Если R->capacity уже достаточна, ничего не делает, поэтому многочлен-результат,
+ * переиспользуемый в цикле, перестаёт выделять память после первых итераций.
+ *
+ * Ёмкость растёт геометрически (не меньше чем в 1.5 раза), коэффициенты
+ * 0 .. R->degree переносятся в новый массив, остальные элементы обнуляются.
+ * Чужой массив (capacity == 0) не освобождается.
  *
  * [IN/OUT]  R               указатель на структуру Polynomial
  * [IN]      required_degree требуемая степень (массив размера required_degree + 1)
  *
- * [OUT]     R               R->coeffs имеет ёмкость не менее required_degree + 1
+ * [OUT]     R               R->capacity >= required_degree + 1
  *
  * [RETURN]  POL_SUCCESS        — успех или память уже достаточна
  *           POL_MEMORY_ERROR   — ошибка выделения памяти
@@ -101,12 +160,10 @@ ULL egcd(ULL a, ULL b, long long *x, long long *y);
  *
  * [RETURN]  POL_SUCCESS        — обратный элемент существует и вычислен
  *           POL_NO_INVERSE     — обратного элемента не существует (НОД(a, m) ≠ 1)
- *                                или модуль слишком велик для преобразования в long long
  *
  * [NOTE]    Обратный элемент существует только если НОД(a, m) = 1.
- * [NOTE]    Если m > LLONG_MAX, функция возвращает POL_NO_INVERSE, поскольку
- *           использует знаковую арифметику для приведения результата в диапазон [0, m-1].
- * [NOTE]    Реализация использует расширенный алгоритм Евклида (egcd).
+ * [NOTE]    Реализация использует расширенный алгоритм Евклида, коэффициенты Безу
+ *           хранятся по модулю m, поэтому допустим любой 64-битный модуль.
  */
 int modulo_inverse(ULL a, ULL m, ULL *inv);
 
@@ -125,6 +182,22 @@ int modulo_inverse(ULL a, ULL m, ULL *inv);
  */
 void print_polynomial(const Polynomial* p, const char* name);
 
+/*
+ * Инициализирует контекст модуля: выбирает способ приведения и вычисляет
+ * константы Барретта или Монтгомери. Контекст не владеет памятью и может
+ * переиспользоваться для любого числа операций с тем же модулем.
+ *
+ * [IN]      ctx     указатель на контекст
+ * [IN]      modulo  характеристика кольца; должно быть > 1
+ *
+ * [OUT]     ctx     заполненный контекст
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — ctx == NULL
+ *           POL_INVALID_MODULO — modulo <= 1
+ */
+int pol_modctx_init(PolModCtx* ctx, ULL modulo);
+
 /*--------------------- БАЗОВЫЕ ОПЕРАЦИИ ---------------------*/
 
 /*
@@ -136,7 +209,8 @@ void print_polynomial(const Polynomial* p, const char* name);
  * [IN]      degree  требуемая степень (массив размера degree + 1)
  * [IN]      modulo     характеристика кольца; должно быть > 1
  *
- * [OUT]     p       p->coeffs выделены и заполнены нулями; p->degree и p->modulo установлены
+ * [OUT]     p       p->coeffs выделены и заполнены нулями; p->degree и p->modulo установлены;
+ *                   p->capacity = degree + 1
  *
  * [RETURN]  POL_SUCCESS        — успех
  *           POL_NULL_PTR       — p == NULL
@@ -151,7 +225,8 @@ int new_pol(Polynomial *p, size_t degree, ULL modulo);
  *
  * [IN]      p       указатель на структуру Polynomial
  *
- * [OUT]     p       coeffs освобождены и сброшены в NULL; degree = 0; modulo = 0
+ * [OUT]     p       coeffs освобождены (по capacity) и сброшены в NULL;
+ *                   degree = 0; modulo = 0; capacity = 0
  *
  * [RETURN]  POL_SUCCESS           — успех
  *           POL_NULL_PTR          — p == NULL
@@ -165,7 +240,7 @@ void free_pol(Polynomial *p);
  * [IN]      src     исходный многочлен
  * [IN]      dst     указатель на принимающий многочлен
  *
- * [OUT]     dst     создаётся копия src
+ * [OUT]     dst     создаётся копия src (буфер dst переиспользуется, если хватает ёмкости)
  *
  * [RETURN]  POL_SUCCESS           — успех
  *           POL_NULL_PTR          — src == NULL или dst == NULL
@@ -275,6 +350,11 @@ int dot_pol(const Polynomial* A, const Polynomial* B, ULL* Result);
  *           POL_MODULO_MISMATCH      — несовместимые модули
  *           POL_MEMORY_ERROR      — ошибка выделения памяти
  *           POL_NO_INVERSE        — нет мультипликативного обратного для старшего коэффициента M
+ *
+ * [NOTE]    Для больших степеней остаток находится через обращение ряда по Ньютону
+ *           (см. rem_coeffs), иначе — делением столбиком. Разреженный M
+ *           (x^n +- c, трёхчлены, пятичлены) распознаётся автоматически,
+ *           и деление затрагивает только его ненулевые члены.
  */
 int modulo_unit_pol(const Polynomial* A, const Polynomial* M, Polynomial* R);
 
@@ -311,4 +391,223 @@ int modulo_unit_pol(const Polynomial* A, const Polynomial* M, Polynomial* R);
 int pol_mul_mod_unit(const Polynomial* A, const Polynomial* B,
                      const Polynomial* M, Polynomial* R);
 
+/*------------------ ОПЕРАЦИИ С КОНТЕКСТОМ МОДУЛЯ ------------------*/
+
+/*
+ * Варианты базовых операций, использующие заранее подготовленный контекст
+ * модуля ctx (см. pol_modctx_init). Семантика и коды возврата совпадают
+ * с одноимёнными функциями без суффикса _ctx; дополнительно:
+ *
+ * [RETURN]  POL_NULL_PTR          — ctx == NULL
+ *           POL_MODULO_MISMATCH   — ctx->modulo не совпадает с модулем многочленов
+ *
+ * [NOTE]    Функции без суффикса _ctx строят контекст на каждый вызов; при
+ *           многократной работе с одним модулем выгоднее создать его один раз.
+ */
+int normalize_pol_ctx(Polynomial *p, const PolModCtx* ctx);
+
+int sum_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                const PolModCtx* ctx);
+
+int sub_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                const PolModCtx* ctx);
+
+int scalar_mul_pol_ctx(const Polynomial* A, ULL k, Polynomial* R,
+                       const PolModCtx* ctx);
+
+int pol_mul_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                    const PolModCtx* ctx);
+
+int dot_pol_ctx(const Polynomial* A, const Polynomial* B, ULL* result,
+                const PolModCtx* ctx);
+
+int modulo_unit_pol_ctx(const Polynomial* A, const Polynomial* M, Polynomial* R,
+                        const PolModCtx* ctx);
+
+int pol_mul_mod_unit_ctx(const Polynomial* A, const Polynomial* B,
+                         const Polynomial* M, Polynomial* R, const PolModCtx* ctx);
+
+/*------------------ РАБОЧАЯ ПАМЯТЬ ------------------*/
+
+/*
+ * Инициализирует арену и выделяет capacity элементов (0 — без выделения;
+ * буфер появится при первом использовании).
+ *
+ * [OUT]     ws        арена; освобождается pol_ws_free
+ * [IN]      capacity  начальный размер в элементах ULL
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — ws == NULL
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int pol_ws_init(PolWorkspace* ws, size_t capacity);
+
+
+/*
+ * Освобождает буфер арены. Повторный вызов безопасен.
+ */
+void pol_ws_free(PolWorkspace* ws);
+
+
+/*
+ * Возвращает в арену всю выделенную из неё память (буфер сохраняется).
+ */
+void pol_ws_reset(PolWorkspace* ws);
+
+
+/*
+ * Гарантирует размер буфера не меньше capacity элементов.
+ * Расширять можно только пустую арену (ws->used == 0).
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — ws == NULL
+ *           POL_INVALID_ARG    — арена не пуста, а места не хватает
+ *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int pol_ws_reserve(PolWorkspace* ws, size_t capacity);
+
+
+/*
+ * Выделяет n элементов из арены.
+ *
+ * [RETURN]  указатель на n элементов, или NULL если места не хватает или n == 0
+ *
+ * [NOTE]    Память возвращается pol_ws_reset или откатом ws->used
+ *           к ранее сохранённому значению.
+ */
+ULL* pol_ws_alloc(PolWorkspace* ws, size_t n);
+
+
+/*
+ * Размер арены (в элементах ULL), достаточный для pol_mul_pol_ws
+ * с множителями степеней deg_a и deg_b, в том числе когда R совпадает с A или B.
+ */
+size_t pol_mul_pol_ws_size(size_t deg_a, size_t deg_b, const PolModCtx* ctx);
+
+
+/*
+ * Размер арены (в элементах ULL), достаточный для pol_mul_mod_unit_ws
+ * с множителями степеней deg_a, deg_b и модулем степени deg_m.
+ */
+size_t pol_mul_mod_unit_ws_size(size_t deg_a, size_t deg_b, size_t deg_m,
+                                const PolModCtx* ctx);
+
+
+/*
+ * Варианты pol_mul_pol_ctx и pol_mul_mod_unit_ctx, берущие все временные
+ * массивы из арены ws. Семантика и коды возврата совпадают; занятая часть
+ * арены по окончании вызова возвращается в прежнее состояние.
+ *
+ * Пустая арена при нехватке места расширяется до нужного размера, так что
+ * в цикле с одной ареной и переиспользуемым R память выделяется только
+ * на первых итерациях. Размер можно задать заранее через *_ws_size.
+ *
+ * [RETURN]  POL_NULL_PTR        — ws == NULL
+ *           POL_MEMORY_ERROR    — места в непустой арене не хватает
+ *                                 или не удалось её расширить
+ */
+int pol_mul_pol_ws(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                   PolWorkspace* ws, const PolModCtx* ctx);
+
+int pol_mul_mod_unit_ws(const Polynomial* A, const Polynomial* B,
+                        const Polynomial* M, Polynomial* R,
+                        PolWorkspace* ws, const PolModCtx* ctx);
+
+/*------------------ ПРИВЕДЕНИЕ ПО ФИКСИРОВАННОМУ МОДУЛЮ ------------------*/
+
+/*
+ * Строит контекст для многократного умножения по модулю унитарного M.
+ * Проверка M, приведение его коэффициентов, обращение rev(M) и прямые
+ * преобразования выполняются здесь один раз.
+ *
+ * [IN]      M       унитарный модуль (старший коэффициент == 1)
+ * [OUT]     ctx     контекст; освобождается pol_modulus_free
+ *
+ * [RETURN]  POL_SUCCESS         — успех
+ *           POL_NULL_PTR        — ctx == NULL или M == NULL
+ *           POL_INVALID_MODULO  — неверный M->modulo
+ *           POL_ZERO_DIV        — M — нулевой многочлен
+ *           POL_INVALID_ARG     — M не является унитарным
+ *           POL_MEMORY_ERROR    — ошибка выделения памяти
+ */
+int pol_modulus_init(PolModulusCtx* ctx, const Polynomial* M);
+
+
+/*
+ * Освобождает память контекста. Повторный вызов безопасен.
+ */
+void pol_modulus_free(PolModulusCtx* ctx);
+
+
+/*
+ * R = (A * B) mod M для M, заданного контекстом ctx.
+ * Для deg A, deg B < deg M это одно произведение и два умножения на готовые
+ * образы (или деление столбиком для малых и разреженных M); рабочая память
+ * берётся из ctx.
+ * Операнды большей степени сначала обрабатываются общим путём pol_mul_mod_unit.
+ *
+ * [IN]      A, B    множители (модуль совпадает с модулем M)
+ * [IN/OUT]  ctx     контекст модуля (рабочий буфер меняется при вызове)
+ * [OUT]     R       остаток, степень < deg M; может совпадать с A или B
+ *
+ * [RETURN]  POL_SUCCESS         — успех
+ *           POL_NULL_PTR        — один из аргументов == NULL
+ *           POL_MODULO_MISMATCH — модуль A или B отличается от модуля M
+ *           POL_MEMORY_ERROR    — ошибка выделения памяти
+ *
+ * [WARNING] Один контекст нельзя использовать одновременно из нескольких потоков;
+ *           для этого есть pol_mul_mod_ctx_ws.
+ */
+int pol_mul_mod_ctx(const Polynomial* A, const Polynomial* B, PolModulusCtx* ctx,
+                    Polynomial* R);
+
+
+/*
+ * То же, что pol_mul_mod_ctx, но рабочая память берётся из арены ws,
+ * а контекст только читается. Один ctx можно использовать из нескольких
+ * потоков одновременно, если у каждого своя арена.
+ *
+ * [RETURN]  как у pol_mul_mod_ctx; POL_NULL_PTR — также при ws == NULL
+ */
+int pol_mul_mod_ctx_ws(const Polynomial* A, const Polynomial* B, const PolModulusCtx* ctx,
+                       Polynomial* R, PolWorkspace* ws);
+
+/*------------------ ПАКЕТНОЕ УМНОЖЕНИЕ ------------------*/
+
+/*
+ * Пакет независимых произведений по одному модулю: R[i] = (A[i] * B[i]) mod M,
+ * i = 0 .. n-1. Данные M (контекст PolModulusCtx) строятся один раз и
+ * читаются всеми потоками; у каждого потока своя рабочая арена. При сборке
+ * с OpenMP элементы распределяются динамически по pol_get_num_threads()
+ * потокам (см. pol_par.h), иначе обрабатываются по порядку. Задачи длинных
+ * произведений внутри пакета выполняются той же командой потоков.
+ *
+ * [IN]      A, B    массивы из n множителей (модуль совпадает с модулем M)
+ * [IN]      n       число произведений
+ * [IN]      M       унитарный модуль
+ * [OUT]     R       массив из n инициализированных многочленов-результатов;
+ *                   R[i] может совпадать с A[i] или B[i], но не с элементами
+ *                   с другими номерами
+ *
+ * [RETURN]  POL_SUCCESS         — успех
+ *           POL_NULL_PTR        — один из аргументов == NULL
+ *           POL_MODULO_MISMATCH — модуль какого-то A[i] или B[i] отличается от модуля M
+ *           POL_ZERO_DIV        — M — нулевой многочлен
+ *           POL_INVALID_ARG     — M не является унитарным
+ *           POL_MEMORY_ERROR    — ошибка выделения памяти
+ *
+ * [NOTE]    При ошибке в отдельных элементах возвращается код ошибки элемента
+ *           с наименьшим номером; остальные элементы всё равно вычисляются.
+ */
+int pol_mul_mod_unit_batch(const Polynomial* A, const Polynomial* B, size_t n,
+                           const Polynomial* M, Polynomial* R);
+
+
+/*
+ * То же, что pol_mul_mod_unit_batch, с готовым контекстом модуля
+ * (для нескольких пакетов по одному M). Контекст не изменяется.
+ */
+int pol_mul_mod_batch_ctx(const Polynomial* A, const Polynomial* B, size_t n,
+                          const PolModulusCtx* ctx, Polynomial* R);
+
 #endif //LAB3_POLYNOMIAL_H
\ No newline at end of file
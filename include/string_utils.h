@@ -8,31 +8,175 @@
  * Формат строки: "(c0,c1,...,cn)"
  * Пример: "(1,2,3)" соответствует многочлену 3x^2 + 2x + 1.
  *
+ * Между элементами допускаются пробелы, табуляции и переводы строк.
+ * Коэффициент — целое со знаком любой длины; он точно приводится по
+ * модулю (длинные числа не переполняются). Строка разбирается за один
+ * проход, цифры — по 8 за раз; буфер pol растёт по мере разбора.
+ * Текст после ')' не проверяется.
+ *
  * [IN]      str     строка с коэффициентами
  * [IN]      modulo     модуль (modulo > 1)
- * [OUT]     pol     результирующий многочлен (coeffs выделяются заново)
+ * [OUT]     pol     результирующий многочлен; его буфер переиспользуется, если хватает
+ *                   ёмкости (pol должен быть инициализирован, например new_pol)
  *
  * [RETURN]  POL_SUCCESS        — успех
  *           POL_NULL_PTR       — str == NULL или pol == NULL
  *           POL_INVALID_MODULO — modulo <= 1
  *           POL_INVALID_ARG    — некорректный формат строки
  *           POL_MEMORY_ERROR   — ошибка выделения памяти
+ *
+ * [NOTE]    При ошибке pol остаётся корректным многочленом (прежним или нулевым)
+ *           и освобождается обычным free_pol.
  */
 int str_to_pol(const char* str, ULL modulo, Polynomial* pol);
 
+
+/*
+ * str_to_pol для текста из потока: читает порциями по 64 КиБ, не держа
+ * в памяти весь текст, и останавливается после ')'. Прочитанный сверх
+ * ')' остаток порции возвращается в поток перемоткой; если поток её не
+ * допускает (канал, терминал), этот остаток теряется.
+ *
+ * [IN]      f       открытый на чтение поток
+ * [IN]      modulo  модуль (modulo > 1)
+ * [OUT]     pol     как в str_to_pol
+ *
+ * [RETURN]  коды str_to_pol (POL_NULL_PTR — f == NULL или pol == NULL);
+ *           POL_INVALID_ARG    — также текст оборвался до ')'
+ *           POL_IO_ERROR       — ошибка чтения
+ */
+int pol_read_str(FILE* f, ULL modulo, Polynomial* pol);
+
+
+/*
+ * pol_read_str для файлового дескриптора (read/lseek). На системах без
+ * POSIX-дескрипторов возвращает POL_IO_ERROR.
+ *
+ * [RETURN]  как pol_read_str; POL_IO_ERROR — также fd < 0
+ */
+int pol_read_str_fd(int fd, ULL modulo, Polynomial* pol);
+
+/*
+ * Последовательное чтение многочленов из одного потока через собственный
+ * буфер (64 КиБ): в отличие от pol_read_str, прочитанное сверх ')' не
+ * возвращается в поток, а остаётся в буфере для следующего вызова, поэтому
+ * подходит и для каналов.
+ */
+typedef struct PolReader
+{
+    FILE* f;
+    char* buf;
+    size_t len;     // байт в буфере
+    size_t pos;     // первый неразобранный байт
+    int eof;        // поток исчерпан
+    int error;      // ошибка чтения
+} PolReader;
+
+/*
+ * [RETURN]  POL_SUCCESS, POL_NULL_PTR (rd или f == NULL) или POL_MEMORY_ERROR
+ */
+int pol_reader_init(PolReader* rd, FILE* f);
+
+/* Освобождает буфер; поток не закрывается */
+void pol_reader_free(PolReader* rd);
+
+
+/*
+ * Читает следующий многочлен "(c0,...,cn)" из текущей строки (пробельные
+ * символы перед ним пропускаются, '\n' — нет: многочлен, не закрытый до
+ * конца строки, — ошибка). При ошибке чтение останавливается на ошибочном
+ * символе, так что остаток строки можно пропустить pol_reader_end_line.
+ * Коды и состояние pol при ошибке — как у pol_read_str.
+ */
+int pol_reader_next(PolReader* rd, ULL modulo, Polynomial* pol);
+
+
+/*
+ * Пропускает остаток текущей строки вместе с '\n'.
+ *
+ * [RETURN]  POL_SUCCESS        — в остатке только пробельные символы
+ *           POL_INVALID_ARG    — в остатке было что-то ещё
+ *           POL_IO_ERROR       — ошибка чтения
+ */
+int pol_reader_end_line(PolReader* rd);
+
+
+/*
+ * Пропускает пробельные символы и сообщает, остались ли данные.
+ *
+ * [RETURN]  1 — поток исчерпан (или ошибка чтения, см. rd->error), 0 — нет
+ */
+int pol_reader_at_end(PolReader* rd);
+
+
 /*
  * Формирует строку вида "(c0,c1,...,cn)" по многочлену.
- * Память под строку выделяется внутри функции.
+ * Память под строку выделяется внутри функции одним вызовом по оценке
+ * pol_str_bound, коэффициенты записываются за один проход.
  *
- * [IN]      pol     исходный многочлен
- * [OUT]     str     указатель на результирующую строку (нужно освободить)
+ * [IN]      pol       исходный многочлен
+ * [OUT]     str       указатель на результирующую строку (нужно освободить)
+ * [OUT]     out_size  размер выделенного буфера (не меньше длины строки + 1);
+ *                     с ним строка освобождается: free(*str, *out_size)
  *
  * [RETURN]  POL_SUCCESS        — успех
- *           POL_NULL_PTR       — pol == NULL или str == NULL
+ *           POL_NULL_PTR       — pol == NULL, str == NULL или out_size == NULL
  *           POL_INVALID_ARG    — pol->coeffs == NULL
  *           POL_MEMORY_ERROR   — ошибка выделения памяти
  */
 int pol_to_str(const Polynomial* pol, char** str, size_t* out_size);
 
 
+/*
+ * Верхняя оценка размера строки pol_to_str вместе с '\0' за O(1): все
+ * коэффициенты считаются длиной modulo - 1.
+ *
+ * [RETURN]  оценка в байтах; 0 — pol == NULL
+ */
+size_t pol_str_bound(const Polynomial* pol);
+
+
+/*
+ * pol_to_str в буфер вызывающей стороны, без выделения памяти. Буфера
+ * размера pol_str_bound(pol) достаточно, если коэффициенты приведены по модулю.
+ *
+ * [IN]      pol     исходный многочлен
+ * [OUT]     buf     строка с '\0'; при POL_BUFFER_SMALL содержимое не определено
+ * [IN]      size    размер buf в байтах
+ * [OUT]     len     длина строки без '\0' (NULL — не нужна)
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — pol == NULL или buf == NULL
+ *           POL_INVALID_ARG    — pol->coeffs == NULL
+ *           POL_BUFFER_SMALL   — строка не помещается в size байт
+ */
+int pol_to_str_buf(const Polynomial* pol, char* buf, size_t size, size_t* len);
+
+
+/*
+ * Записывает строку pol_to_str в поток порциями по 64 КиБ (без '\0'), не
+ * держа в памяти всю строку: вывод многочлена степени 10^7 обходится
+ * одним буфером фиксированного размера.
+ *
+ * [IN]      f       открытый на запись поток
+ * [IN]      pol     исходный многочлен
+ *
+ * [RETURN]  POL_SUCCESS        — успех
+ *           POL_NULL_PTR       — f == NULL или pol == NULL
+ *           POL_INVALID_ARG    — pol->coeffs == NULL
+ *           POL_MEMORY_ERROR   — ошибка выделения буфера
+ *           POL_IO_ERROR       — ошибка записи (часть строки может быть записана)
+ */
+int pol_write_str(FILE* f, const Polynomial* pol);
+
+
+/*
+ * pol_write_str для файлового дескриптора (write с повтором при частичной
+ * записи). На системах без POSIX-дескрипторов возвращает POL_IO_ERROR.
+ *
+ * [RETURN]  как pol_write_str; POL_IO_ERROR — также fd < 0
+ */
+int pol_write_str_fd(int fd, const Polynomial* pol);
+
+
 #endif //LAB3_STRING_UTILS_H
\ No newline at end of file
@@ -15,8 +15,15 @@ enum TEST_Error
     TEST_UNKNOWN_ERROR       /* непредвиденная ошибка */
 };
 
+/* Случайное 64-битное число из генератора потока (pol_rng_local) */
 ULL rand64();
 
+/*
+ * Случайный многочлен степени ровно degree по модулю modulo
+ * (pol_rng_pol с генератором потока).
+ *
+ * [RETURN]  коды pol_rng_pol
+ */
 int get_rand_pol(Polynomial* P, size_t degree, ULL modulo);
 
 /*
@@ -55,8 +62,13 @@ int manual_test();
  *    2) вычисляется R = (A * B) mod M;
  *    3) при включённой отладке выводятся промежуточные данные.
  *
- * Результаты тестов сохраняются в "../data/output.csv" в следующем формате:
- * degree | modulo | mod_deg | mem_used
+ * Результаты тестов дописываются в "result.csv" в следующем формате:
+ * degA, degB, degM, degR, bytesA, bytesB, bytesM, bytesR, mem_delta, mem_peak, allocs
+ * (mem_peak — наибольший рабочий объём памяти во время умножения,
+ *  allocs — число выделений; считаются по потоку, см. mem_thread_snapshot)
+ *
+ * [NOTE]    Для замеров времени по сетке степеней и модулей без ввода
+ *           с клавиатуры служит отдельная программа lab3_bench (bench.c).
  *
  * [RETURN]  TEST_SUCCESS        — выполнение завершено успешно, все тесты пройдены
  *           TEST_NULL_PTR       — нулевой указатель при работе с файлом или полиномом
@@ -92,4 +104,29 @@ int auto_test();
 int input_test();
 
 
+/*
+ * Замеряет стоимость модульного умножения коэффициентов: прежнее 64-битное
+ * (a * b) % m, которое переполняется при m > 2^32, против mul_mod
+ * со 128-битным произведением. Для каждого модуля выводит время на
+ * операцию в наносекундах и число неверных результатов 64-битного варианта.
+ *
+ * [RETURN]  TEST_SUCCESS        — замер выполнен
+ *           TEST_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int mulmod_bench();
+
+
+/*
+ * Замеряет пропускную способность пакетного умножения по модулю, когда
+ * каждое произведение создаёт и освобождает свои многочлены (нагрузка на
+ * распределитель памяти). Выводит число произведений в секунду для
+ * нескольких степеней и имя распределителя (см. mem_backend_name), так что
+ * сборки с POL_USE_POOL и без него сравниваются запуском обеих.
+ *
+ * [RETURN]  TEST_SUCCESS        — замер выполнен
+ *           TEST_MEMORY_ERROR   — ошибка выделения памяти
+ */
+int alloc_bench();
+
+
 #endif //LAB3_TEST_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ * Пакетная обработка файла заданий.
+ *
+ *   lab3_jobs -m МОДУЛЬ [-j ПОТОКИ] [-q ОЧЕРЕДЬ] [-o ФАЙЛ] [ВХОД]
+ *
+ * Каждая строка входа — задание "(a0,...) (b0,...) (m0,...,1)", в выход
+ * пишется строка (A * B) mod M или "error <код>". Вход читается, считается
+ * и пишется конвейером (см. pol_jobs_run), поэтому файл может быть больше
+ * памяти. Итоги — число заданий, ошибок, время и заданий в секунду —
+ * выводятся в stderr.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/polynomial.h"
+#include "include/pol_tune.h"
+#include "include/pol_jobs.h"
+#include "include/mem_tracker.h"
+
+typedef struct JobsArgs
+{
+    PolJobsConfig cfg;
+    const char* input;          // NULL или "-" — stdin
+    const char* output;         // NULL — stdout
+    const char* config;         // файл порогов; NULL — по умолчанию
+    int quiet;                  // без итогов в stderr
+} JobsArgs;
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+        "usage: %s -m MODULO [options] [INPUT]\n"
+        "  INPUT                 файл заданий, по строке на задание: (A) (B) (M);\n"
+        "                        - или ничего — stdin\n"
+        "  -m, --modulo N        модуль кольца для всех заданий\n"
+        "  -j, --workers N       вычисляющих потоков (0 — по числу процессоров)\n"
+        "  -q, --queue N         заданий в обработке одновременно (0 — "
+                                 "%d на поток)\n"
+        "  -o, --output FILE     файл результатов (stdout)\n"
+        "  -c, --config FILE     файл порогов (по умолчанию $POL_TUNE_FILE или "
+                                 POL_TUNE_DEFAULT_FILE ")\n"
+        "  -s, --silent          не выводить итоги\n",
+        prog, POL_JOBS_QUEUE_PER_WORKER);
+}
+
+static int parse_size(const char* s, size_t* out)
+{
+    char* end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s || *end != '\0' || s[0] == '-')
+        return 0;
+    *out = (size_t)v;
+    return 1;
+}
+
+static int parse_args(int argc, char** argv, JobsArgs* args)
+{
+    memset(args, 0, sizeof(*args));
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        size_t n;
+        int ok = 1;
+
+        if (!strcmp(a, "-h") || !strcmp(a, "--help"))
+        {
+            usage(argv[0]);
+            exit(0);
+        }
+        if (!strcmp(a, "-s") || !strcmp(a, "--silent"))
+        {
+            args->quiet = 1;
+            continue;
+        }
+        if (a[0] != '-' || !strcmp(a, "-"))
+        {
+            if (args->input != NULL)
+            {
+                fprintf(stderr, "extra input: %s\n", a);
+                usage(argv[0]);
+                return 0;
+            }
+            args->input = a;
+            continue;
+        }
+        if (v == NULL)
+        {
+            usage(argv[0]);
+            return 0;
+        }
+
+        if (!strcmp(a, "-m") || !strcmp(a, "--modulo"))
+        {
+            ok = parse_size(v, &n) && n > 1;
+            args->cfg.modulo = n;
+        }
+        else if (!strcmp(a, "-j") || !strcmp(a, "--workers"))
+        {
+            ok = parse_size(v, &n) && n <= 4096;
+            args->cfg.workers = (int)n;
+        }
+        else if (!strcmp(a, "-q") || !strcmp(a, "--queue"))  ok = parse_size(v, &args->cfg.queue);
+        else if (!strcmp(a, "-o") || !strcmp(a, "--output")) args->output = v;
+        else if (!strcmp(a, "-c") || !strcmp(a, "--config")) args->config = v;
+        else ok = 0;
+
+        if (!ok)
+        {
+            fprintf(stderr, "bad argument: %s %s\n", a, v);
+            usage(argv[0]);
+            return 0;
+        }
+        i++;
+    }
+
+    if (args->cfg.modulo == 0)
+    {
+        fprintf(stderr, "modulo is required\n");
+        usage(argv[0]);
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    JobsArgs args;
+    if (!parse_args(argc, argv, &args))
+        return 2;
+
+    // явно указанный файл порогов обязан загрузиться, файл по умолчанию — нет
+    int tune_status = pol_tune_load(args.config);
+    if (args.config != NULL && tune_status != POL_SUCCESS)
+    {
+        fprintf(stderr, "cannot load thresholds from %s: error %d\n", args.config, tune_status);
+        return 1;
+    }
+
+    FILE* in = stdin;
+    if (args.input != NULL && strcmp(args.input, "-") != 0 && (in = fopen(args.input, "r")) == NULL)
+    {
+        perror(args.input);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (args.output != NULL && (out = fopen(args.output, "w")) == NULL)
+    {
+        perror(args.output);
+        if (in != stdin)
+            fclose(in);
+        return 1;
+    }
+
+    PolJobsStats stats;
+    int status = pol_jobs_run(in, out, &args.cfg, &stats);
+
+    if (in != stdin)
+        fclose(in);
+    if (out != stdout && fclose(out) != 0 && status == POL_SUCCESS)
+        status = POL_IO_ERROR;
+
+    if (!args.quiet)
+    {
+        double rate = (stats.seconds > 0) ? (double)stats.jobs / stats.seconds : 0;
+        fprintf(stderr, "jobs %zu, errors %zu, %.3f s, %.0f jobs/s, workers %d\n",
+                stats.jobs, stats.failed, stats.seconds, rate, stats.workers);
+    }
+
+    if (status != POL_SUCCESS)
+    {
+        fprintf(stderr, "processing stopped: error %d\n", status);
+        return 1;
+    }
+    return stats.failed != 0;
+}
@@ -1,11 +1,17 @@
 #include "include/test.h"
+#include "include/pol_tune.h"
 
 int main()
 {
+    // пороги из pol_tune.cfg (lab3_bench --tune), если файл есть
+    pol_tune_load(NULL);
+
     manual_test();
     printf("\n");
     printf("\n");
     // input_test();
+    // mulmod_bench();
+    // alloc_bench();
     printf("\n");
     printf("\n");
     auto_test();
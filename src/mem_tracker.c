@@ -1,32 +1,229 @@
 #include "../include/mem_tracker.h"
 
+#include <string.h>
+
+#ifdef POL_USE_POOL
+#include <pthread.h>
+#endif
+
 // отключаем макросы для самой реализации
 #undef malloc
 #undef calloc
 #undef free
 
-size_t g_total_allocated = 0;
-size_t g_total_freed = 0;
-size_t g_current_allocated = 0;
+_Atomic size_t g_total_allocated = 0;
+_Atomic size_t g_total_freed = 0;
+_Atomic size_t g_current_allocated = 0;
+_Atomic size_t g_peak_allocated = 0;
+
+static _Atomic size_t g_alloc_count = 0;
+static _Atomic size_t g_free_count = 0;
+static _Atomic size_t g_histogram[MEM_HIST_BUCKETS];
+
+// счётчики потока: обновляются без синхронизации
+static _Thread_local MemStats t_stats;
+
+static size_t hist_bucket(size_t size)
+{
+    size_t k = 0;
+    while (size != 0 && k + 1 < MEM_HIST_BUCKETS)
+    {
+        size >>= 1;
+        k++;
+    }
+    return k;
+}
+
+static void raise_peak(_Atomic size_t* peak, size_t value)
+{
+    size_t old = atomic_load_explicit(peak, memory_order_relaxed);
+    while (old < value &&
+           !atomic_compare_exchange_weak_explicit(peak, &old, value,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {;}
+}
+
+static void record_alloc(size_t size)
+{
+    size_t bucket = hist_bucket(size);
+
+    atomic_fetch_add_explicit(&g_total_allocated, size, memory_order_relaxed);
+    size_t current = atomic_fetch_add_explicit(&g_current_allocated, size,
+                                               memory_order_relaxed) + size;
+    raise_peak(&g_peak_allocated, current);
+    atomic_fetch_add_explicit(&g_alloc_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_histogram[bucket], 1, memory_order_relaxed);
+
+    t_stats.total_allocated += size;
+    t_stats.current += size;
+    // current потока уходит ниже нуля, если он освобождает чужую память
+    if ((ptrdiff_t)t_stats.current > (ptrdiff_t)t_stats.peak)
+        t_stats.peak = t_stats.current;
+    t_stats.alloc_count++;
+    t_stats.histogram[bucket]++;
+}
+
+#ifdef POL_USE_POOL
+
+/*---------------------------- ПУЛ БЛОКОВ ----------------------------*/
+
+#define POOL_ALIGN 64
+#define POOL_MIN_SHIFT 6                                    // 64 байта
+#define POOL_CLASSES 15                                     // 64 байта .. 1 МиБ
+#define POOL_CACHE_BYTES ((size_t)4 << 20)                  // предел кэша класса у потока
+
+typedef struct PoolBlock
+{
+    struct PoolBlock* next;
+} PoolBlock;
+
+typedef struct PoolCache
+{
+    PoolBlock* head[POOL_CLASSES];
+    size_t count[POOL_CLASSES];
+    int registered;
+} PoolCache;
+
+static _Thread_local PoolCache t_pool;
+static pthread_key_t g_pool_key;
+static pthread_once_t g_pool_once = PTHREAD_ONCE_INIT;
+
+/* Класс размера: наименьший k, при котором 64 << k >= size; POOL_CLASSES — не из пула */
+static size_t pool_class(size_t size)
+{
+    if (size > MEM_POOL_MAX_BLOCK)
+        return POOL_CLASSES;
+
+    size_t k = 0;
+    while (((size_t)MEM_POOL_MIN_BLOCK << k) < size)
+        k++;
+    return k;
+}
+
+static void pool_release(PoolCache* cache)
+{
+    for (size_t k = 0; k < POOL_CLASSES; k++)
+    {
+        while (cache->head[k] != NULL)
+        {
+            PoolBlock* block = cache->head[k];
+            cache->head[k] = block->next;
+            free(block);
+        }
+        cache->count[k] = 0;
+    }
+}
+
+static void pool_thread_exit(void* arg)
+{
+    PoolCache* cache = arg;
+    pool_release(cache);
+    cache->registered = 0;
+}
+
+static void pool_make_key(void)
+{
+    pthread_key_create(&g_pool_key, pool_thread_exit);
+}
+
+/* Регистрирует кэш потока, чтобы он освобождался при завершении потока */
+static void pool_register(void)
+{
+    pthread_once(&g_pool_once, pool_make_key);
+    pthread_setspecific(g_pool_key, &t_pool);
+    t_pool.registered = 1;
+}
+
+static void* pool_alloc(size_t size)
+{
+    size_t k = pool_class(size);
+
+    if (k < POOL_CLASSES && t_pool.head[k] != NULL)
+    {
+        PoolBlock* block = t_pool.head[k];
+        t_pool.head[k] = block->next;
+        t_pool.count[k]--;
+        return block;
+    }
+
+    size_t bytes = (k < POOL_CLASSES) ? (size_t)MEM_POOL_MIN_BLOCK << k
+                                      : (size + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+    if (bytes == 0)
+        return NULL;    // переполнение при округлении
+    return aligned_alloc(POOL_ALIGN, bytes);
+}
+
+static void pool_free(void* ptr, size_t size)
+{
+    size_t k = pool_class(size);
+    size_t block_bytes = (size_t)MEM_POOL_MIN_BLOCK << k;
+
+    if (k == POOL_CLASSES || (t_pool.count[k] + 1) * block_bytes > POOL_CACHE_BYTES)
+    {
+        free(ptr);
+        return;
+    }
+
+    if (!t_pool.registered)
+        pool_register();
+
+    PoolBlock* block = ptr;
+    block->next = t_pool.head[k];
+    t_pool.head[k] = block;
+    t_pool.count[k]++;
+}
+
+void mem_pool_trim(void)
+{
+    pool_release(&t_pool);
+}
+
+const char* mem_backend_name(void)
+{
+    return "pool";
+}
+
+#else
+
+#define pool_alloc(size) malloc(size)
+#define pool_free(ptr, size) free(ptr)
+
+void mem_pool_trim(void)
+{
+}
+
+const char* mem_backend_name(void)
+{
+    return "libc";
+}
+
+#endif
 
 void* track_malloc(size_t size)
 {
-    void* ptr = malloc(size);
+    void* ptr = pool_alloc(size);
     if(ptr)
     {
-        g_total_allocated += size;
-        g_current_allocated += size;
+        record_alloc(size);
     }
     return ptr;
 }
 
 void* track_calloc(size_t num, size_t size)
 {
+    if (size != 0 && num > (size_t)-1 / size)
+        return NULL;
+
+#ifdef POL_USE_POOL
+    void* ptr = pool_alloc(num * size);
+    if (ptr)
+        memset(ptr, 0, num * size);
+#else
     void* ptr = calloc(num, size);
+#endif
     if(ptr)
     {
-        g_total_allocated += num * size;
-        g_current_allocated += num * size;
+        record_alloc(num * size);
     }
     return ptr;
 }
@@ -35,8 +232,56 @@ void track_free(void* ptr, size_t size)
 {
     if(ptr)
     {
-        g_total_freed += size;
-        g_current_allocated -= size;
-        free(ptr);
+        atomic_fetch_add_explicit(&g_total_freed, size, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&g_current_allocated, size, memory_order_relaxed);
+        atomic_fetch_add_explicit(&g_free_count, 1, memory_order_relaxed);
+
+        t_stats.total_freed += size;
+        t_stats.current -= size;
+        t_stats.free_count++;
+        pool_free(ptr, size);
     }
 }
+
+void mem_snapshot(MemStats* s)
+{
+    if (s == NULL)
+        return;
+
+    s->total_allocated = atomic_load(&g_total_allocated);
+    s->total_freed = atomic_load(&g_total_freed);
+    s->current = atomic_load(&g_current_allocated);
+    s->peak = atomic_load(&g_peak_allocated);
+    s->alloc_count = atomic_load(&g_alloc_count);
+    s->free_count = atomic_load(&g_free_count);
+    for (size_t k = 0; k < MEM_HIST_BUCKETS; k++)
+        s->histogram[k] = atomic_load_explicit(&g_histogram[k], memory_order_relaxed);
+}
+
+void mem_thread_snapshot(MemStats* s)
+{
+    if (s != NULL)
+        *s = t_stats;
+}
+
+void mem_diff(const MemStats* before, const MemStats* after, MemStats* d)
+{
+    if (before == NULL || after == NULL || d == NULL)
+        return;
+
+    d->total_allocated = after->total_allocated - before->total_allocated;
+    d->total_freed = after->total_freed - before->total_freed;
+    d->current = after->current - before->current;
+    ptrdiff_t peak = (ptrdiff_t)(after->peak - before->current);
+    d->peak = (peak > 0) ? (size_t)peak : 0;
+    d->alloc_count = after->alloc_count - before->alloc_count;
+    d->free_count = after->free_count - before->free_count;
+    for (size_t k = 0; k < MEM_HIST_BUCKETS; k++)
+        d->histogram[k] = after->histogram[k] - before->histogram[k];
+}
+
+void mem_reset_peak(void)
+{
+    atomic_store(&g_peak_allocated, atomic_load(&g_current_allocated));
+    t_stats.peak = t_stats.current;
+}
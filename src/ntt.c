@@ -0,0 +1,715 @@
+#include <stdatomic.h>
+
+#include "../include/ntt.h"
+#include "../include/pol_arith.h"
+#include "../include/pol_par.h"
+#include "../include/mem_tracker.h"
+
+size_t g_ntt_threshold = POL_NTT_THRESHOLD;
+size_t g_ntt_crt_threshold = POL_NTT_CRT_THRESHOLD;
+
+/* 62-битные простые вида c * 2^k + 1 (k >= 54), каждое больше 2^61 */
+static const ULL g_crt_primes[NTT_CRT_PRIMES] =
+{
+    4179340454199820289ULL,   //  29 * 2^57 + 1
+    2485986994308513793ULL,   //  69 * 2^55 + 1
+    3188548536178311169ULL,   // 177 * 2^54 + 1
+};
+
+/* g_crt_inv[j][i] = p_j^(-1) mod p_i для j < i, подготовлены под g_crt_ctx[i] */
+static ULL g_crt_inv[NTT_CRT_PRIMES][NTT_CRT_PRIMES];
+static PolModCtx g_crt_ctx[NTT_CRT_PRIMES];
+static atomic_int g_crt_ready = 0;
+
+typedef struct NttModInfo
+{
+    ULL p;              // модуль (0 — свободная ячейка)
+    unsigned max_log;   // 2^max_log делит p - 1; 0 — p не подходит
+    ULL root;           // первообразный корень степени 2^max_log из 1
+} NttModInfo;
+
+typedef struct NttTable
+{
+    ULL p;
+    unsigned log;       // длина преобразования 2^log
+    PolModCtx ctx;      // контекст модуля p
+    ULL* w;             // w[j] = omega^j, j < 2^(log-1); далее — обратные корни (ctx_prep)
+    ULL inv_len;        // (2^log)^(-1) mod p (ctx_prep)
+    size_t stamp;       // время последнего использования
+    size_t users;       // сколько преобразований сейчас читают таблицу
+    int cached;         // 0 — таблица вне кэша, освобождается release_table
+} NttTable;
+
+/*
+ * Кэши общие для всех потоков и защищены спин-блокировкой: под ней только
+ * поиск и вставка, таблицы строятся снаружи. Таблица, которую кто-то
+ * использует (users > 0), не вытесняется.
+ */
+static atomic_flag g_cache_lock = ATOMIC_FLAG_INIT;
+
+static NttModInfo g_mod_info[NTT_CACHE_SIZE];
+static size_t g_mod_info_next = 0;
+
+static NttTable g_tables[NTT_CACHE_SIZE];
+static size_t g_clock = 0;
+
+static void cache_lock(void)
+{
+    while (atomic_flag_test_and_set_explicit(&g_cache_lock, memory_order_acquire))
+    {;}
+}
+
+static void cache_unlock(void)
+{
+    atomic_flag_clear_explicit(&g_cache_lock, memory_order_release);
+}
+
+/*--------------------- ВСПОМОГАТЕЛЬНЫЕ ОПЕРАЦИИ ---------------------*/
+
+int ntt_is_prime(ULL n)
+{
+    static const ULL bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    const size_t count = sizeof(bases) / sizeof(bases[0]);
+
+    if (n < 2)
+        return 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (n % bases[i] == 0)
+            return n == bases[i];
+    }
+
+    ULL d = n - 1;
+    unsigned s = 0;
+    while ((d & 1) == 0)
+    {
+        d >>= 1;
+        s++;
+    }
+
+    // 12 первых простых оснований достаточно для всех n < 2^64
+    for (size_t i = 0; i < count; i++)
+    {
+        ULL x = pow_mod(bases[i], d, n);
+        if (x == 1 || x == n - 1)
+            continue;
+
+        int composite = 1;
+        for (unsigned r = 1; r < s; r++)
+        {
+            x = mul_mod(x, x, n);
+            if (x == n - 1)
+            {
+                composite = 0;
+                break;
+            }
+        }
+
+        if (composite)
+            return 0;
+    }
+    return 1;
+}
+
+static NttModInfo mod_info(ULL p)
+{
+    cache_lock();
+    for (size_t i = 0; i < NTT_CACHE_SIZE; i++)
+    {
+        if (g_mod_info[i].p == p)
+        {
+            NttModInfo found = g_mod_info[i];
+            cache_unlock();
+            return found;
+        }
+    }
+    cache_unlock();
+
+    NttModInfo info = {p, 0, 0};
+
+    if (p > 2 && ntt_is_prime(p))
+    {
+        ULL d = p - 1;
+        unsigned s = 0;
+        while ((d & 1) == 0)
+        {
+            d >>= 1;
+            s++;
+        }
+
+        // g^d имеет порядок ровно 2^s, если g — квадратичный невычет
+        for (ULL g = 2; g < p; g++)
+        {
+            ULL w = pow_mod(g, d, p);
+            if (pow_mod(w, 1ULL << (s - 1), p) == p - 1)
+            {
+                info.root = w;
+                info.max_log = s;
+                break;
+            }
+        }
+    }
+
+    cache_lock();
+    size_t slot = g_mod_info_next++ % NTT_CACHE_SIZE;
+    g_mod_info[slot] = info;
+    cache_unlock();
+    return info;
+}
+
+unsigned ntt_max_log(ULL p)
+{
+    return mod_info(p).max_log;
+}
+
+/* Ищет таблицу в кэше и отмечает её занятой; вызывается под блокировкой */
+static NttTable* find_table(ULL p, unsigned log)
+{
+    for (size_t i = 0; i < NTT_CACHE_SIZE; i++)
+    {
+        if (g_tables[i].w != NULL && g_tables[i].p == p && g_tables[i].log == log)
+        {
+            g_tables[i].stamp = ++g_clock;
+            g_tables[i].users++;
+            return &g_tables[i];
+        }
+    }
+    return NULL;
+}
+
+/* Таблица корней для (p, 2^log); после использования отдаётся release_table */
+static const NttTable* acquire_table(ULL p, unsigned log)
+{
+    cache_lock();
+    NttTable* found = find_table(p, log);
+    cache_unlock();
+    if (found != NULL)
+        return found;
+
+    NttModInfo info = mod_info(p);
+    if (log == 0 || log > info.max_log)
+        return NULL;
+
+    size_t len = (size_t)1 << log;
+    size_t half = len / 2;
+
+    ULL* w = malloc(len * sizeof(ULL));
+    if (w == NULL)
+        return NULL;
+
+    ULL omega = info.root;
+    for (unsigned k = log; k < info.max_log; k++)
+        omega = mul_mod(omega, omega, p);
+    ULL omega_inv = pow_mod(omega, p - 2, p);
+
+    w[0] = 1;
+    w[half] = 1;
+    for (size_t j = 1; j < half; j++)
+    {
+        w[j] = mul_mod(w[j - 1], omega, p);
+        w[half + j] = mul_mod(w[half + j - 1], omega_inv, p);
+    }
+
+    PolModCtx ctx;
+    pol_modctx_init(&ctx, p);
+    for (size_t j = 0; j < len; j++)
+        w[j] = ctx_prep(&ctx, w[j]);
+
+    NttTable built = {p, log, ctx, w, ctx_prep(&ctx, pow_mod(len % p, p - 2, p)), 0, 1, 1};
+
+    cache_lock();
+
+    // пока таблица строилась, её мог добавить другой поток
+    found = find_table(p, log);
+    if (found != NULL)
+    {
+        cache_unlock();
+        free(w, len * sizeof(ULL));
+        return found;
+    }
+
+    // вытесняем самую давно использованную свободную таблицу
+    NttTable* victim = NULL;
+    for (size_t i = 0; i < NTT_CACHE_SIZE; i++)
+    {
+        NttTable* t = &g_tables[i];
+        if (t->w == NULL)
+        {
+            victim = t;
+            break;
+        }
+        if (t->users == 0 && (victim == NULL || t->stamp < victim->stamp))
+            victim = t;
+    }
+
+    if (victim != NULL)
+    {
+        ULL* old_w = victim->w;
+        size_t old_len = (old_w != NULL) ? (size_t)1 << victim->log : 0;
+
+        *victim = built;
+        victim->stamp = ++g_clock;
+        cache_unlock();
+
+        if (old_w != NULL)
+            free(old_w, old_len * sizeof(ULL));
+        return victim;
+    }
+    cache_unlock();
+
+    // все ячейки заняты работающими преобразованиями: таблица только для этого вызова
+    NttTable* own = malloc(sizeof(NttTable));
+    if (own == NULL)
+    {
+        free(w, len * sizeof(ULL));
+        return NULL;
+    }
+    *own = built;
+    own->cached = 0;
+    return own;
+}
+
+static void release_table(const NttTable* table)
+{
+    NttTable* t = (NttTable*)table;
+
+    if (!t->cached)
+    {
+        free(t->w, ((size_t)1 << t->log) * sizeof(ULL));
+        free(t, sizeof(NttTable));
+        return;
+    }
+
+    cache_lock();
+    t->users--;
+    cache_unlock();
+}
+
+void ntt_cache_clear(void)
+{
+    cache_lock();
+    for (size_t i = 0; i < NTT_CACHE_SIZE; i++)
+    {
+        if (g_tables[i].users != 0)
+            continue;
+        if (g_tables[i].w != NULL)
+            free(g_tables[i].w, ((size_t)1 << g_tables[i].log) * sizeof(ULL));
+        g_tables[i].w = NULL;
+        g_tables[i].p = 0;
+    }
+    for (size_t i = 0; i < NTT_CACHE_SIZE; i++)
+        g_mod_info[i].p = 0;
+    cache_unlock();
+}
+
+/*--------------------- ПРЕОБРАЗОВАНИЯ ---------------------*/
+
+/*
+ * Прямое преобразование (Гентльмен — Санде): естественный порядок -> бит-реверсный.
+ * Подпреобразование длины n внутри преобразования длины n * wstep берёт корни
+ * с шагом wstep.
+ */
+static void ntt_forward_seq(ULL* a, size_t n, const ULL* w, size_t wstep,
+                            const PolModCtx* ctx)
+{
+    const PolModCtx c = *ctx;
+    ULL p = c.modulo;
+
+    for (size_t blk = n; blk >= 2; blk >>= 1)
+    {
+        size_t half = blk >> 1;
+        size_t step = wstep * (n / blk);
+
+        for (size_t i = 0; i < n; i += blk)
+        {
+            for (size_t j = 0; j < half; j++)
+            {
+                ULL u = a[i + j];
+                ULL v = a[i + j + half];
+                a[i + j] = add_mod(u, v, p);
+                a[i + j + half] = ctx_mul_prep(&c, sub_mod(u, v, p), w[j * step]);
+            }
+        }
+    }
+}
+
+/* Обратное преобразование (Кули — Тьюки): бит-реверсный -> естественный, без деления на n */
+static void ntt_inverse_seq(ULL* a, size_t n, const ULL* wi, size_t wstep,
+                            const PolModCtx* ctx)
+{
+    const PolModCtx c = *ctx;
+    ULL p = c.modulo;
+
+    for (size_t blk = 2; blk <= n; blk <<= 1)
+    {
+        size_t half = blk >> 1;
+        size_t step = wstep * (n / blk);
+
+        for (size_t i = 0; i < n; i += blk)
+        {
+            for (size_t j = 0; j < half; j++)
+            {
+                ULL u = a[i + j];
+                ULL v = ctx_mul_prep(&c, a[i + j + half], wi[j * step]);
+                a[i + j] = add_mod(u, v, p);
+                a[i + j + half] = sub_mod(u, v, p);
+            }
+        }
+    }
+}
+
+/*
+ * После верхнего слоя бабочек половины массива преобразуются независимо,
+ * поэтому в команде потоков длинное преобразование разворачивается в дерево
+ * задач; сам верхний слой делится на куски по POL_PAR_GRAIN.
+ */
+static void ntt_forward(ULL* a, size_t n, const ULL* w, size_t wstep,
+                        const PolModCtx* ctx)
+{
+    if (n <= POL_PAR_GRAIN || !par_in_team())
+    {
+        ntt_forward_seq(a, n, w, wstep, ctx);
+        return;
+    }
+
+    const PolModCtx c = *ctx;
+    ULL p = c.modulo;
+    size_t half = n / 2;
+
+    #pragma omp taskloop grainsize(POL_PAR_GRAIN)
+    for (size_t j = 0; j < half; j++)
+    {
+        ULL u = a[j];
+        ULL v = a[j + half];
+        a[j] = add_mod(u, v, p);
+        a[j + half] = ctx_mul_prep(&c, sub_mod(u, v, p), w[j * wstep]);
+    }
+
+    #pragma omp task
+    ntt_forward(a, half, w, 2 * wstep, ctx);
+
+    ntt_forward(a + half, half, w, 2 * wstep, ctx);
+
+    #pragma omp taskwait
+}
+
+static void ntt_inverse(ULL* a, size_t n, const ULL* wi, size_t wstep,
+                        const PolModCtx* ctx)
+{
+    if (n <= POL_PAR_GRAIN || !par_in_team())
+    {
+        ntt_inverse_seq(a, n, wi, wstep, ctx);
+        return;
+    }
+
+    const PolModCtx c = *ctx;
+    ULL p = c.modulo;
+    size_t half = n / 2;
+
+    #pragma omp task
+    ntt_inverse(a, half, wi, 2 * wstep, ctx);
+
+    ntt_inverse(a + half, half, wi, 2 * wstep, ctx);
+
+    #pragma omp taskwait
+
+    #pragma omp taskloop grainsize(POL_PAR_GRAIN)
+    for (size_t j = 0; j < half; j++)
+    {
+        ULL u = a[j];
+        ULL v = ctx_mul_prep(&c, a[j + half], wi[j * wstep]);
+        a[j] = add_mod(u, v, p);
+        a[j + half] = sub_mod(u, v, p);
+    }
+}
+
+static unsigned log2_len(size_t len)
+{
+    unsigned log = 0;
+    while (((size_t)1 << log) < len)
+        log++;
+    return log;
+}
+
+int ntt_transform(ULL* a, size_t len, ULL p)
+{
+    unsigned log = log2_len(len);
+    if (log == 0 || log > ntt_max_log(p))
+        return POL_INVALID_MODULO;
+
+    const NttTable* t = acquire_table(p, log);
+    if (t == NULL)
+        return POL_MEMORY_ERROR;
+
+    ntt_forward(a, len, t->w, 1, &t->ctx);
+    release_table(t);
+    return POL_SUCCESS;
+}
+
+int ntt_inverse_transform(ULL* a, size_t len, ULL p)
+{
+    unsigned log = log2_len(len);
+    if (log == 0 || log > ntt_max_log(p))
+        return POL_INVALID_MODULO;
+
+    const NttTable* t = acquire_table(p, log);
+    if (t == NULL)
+        return POL_MEMORY_ERROR;
+
+    ntt_inverse(a, len, t->w + len / 2, 1, &t->ctx);
+
+    #pragma omp taskloop grainsize(POL_PAR_GRAIN) if (len > POL_PAR_GRAIN && par_in_team())
+    for (size_t i = 0; i < len; i++)
+        a[i] = ctx_mul_prep(&t->ctx, a[i], t->inv_len);
+    release_table(t);
+    return POL_SUCCESS;
+}
+
+/*--------------------- УМНОЖЕНИЕ ---------------------*/
+
+size_t ntt_length(ULL p, size_t na, size_t nb)
+{
+    size_t n = na + nb - 1;
+    unsigned log = 1;
+    while (((size_t)1 << log) < n)
+        log++;
+
+    unsigned max_log = ntt_max_log(p);
+    size_t half = ((size_t)1 << log) / 2;
+
+    // усечение: циклическая свёртка длины half + прямой досчёт e старших коэффициентов
+    if (log >= 2 && log - 1 <= max_log && na <= half && nb <= half)
+    {
+        size_t e = n - half;
+        if (e * e < half * (log - 1))
+            return half;
+    }
+
+    if (log > max_log)
+        return 0;
+
+    return (size_t)1 << log;
+}
+
+size_t ntt_scratch_size(ULL p, size_t na, size_t nb)
+{
+    return 2 * ntt_length(p, na, nb);
+}
+
+int ntt_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+            ULL* r, ULL* scratch, ULL p)
+{
+    size_t len = ntt_length(p, na, nb);
+    if (len == 0)
+        return POL_INVALID_MODULO;
+
+    const NttTable* t = acquire_table(p, log2_len(len));
+    if (t == NULL)
+        return POL_MEMORY_ERROR;
+
+    const PolModCtx* ctx = &t->ctx;
+    const ULL* w = t->w;
+    const ULL* wi = t->w + len / 2;
+    size_t n = na + nb - 1;
+
+    ULL* fa = scratch;
+    ULL* fb = scratch + len;
+
+#ifdef _OPENMP
+    int split = len > POL_PAR_GRAIN && par_in_team();
+#endif
+    int square = (a == b && na == nb);   // возведение в квадрат — одно прямое преобразование
+
+    // преобразования множителей независимы
+    if (!square)
+    {
+        #pragma omp task if (split)
+        {
+            for (size_t i = 0; i < len; i++)
+                fb[i] = (i < nb) ? ctx_reduce(ctx, b[i]) : 0;
+            ntt_forward(fb, len, w, 1, ctx);
+        }
+    }
+
+    for (size_t i = 0; i < len; i++)
+        fa[i] = (i < na) ? ctx_reduce(ctx, a[i]) : 0;
+    ntt_forward(fa, len, w, 1, ctx);
+
+    #pragma omp taskwait
+
+    if (square)
+        fb = fa;
+
+    #pragma omp taskloop grainsize(POL_PAR_GRAIN) if (split)
+    for (size_t i = 0; i < len; i++)
+        fa[i] = ctx_mul(ctx, fa[i], fb[i]);
+
+    ntt_inverse(fa, len, wi, 1, ctx);
+
+    if (len >= n)
+    {
+        #pragma omp taskloop grainsize(POL_PAR_GRAIN) if (split)
+        for (size_t i = 0; i < n; i++)
+            r[i] = ctx_mul_prep(ctx, fa[i], t->inv_len);
+        release_table(t);
+        return POL_SUCCESS;
+    }
+
+    // Усечённая длина: fa[i] = c[i] + c[len + i], старшие c досчитываем напрямую
+    for (size_t i = 0; i < n - len; i++)
+    {
+        size_t k = len + i;
+        ULL top = 0;
+        for (size_t j = k - (nb - 1); j < na; j++)
+            top = add_mod(top, ctx_mul(ctx, ctx_reduce(ctx, a[j]), ctx_reduce(ctx, b[k - j])), p);
+        r[k] = top;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        r[i] = ctx_mul_prep(ctx, fa[i], t->inv_len);
+        if (i < n - len)
+            r[i] = sub_mod(r[i], r[len + i], p);
+    }
+
+    release_table(t);
+    return POL_SUCCESS;
+}
+
+/*--------------------- МНОГОМОДУЛЬНОЕ УМНОЖЕНИЕ ---------------------*/
+
+static void crt_init(void)
+{
+    if (atomic_load_explicit(&g_crt_ready, memory_order_acquire))
+        return;
+
+    cache_lock();
+    if (atomic_load_explicit(&g_crt_ready, memory_order_relaxed))
+    {
+        cache_unlock();
+        return;
+    }
+
+    for (size_t i = 0; i < NTT_CRT_PRIMES; i++)
+    {
+        pol_modctx_init(&g_crt_ctx[i], g_crt_primes[i]);
+        for (size_t j = 0; j < i; j++)
+            g_crt_inv[j][i] = ctx_prep(&g_crt_ctx[i],
+                                       pow_mod(g_crt_primes[j] % g_crt_primes[i],
+                                               g_crt_primes[i] - 2, g_crt_primes[i]));
+    }
+    atomic_store_explicit(&g_crt_ready, 1, memory_order_release);
+    cache_unlock();
+}
+
+static size_t crt_length(size_t na, size_t nb)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < NTT_CRT_PRIMES; i++)
+    {
+        size_t l = ntt_length(g_crt_primes[i], na, nb);
+        if (l == 0)
+            return 0;
+        if (l > len)
+            len = l;
+    }
+    return len;
+}
+
+/* Длинным произведениям — отдельный буфер преобразования на каждое простое */
+static size_t crt_channels(size_t na, size_t nb)
+{
+    size_t n_min = (na < nb) ? na : nb;
+    return (n_min > g_par_threshold) ? NTT_CRT_PRIMES : 1;
+}
+
+size_t ntt_crt_scratch_size(size_t na, size_t nb)
+{
+    size_t len = crt_length(na, nb);
+    if (len == 0)
+        return 0;
+    return crt_channels(na, nb) * 2 * len + (NTT_CRT_PRIMES - 1) * (na + nb - 1);
+}
+
+int ntt_crt_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+                ULL* r, ULL* scratch, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    size_t len = crt_length(na, nb);
+    if (len == 0)
+        return POL_INVALID_ARG;
+
+    crt_init();
+
+    // Коэффициент произведения не превосходит min(na, nb) * max(a) * max(b)
+    ULL max_a = 0, max_b = 0;
+    for (size_t i = 0; i < na; i++)
+        if (a[i] > max_a) max_a = a[i];
+    for (size_t i = 0; i < nb; i++)
+        if (b[i] > max_b) max_b = b[i];
+
+    size_t n_min = (na < nb) ? na : nb;
+    unsigned need = bit_length(max_a) + bit_length(max_b) + bit_length(n_min);
+    size_t count = (need + 60) / 61;
+    if (count == 0)
+        count = 1;
+    if (count > NTT_CRT_PRIMES)
+        return POL_INVALID_ARG;
+
+    size_t n = na + nb - 1;
+    size_t channels = crt_channels(na, nb);
+    ULL* res = scratch + channels * 2 * len;
+#ifdef _OPENMP
+    int split = channels > 1 && par_in_team();
+#endif
+
+    // при нескольких буферах умножения по разным простым идут параллельно
+    int status[NTT_CRT_PRIMES];
+    for (size_t i = 0; i < count; i++)
+    {
+        ULL* out = (i == 0) ? r : res + (i - 1) * n;
+        ULL* work = scratch + (i % channels) * 2 * len;
+
+        #pragma omp task if (split) shared(status)
+        status[i] = ntt_mul(a, na, b, nb, out, work, g_crt_primes[i]);
+    }
+
+    #pragma omp taskwait
+
+    for (size_t i = 0; i < count; i++)
+        if (status[i] != POL_SUCCESS)
+            return status[i];
+
+    // radix[i] = p_0 * ... * p_{i-1} mod m
+    ULL radix[NTT_CRT_PRIMES];
+    radix[0] = 1 % m;
+    for (size_t i = 1; i < count; i++)
+        radix[i] = mul_mod(radix[i - 1], g_crt_primes[i - 1] % m, m);
+    for (size_t i = 0; i < count; i++)
+        radix[i] = ctx_prep(ctx, radix[i]);
+
+    #pragma omp taskloop grainsize(POL_PAR_GRAIN) if (n > POL_PAR_GRAIN && par_in_team())
+    for (size_t t = 0; t < n; t++)
+    {
+        ULL v[NTT_CRT_PRIMES];
+        ULL acc = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const PolModCtx* pc = &g_crt_ctx[i];
+            ULL x = (i == 0) ? r[t] : res[(i - 1) * n + t];
+
+            for (size_t j = 0; j < i; j++)
+                x = ctx_mul_prep(pc, sub_mod(x, ctx_reduce(pc, v[j]), pc->modulo), g_crt_inv[j][i]);
+
+            v[i] = x;
+            acc = add_mod(acc, ctx_mul_prep(ctx, ctx_reduce(ctx, x), radix[i]), m);
+        }
+
+        r[t] = acc;
+    }
+
+    return POL_SUCCESS;
+}
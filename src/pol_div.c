@@ -0,0 +1,317 @@
+#include "../include/pol_div.h"
+#include "../include/pol_mul.h"
+#include "../include/pol_arith.h"
+#include "../include/ntt.h"
+#include "../include/pol_simd.h"
+#include "../include/mem_tracker.h"
+
+size_t g_newton_threshold = POL_NEWTON_THRESHOLD;
+size_t g_newton_crt_threshold = POL_NEWTON_CRT_THRESHOLD;
+
+size_t inv_series_scratch_size(size_t nf, size_t n, const PolModCtx* ctx)
+{
+    if (n <= 1)
+        return 0;
+
+    size_t need = 0;
+    for (size_t k = 1; k < n; )
+    {
+        size_t k2 = (2 * k < n) ? 2 * k : n;
+        size_t fl = (nf < k2) ? nf : k2;
+        size_t s_fg = mul_coeffs_scratch_size(fl, k, ctx);
+        size_t s_gh = mul_coeffs_scratch_size(k2 - k, k2 - k, ctx);
+        if (s_fg > need) need = s_fg;
+        if (s_gh > need) need = s_gh;
+        k = k2;
+    }
+
+    // prod: произведения длины до 2n, h: поправка длины до n
+    return 3 * n + need;
+}
+
+int inv_series_ws(const ULL* f, size_t nf, size_t n, ULL* g, ULL* scratch,
+                  const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    int status = modulo_inverse(ctx_reduce(ctx, f[0]), m, &g[0]);
+    if (status != POL_SUCCESS)
+        return POL_NO_INVERSE;
+
+    ULL* prod = scratch;
+    ULL* h = prod + 2 * n;
+    ULL* rest = h + n;
+
+    for (size_t k = 1; k < n && status == POL_SUCCESS; )
+    {
+        size_t k2 = (2 * k < n) ? 2 * k : n;
+        size_t len = k2 - k;
+        size_t fl = (nf < k2) ? nf : k2;
+
+        // f * g = 1 + x^k * h (mod x^k2)
+        status = mul_coeffs_ws(f, fl, g, k, prod, rest, ctx);
+        if (status != POL_SUCCESS)
+            break;
+        for (size_t t = 0; t < len; t++)
+            h[t] = (k + t < fl + k - 1) ? prod[k + t] : 0;
+
+        // g[k .. k2) = -(g * h) mod x^len
+        status = mul_coeffs_ws(g, len, h, len, prod, rest, ctx);
+        for (size_t t = 0; t < len; t++)
+            g[k + t] = sub_mod(0, prod[t], m);
+
+        k = k2;
+    }
+
+    return status;
+}
+
+int inv_series(const ULL* f, size_t nf, size_t n, ULL* g, const PolModCtx* ctx)
+{
+    size_t work_len = inv_series_scratch_size(nf, n, ctx);
+    if (work_len == 0)
+        return inv_series_ws(f, nf, n, g, NULL, ctx);
+
+    ULL* work = malloc(work_len * sizeof(ULL));
+    if (work == NULL)
+        return POL_MEMORY_ERROR;
+
+    int status = inv_series_ws(f, nf, n, g, work, ctx);
+
+    free(work, work_len * sizeof(ULL));
+    return status;
+}
+
+/* Деление столбиком на месте; inv — обратный к старшему коэффициенту d */
+static void rem_classic(ULL* w, size_t nw, const ULL* d, size_t nd, ULL inv,
+                        const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    for (size_t t = nw; t >= nd; t--)
+    {
+        size_t i = t - 1;
+        size_t shift = i - (nd - 1);
+        ULL coeff = ctx_mul(ctx, w[i], inv);
+        w[i] = 0;
+        if (coeff == 0)
+            continue;
+
+        ULL coeff_p = ctx_prep(ctx, coeff);
+        for (size_t j = 0; j + 1 < nd; j++)
+        {
+            ULL sub = ctx_mul_prep(ctx, ctx_reduce(ctx, d[j]), coeff_p);
+            w[shift + j] = sub_mod(w[shift + j], sub, m);
+        }
+    }
+}
+
+/* Рабочая память rem_newton: rev_d, inv, rev_w по nq; prod до 2 * nq - 1 и до nw - 1 */
+static size_t rem_newton_scratch_size(size_t nw, size_t nd, const PolModCtx* ctx)
+{
+    size_t nq = nw - nd + 1;
+    size_t nr = nd - 1;
+    size_t nd_rev = (nd < nq) ? nd : nq;
+    size_t ql = (nq < nr) ? nq : nr;
+
+    size_t prod_len = (2 * nq > nw) ? 2 * nq : nw;
+    size_t need = inv_series_scratch_size(nd_rev, nq, ctx);
+    size_t s_quo = mul_coeffs_scratch_size(nq, nq, ctx);
+    size_t s_rem = (nr > 0) ? mul_coeffs_scratch_size(ql, nr, ctx) : 0;
+    if (s_quo > need) need = s_quo;
+    if (s_rem > need) need = s_rem;
+
+    return 3 * nq + prod_len + need;
+}
+
+/* Деление через обращение перевёрнутого делителя */
+static int rem_newton(ULL* w, size_t nw, const ULL* d, size_t nd, ULL* scratch,
+                      const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+    size_t nq = nw - nd + 1;
+    size_t nr = nd - 1;
+    size_t nd_rev = (nd < nq) ? nd : nq;
+    size_t prod_len = (2 * nq > nw) ? 2 * nq : nw;
+
+    ULL* rev_d = scratch;
+    ULL* inv = rev_d + nq;
+    ULL* rev_w = inv + nq;
+    ULL* prod = rev_w + nq;
+    ULL* rest = prod + prod_len;
+
+    for (size_t i = 0; i < nd_rev; i++)
+        rev_d[i] = ctx_reduce(ctx, d[nd - 1 - i]);
+
+    int status = inv_series_ws(rev_d, nd_rev, nq, inv, rest, ctx);
+    if (status != POL_SUCCESS)
+        return status;
+
+    // rev(Q) = rev(w) * inv mod x^nq; Q кладём на место rev_d
+    for (size_t i = 0; i < nq; i++)
+        rev_w[i] = w[nw - 1 - i];
+
+    status = mul_coeffs_ws(rev_w, nq, inv, nq, prod, rest, ctx);
+    ULL* q = rev_d;
+    for (size_t i = 0; i < nq && status == POL_SUCCESS; i++)
+        q[i] = prod[nq - 1 - i];
+
+    // Остаток: w - Q * d по модулю x^nr, так что хватает младших nr членов Q и d
+    if (status == POL_SUCCESS && nr > 0)
+    {
+        size_t ql = (nq < nr) ? nq : nr;
+        status = mul_coeffs_ws(q, ql, d, nr, prod, rest, ctx);
+        for (size_t i = 0; i < nr && status == POL_SUCCESS; i++)
+            w[i] = sub_mod(w[i], prod[i], m);
+    }
+
+    for (size_t i = nr; i < nw; i++)
+        w[i] = 0;
+
+    return status;
+}
+
+size_t sparse_weight(const ULL* d, size_t nd, size_t limit, const PolModCtx* ctx)
+{
+    size_t weight = 0;
+    for (size_t j = 0; j + 1 < nd && weight <= limit; j++)
+        if (ctx_reduce(ctx, d[j]) != 0)
+            weight++;
+    return weight;
+}
+
+/* Свёртка короче этого числа членов идёт поэлементно, а не блоками */
+#define SPARSE_MIN_BLOCK 32
+
+/*
+ * Разреженный делитель: x^k = sum e_j x^j (mod d), e_j = -d_j / d_k.
+ * Блок [lo, hi) длины не больше k - j_max уходит целиком ниже lo, поэтому
+ * его можно сворачивать после того, как в него пришли все вклады сверху.
+ */
+static void rem_sparse(ULL* w, size_t nw, const ULL* d, size_t nd, ULL inv,
+                       const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+    size_t k = nd - 1;
+
+    size_t pos[POL_SPARSE_MAX_WEIGHT];
+    ULL e[POL_SPARSE_MAX_WEIGHT];
+    ULL e_prep[POL_SPARSE_MAX_WEIGHT];
+    size_t weight = 0;
+
+    for (size_t j = 0; j < k; j++)
+    {
+        ULL dj = ctx_reduce(ctx, d[j]);
+        if (dj == 0)
+            continue;
+        pos[weight] = j;
+        e[weight] = sub_mod(0, ctx_mul(ctx, dj, inv), m);
+        e_prep[weight] = ctx_prep(ctx, e[weight]);
+        weight++;
+    }
+
+    size_t block = (weight > 0) ? k - pos[weight - 1] : k;
+
+    if (block < SPARSE_MIN_BLOCK)
+    {
+        for (size_t i = nw; i-- > k; )
+        {
+            ULL c = w[i];
+            w[i] = 0;
+            if (c == 0)
+                continue;
+            for (size_t t = 0; t < weight; t++)
+            {
+                ULL* dst = &w[i - k + pos[t]];
+                *dst = add_mod(*dst, ctx_mul_prep(ctx, c, e_prep[t]), m);
+            }
+        }
+        return;
+    }
+
+    const PolVecOps* ops = pol_vec_ops();
+
+    for (size_t hi = nw; hi > k; )
+    {
+        size_t lo = (hi - k > block) ? hi - block : k;
+        size_t len = hi - lo;
+        const ULL* src = w + lo;
+
+        for (size_t t = 0; t < weight; t++)
+        {
+            ULL* dst = w + lo - k + pos[t];
+
+            // x^n - 1 и x^n + 1 (и члены с +-1) — без умножений
+            if (e[t] == 1)
+                ops->add(dst, dst, src, len, ctx);
+            else if (e[t] == m - 1)
+                ops->sub(dst, dst, src, len, ctx);
+            else
+                for (size_t i = 0; i < len; i++)
+                    dst[i] = add_mod(dst[i], ctx_mul_prep(ctx, src[i], e_prep[t]), m);
+        }
+
+        for (size_t i = lo; i < hi; i++)
+            w[i] = 0;
+        hi = lo;
+    }
+}
+
+/* Деление через обращение ряда выгоднее при длинных частном и делителе */
+static int rem_is_newton(size_t nw, size_t nd, const PolModCtx* ctx)
+{
+    size_t nq = nw - nd + 1;
+    size_t n_min = (nq < nd) ? nq : nd;
+    size_t threshold = (ntt_length(ctx->modulo, nq, nq) != 0) ? g_newton_threshold
+                                                              : g_newton_crt_threshold;
+    return n_min > threshold;
+}
+
+size_t rem_coeffs_scratch_size(size_t nw, size_t nd, const PolModCtx* ctx)
+{
+    if (nd == 0 || nw < nd || !rem_is_newton(nw, nd, ctx))
+        return 0;
+    return rem_newton_scratch_size(nw, nd, ctx);
+}
+
+int rem_coeffs_ws(ULL* w, size_t nw, const ULL* d, size_t nd, ULL* scratch,
+                  const PolModCtx* ctx)
+{
+    ULL inv;
+    if (modulo_inverse(ctx_reduce(ctx, d[nd - 1]), ctx->modulo, &inv) != POL_SUCCESS)
+        return POL_NO_INVERSE;
+
+    if (nw < nd)
+        return POL_SUCCESS;
+
+    if (sparse_weight(d, nd, POL_SPARSE_MAX_WEIGHT, ctx) <= POL_SPARSE_MAX_WEIGHT)
+    {
+        rem_sparse(w, nw, d, nd, inv, ctx);
+        return POL_SUCCESS;
+    }
+
+    if (rem_is_newton(nw, nd, ctx))
+        return rem_newton(w, nw, d, nd, scratch, ctx);
+
+    rem_classic(w, nw, d, nd, inv, ctx);
+    return POL_SUCCESS;
+}
+
+int rem_coeffs(ULL* w, size_t nw, const ULL* d, size_t nd, const PolModCtx* ctx)
+{
+    // разреженному делителю буфер не нужен, даже если длины выше порога Ньютона
+    size_t work_len = 0;
+    if (sparse_weight(d, nd, POL_SPARSE_MAX_WEIGHT, ctx) > POL_SPARSE_MAX_WEIGHT)
+        work_len = rem_coeffs_scratch_size(nw, nd, ctx);
+    if (work_len == 0)
+        return rem_coeffs_ws(w, nw, d, nd, NULL, ctx);
+
+    ULL* work = malloc(work_len * sizeof(ULL));
+    if (work == NULL)
+        return POL_MEMORY_ERROR;
+
+    int status = rem_coeffs_ws(w, nw, d, nd, work, ctx);
+
+    free(work, work_len * sizeof(ULL));
+    return status;
+}
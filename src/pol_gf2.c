@@ -0,0 +1,879 @@
+#include "../include/pol_gf2.h"
+#include "../include/pol_div.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(POL_NO_SIMD)
+#define GF2_X86 1
+#include <immintrin.h>
+#else
+#define GF2_X86 0
+#endif
+
+#include "../include/mem_tracker.h"
+
+size_t g_gf2_karatsuba_threshold = POL_GF2_KARATSUBA_THRESHOLD;
+size_t g_gf2_newton_threshold = POL_GF2_NEWTON_THRESHOLD;
+
+/* Слов для nbits коэффициентов */
+static size_t gf2_words(size_t nbits)
+{
+    return nbits / 64 + (nbits % 64 != 0);
+}
+
+/* Младшие bits бит (0 <= bits <= 64) */
+static ULL low_mask(size_t bits)
+{
+    return (bits >= 64) ? ~0ULL : (1ULL << bits) - 1;
+}
+
+/* Обнуляет биты nbits и выше в последнем слове */
+static void gf2_truncate(ULL* w, size_t nbits)
+{
+    if (nbits % 64 != 0)
+        w[nbits / 64] &= low_mask(nbits % 64);
+}
+
+/*--------------------- УМНОЖЕНИЕ СЛОВ ---------------------*/
+
+typedef void (*Gf2BaseMul)(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r);
+
+/*
+ * Кратные b для окна из 4 бит. Старшие 3 бита b отброшены, чтобы каждое
+ * кратное помещалось в слово; их вклад добавляет clmul_tab.
+ */
+static void clmul_table(ULL b, ULL tab[16])
+{
+    ULL b1 = b & (~0ULL >> 3);
+    tab[0] = 0;
+    tab[1] = b1;
+    for (int i = 2; i < 16; i += 2)
+    {
+        tab[i] = tab[i / 2] << 1;
+        tab[i + 1] = tab[i] ^ b1;
+    }
+}
+
+/* a * b без переносов: 128 бит в lo и hi */
+static inline void clmul_tab(const ULL tab[16], ULL b, ULL a, ULL* lo, ULL* hi)
+{
+    ULL l = tab[a & 15], h = 0;
+    for (int s = 4; s < 64; s += 4)
+    {
+        ULL t = tab[(a >> s) & 15];
+        l ^= t << s;
+        h ^= t >> (64 - s);
+    }
+    for (int j = 61; j < 64; j++)
+    {
+        ULL mask = 0 - ((b >> j) & 1);
+        l ^= (a << j) & mask;
+        h ^= (a >> (64 - j)) & mask;
+    }
+    *lo = l;
+    *hi = h;
+}
+
+/* Школьное умножение: r = a * b, na + nb слов */
+static void base_mul_portable(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r)
+{
+    memset(r, 0, (na + nb) * sizeof(ULL));
+    for (size_t j = 0; j < nb; j++)
+    {
+        if (b[j] == 0)
+            continue;
+
+        ULL tab[16];
+        clmul_table(b[j], tab);
+        for (size_t i = 0; i < na; i++)
+        {
+            ULL lo, hi;
+            clmul_tab(tab, b[j], a[i], &lo, &hi);
+            r[i + j] ^= lo;
+            r[i + j + 1] ^= hi;
+        }
+    }
+}
+
+#if GF2_X86
+
+#define CLMUL_FN __attribute__((target("pclmul")))
+
+static inline CLMUL_FN __m128i clmul_word(ULL a, ULL b)
+{
+    return _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a), _mm_cvtsi64_si128((long long)b), 0x00);
+}
+
+/*
+ * Школьное умножение столбцами: все произведения для слова r[k] копятся
+ * в регистре, старшая половина переходит в следующий столбец.
+ */
+static CLMUL_FN void base_mul_clmul(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r)
+{
+    __m128i carry = _mm_setzero_si128();
+    for (size_t k = 0; k + 1 < na + nb; k++)
+    {
+        size_t i0 = (k >= nb) ? k - nb + 1 : 0;
+        size_t i1 = (k < na) ? k : na - 1;
+
+        __m128i acc = carry;
+        for (size_t i = i0; i <= i1; i++)
+            acc = _mm_xor_si128(acc, clmul_word(a[i], b[k - i]));
+
+        r[k] = (ULL)_mm_cvtsi128_si64(acc);
+        carry = _mm_srli_si128(acc, 8);
+    }
+    r[na + nb - 1] = (ULL)_mm_cvtsi128_si64(carry);
+}
+
+#endif // GF2_X86
+
+static Gf2BaseMul _Atomic g_gf2_base = NULL;
+
+static int clmul_supported(void)
+{
+#if GF2_X86
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul");
+#else
+    return 0;
+#endif
+}
+
+static Gf2BaseMul gf2_base(void)
+{
+    if (g_gf2_base == NULL)
+    {
+#if GF2_X86
+        g_gf2_base = clmul_supported() ? base_mul_clmul : base_mul_portable;
+#else
+        g_gf2_base = base_mul_portable;
+#endif
+    }
+    return g_gf2_base;
+}
+
+int pol_gf2_set_clmul(int enable)
+{
+    if (!enable)
+    {
+        g_gf2_base = base_mul_portable;
+        return POL_SUCCESS;
+    }
+
+#if GF2_X86
+    if (clmul_supported())
+    {
+        g_gf2_base = base_mul_clmul;
+        return POL_SUCCESS;
+    }
+#endif
+    return POL_INVALID_ARG;
+}
+
+const char* pol_gf2_kernel(void)
+{
+    return (gf2_base() == base_mul_portable) ? "portable" : "pclmul";
+}
+
+/*--------------------- КАРАЦУБА ---------------------*/
+
+static size_t kara_base(void)
+{
+    return (g_gf2_karatsuba_threshold < 2) ? 2 : g_gf2_karatsuba_threshold;
+}
+
+/* Рабочий буфер kara_words(n): на уровне — суммы половин и их произведение */
+static size_t kara_scratch(size_t n)
+{
+    size_t s = 0;
+    while (n >= kara_base())
+    {
+        size_t k = n - n / 2;
+        s += 4 * k;
+        n = k;
+    }
+    return s;
+}
+
+/*
+ * r = a * b для множителей по n слов (2n слов результата). Над GF(2)
+ * вычитание — тот же XOR, поэтому средний член — (a0 + a1)(b0 + b1) + a0 b0 + a1 b1.
+ */
+static void kara_words(const ULL* a, const ULL* b, size_t n, ULL* r, ULL* scratch,
+                       Gf2BaseMul base)
+{
+    if (n < kara_base())
+    {
+        base(a, n, b, n, r);
+        return;
+    }
+
+    size_t h = n / 2, k = n - h;
+    kara_words(a, b, h, r, scratch, base);
+    kara_words(a + h, b + h, k, r + 2 * h, scratch, base);
+
+    ULL* sa = scratch;
+    ULL* sb = sa + k;
+    ULL* mid = sb + k;
+    for (size_t i = 0; i < k; i++)
+    {
+        sa[i] = a[h + i] ^ ((i < h) ? a[i] : 0);
+        sb[i] = b[h + i] ^ ((i < h) ? b[i] : 0);
+    }
+    kara_words(sa, sb, k, mid, mid + 2 * k, base);
+
+    for (size_t i = 0; i < 2 * k; i++)
+        mid[i] ^= r[2 * h + i] ^ ((i < 2 * h) ? r[i] : 0);
+    for (size_t i = 0; i < 2 * k; i++)
+        r[h + i] ^= mid[i];
+}
+
+/* Рабочий буфер mul_words(na, nb) */
+static size_t mul_scratch(size_t na, size_t nb)
+{
+    if (na < nb)
+    {
+        size_t t = na;
+        na = nb;
+        nb = t;
+    }
+    if (nb < kara_base())
+        return 0;
+    if (na == nb)
+        return kara_scratch(nb);
+
+    size_t s = kara_scratch(nb);
+    size_t tail = na % nb;
+    if (tail != 0)
+    {
+        size_t t = mul_scratch(nb, tail);
+        if (t > s)
+            s = t;
+    }
+    return 2 * nb + s;
+}
+
+/*
+ * r = a * b, na + nb слов. Несбалансированные множители делятся на куски
+ * длины меньшего, как в karatsuba_mul.
+ */
+static void mul_words(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                      ULL* scratch, Gf2BaseMul base)
+{
+    if (na < nb)
+    {
+        const ULL* t = a;
+        a = b;
+        b = t;
+        size_t tn = na;
+        na = nb;
+        nb = tn;
+    }
+
+    if (nb < kara_base())
+    {
+        base(a, na, b, nb, r);
+        return;
+    }
+    if (na == nb)
+    {
+        kara_words(a, b, nb, r, scratch, base);
+        return;
+    }
+
+    memset(r, 0, (na + nb) * sizeof(ULL));
+    ULL* part = scratch;
+    for (size_t off = 0; off < na; off += nb)
+    {
+        size_t len = (na - off < nb) ? na - off : nb;
+        mul_words(a + off, len, b, nb, part, scratch + 2 * nb, base);
+        for (size_t i = 0; i < len + nb; i++)
+            r[off + i] ^= part[i];
+    }
+}
+
+/* Квадрат над GF(2) — раздвижка бит: коэффициент i переходит в 2i */
+static ULL spread32(ULL x)
+{
+    x &= 0xFFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+static void sqr_words(const ULL* a, size_t n, ULL* r)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        r[2 * i] = spread32(a[i]);
+        r[2 * i + 1] = spread32(a[i] >> 32);
+    }
+}
+
+/*--------------------- ОСТАТОК ---------------------*/
+
+/* Модуль и его разреженная запись */
+typedef struct Gf2Mod
+{
+    const ULL* m;       // слова модуля
+    size_t mw;          // их число
+    size_t n;           // степень модуля
+    size_t weight;      // ненулевых членов ниже x^n; > POL_SPARSE_MAX_WEIGHT — плотный
+    size_t terms[POL_SPARSE_MAX_WEIGHT];    // их степени
+    size_t step;        // бит за одну свёртку: старшие step бит не задевают друг друга
+} Gf2Mod;
+
+static void gf2_mod_init(Gf2Mod* gm, const ULL* m, size_t n)
+{
+    gm->m = m;
+    gm->mw = n / 64 + 1;
+    gm->n = n;
+    gm->weight = 0;
+
+    size_t top = 0;     // старший из младших членов
+    for (size_t q = 0; q < gm->mw && gm->weight <= POL_SPARSE_MAX_WEIGHT; q++)
+    {
+        ULL v = m[q];
+        if (q == n / 64)
+            v &= low_mask(n % 64);
+        while (v != 0 && gm->weight <= POL_SPARSE_MAX_WEIGHT)
+        {
+            size_t bit = q * 64 + (size_t)__builtin_ctzll(v);
+            if (gm->weight < POL_SPARSE_MAX_WEIGHT)
+                gm->terms[gm->weight] = bit;
+            gm->weight++;
+            top = bit;
+            v &= v - 1;
+        }
+    }
+
+    size_t gap = n - top;   // n - 0 для x^n: любой шаг до 64 бит
+    gm->step = (gap < 64) ? gap : 64;
+}
+
+static ULL get_bits(const ULL* w, size_t pos, size_t len)
+{
+    size_t q = pos / 64, sh = pos % 64;
+    ULL v = w[q] >> sh;
+    if (sh != 0 && sh + len > 64)
+        v |= w[q + 1] << (64 - sh);
+    return v & low_mask(len);
+}
+
+static void xor_bits(ULL* w, size_t pos, ULL v, size_t len)
+{
+    size_t q = pos / 64, sh = pos % 64;
+    w[q] ^= v << sh;
+    if (sh != 0 && sh + len > 64)
+        w[q + 1] ^= v >> (64 - sh);
+}
+
+/*
+ * Разреженный модуль x^n + x^t1 + ...: блок старших бит [lo, top] длины
+ * не больше step снимается и прибавляется на позиции lo - n + ti, которые
+ * лежат ниже lo. Стоимость — O(nt / step * weight) операций над словами.
+ */
+static void rem_sparse(ULL* w, size_t nt, const Gf2Mod* gm)
+{
+    size_t n = gm->n;
+    size_t top = nt - 1;
+    for (;;)
+    {
+        size_t lo = (top - n + 1 > gm->step) ? top - gm->step + 1 : n;
+        size_t len = top - lo + 1;
+
+        ULL c = get_bits(w, lo, len);
+        if (c != 0)
+        {
+            xor_bits(w, lo, c, len);
+            for (size_t j = 0; j < gm->weight; j++)
+                xor_bits(w, lo - n + gm->terms[j], c, len);
+        }
+
+        if (lo == n)
+            break;
+        top = lo - 1;
+    }
+}
+
+/* w ^= m * x^off; ww — длина w в словах */
+static void xor_shifted(ULL* w, size_t ww, const ULL* m, size_t mw, size_t off)
+{
+    size_t q = off / 64, sh = off % 64;
+    if (sh == 0)
+    {
+        for (size_t k = 0; k < mw && q + k < ww; k++)
+            w[q + k] ^= m[k];
+        return;
+    }
+
+    for (size_t k = 0; k < mw; k++)
+    {
+        if (q + k < ww)
+            w[q + k] ^= m[k] << sh;
+        if (q + k + 1 < ww)
+            w[q + k + 1] ^= m[k] >> (64 - sh);
+    }
+}
+
+/* Деление столбиком: каждый ненулевой старший бит снимается сдвинутым модулем */
+static void rem_dense(ULL* w, size_t nt, const Gf2Mod* gm)
+{
+    size_t n = gm->n;
+    size_t ww = gf2_words(nt);
+    size_t i = nt - 1;
+    for (;;)
+    {
+        size_t q = i / 64;
+        ULL v = w[q] & low_mask(i % 64 + 1);
+        if (v == 0)
+        {
+            if (q * 64 <= n)
+                break;
+            i = q * 64 - 1;
+            continue;
+        }
+
+        size_t bit = q * 64 + 63 - (size_t)__builtin_clzll(v);
+        if (bit < n)
+            break;
+        xor_shifted(w, ww, gm->m, gm->mw, bit - n);
+        if (bit == n)
+            break;
+        i = bit - 1;
+    }
+}
+
+/* Слова, принадлежащие разворотам rev_bits */
+static void shift_right(ULL* w, size_t nw, size_t sh)
+{
+    if (sh == 0)
+        return;
+    for (size_t i = 0; i + 1 < nw; i++)
+        w[i] = (w[i] >> sh) | (w[i + 1] << (64 - sh));
+    w[nw - 1] >>= sh;
+}
+
+static ULL bitrev64(ULL x)
+{
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(x);
+}
+
+/*
+ * dst = развёрнутые биты src[pos .. pos + len): бит k dst — бит pos + len - 1 - k
+ * src. tmp — не менее gf2_words(len) + 1 слов; dst — gf2_words(len) слов.
+ */
+static void rev_bits(const ULL* src, size_t pos, size_t len, ULL* dst, ULL* tmp)
+{
+    size_t nw = gf2_words(len);
+    size_t q = pos / 64, sh = pos % 64;
+    size_t src_w = gf2_words(pos + len) - q;
+
+    // выровненная копия: бит k tmp — бит pos + k src
+    memcpy(tmp, src + q, src_w * sizeof(ULL));
+    shift_right(tmp, src_w, sh);
+    gf2_truncate(tmp, len);
+
+    for (size_t i = 0; i < nw; i++)
+        dst[i] = bitrev64(tmp[nw - 1 - i]);
+    shift_right(dst, nw, nw * 64 - len);
+}
+
+/* Рабочий буфер rem_newton для частного из nq бит и модуля из mw слов */
+static size_t newton_scratch(size_t nq, size_t mw)
+{
+    size_t wq = gf2_words(nq);
+    size_t s1 = mul_scratch(wq, wq), s2 = mul_scratch(wq, mw);
+    return 8 * wq + mw + 1 + ((s1 > s2) ? s1 : s2);
+}
+
+static int use_newton(size_t nq)
+{
+    return nq >= g_gf2_newton_threshold;
+}
+
+/*
+ * Плотный модуль большой степени: rev(Q) = rev(W) * rev(M)^(-1) mod x^nq,
+ * остаток — W + Q * M. Обращение ряда над GF(2): g <- f * g^2 удваивает
+ * точность, потому что f * (f g^2) = (f g)^2 = 1 + e^2.
+ */
+static void rem_newton(ULL* w, size_t nt, const Gf2Mod* gm, ULL* scratch, Gf2BaseMul base)
+{
+    size_t n = gm->n;
+    size_t nq = nt - n;
+    size_t wq = gf2_words(nq);
+
+    ULL* f = scratch;               // wq: rev(M) mod x^nq
+    ULL* g = f + wq;                // wq: обратный ряд
+    ULL* t1 = g + wq;               // 2 * wq
+    ULL* t2 = t1 + 2 * wq;          // 2 * wq
+    ULL* q = t2 + 2 * wq;           // wq + 1
+    ULL* qm = q + wq + 1;           // wq + mw
+    ULL* ms = qm + wq + gm->mw;
+
+    // rev(M) с точностью nq: бит k — коэффициент M при x^(n - k)
+    size_t flen = (n + 1 < nq) ? n + 1 : nq;
+    memset(f, 0, wq * sizeof(ULL));
+    rev_bits(gm->m, n + 1 - flen, flen, f, q);
+
+    memset(g, 0, wq * sizeof(ULL));
+    g[0] = 1;
+    for (size_t k = 1; k < nq; )
+    {
+        size_t k2 = (2 * k < nq) ? 2 * k : nq;
+        size_t kw = gf2_words(k), k2w = gf2_words(k2);
+
+        // биты выше k2 в f и g^2 дают только члены степени >= k2 и отбрасываются
+        memset(t1, 0, 2 * k2w * sizeof(ULL));
+        sqr_words(g, kw, t1);
+        mul_words(f, k2w, t1, k2w, t2, ms, base);
+        memcpy(g, t2, k2w * sizeof(ULL));
+        gf2_truncate(g, k2);
+        k = k2;
+    }
+
+    // rev(Q) = rev(W старшие nq бит) * g mod x^nq
+    rev_bits(w, n, nq, t1, q);
+    mul_words(t1, wq, g, wq, t2, ms, base);
+    gf2_truncate(t2, nq);
+    rev_bits(t2, 0, nq, q, t1);
+
+    // младшие n бит W + Q * M
+    mul_words(q, wq, gm->m, gm->mw, qm, ms, base);
+    size_t nw = gf2_words(n);
+    for (size_t i = 0; i < nw; i++)
+        w[i] ^= qm[i];
+    gf2_truncate(w, n);
+    memset(w + nw, 0, (gf2_words(nt) - nw) * sizeof(ULL));
+}
+
+/* Рабочий буфер gf2_rem(nt, mw) в худшем (плотном) случае */
+static size_t rem_scratch(size_t nt, size_t n)
+{
+    if (nt <= n || n == 0)
+        return 0;
+    return use_newton(nt - n) ? newton_scratch(nt - n, n / 64 + 1) : 0;
+}
+
+/* w = w mod M на месте; на выходе биты n и выше обнулены */
+static void gf2_rem(ULL* w, size_t nt, const Gf2Mod* gm, ULL* scratch, Gf2BaseMul base)
+{
+    size_t n = gm->n;
+    if (nt <= n)
+        return;
+
+    if (n == 0)
+    {
+        memset(w, 0, gf2_words(nt) * sizeof(ULL));
+        return;
+    }
+
+    // свёртка блоками дешевле деления столбиком (около mw / 2 слов на бит)
+    if (gm->weight <= POL_SPARSE_MAX_WEIGHT && 2 * (gm->weight + 2) < gm->step * (gm->mw + 1))
+        rem_sparse(w, nt, gm);
+    else if (use_newton(nt - n))
+        rem_newton(w, nt, gm, scratch, base);
+    else
+        rem_dense(w, nt, gm);
+}
+
+/*--------------------- МАССИВЫ КОЭФФИЦИЕНТОВ ---------------------*/
+
+/* Тетрада бит -> четыре коэффициента */
+static const ULL NIBBLE_COEFFS[16][4] =
+{
+    { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 1, 1, 0, 0 },
+    { 0, 0, 1, 0 }, { 1, 0, 1, 0 }, { 0, 1, 1, 0 }, { 1, 1, 1, 0 },
+    { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 1, 1, 0, 1 },
+    { 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 0, 1, 1, 1 }, { 1, 1, 1, 1 }
+};
+
+/* 64 коэффициента -> слово */
+static ULL pack_word(const ULL* p)
+{
+#if GF2_X86
+    // младший бит в знаковый, по два коэффициента за movmskpd (SSE2 есть всегда)
+#define PACK2(k) ((unsigned)_mm_movemask_pd(_mm_castsi128_pd( \
+        _mm_slli_epi64(_mm_loadu_si128((const __m128i*)(p + i + (k))), 63))) << (k))
+    ULL w = 0;
+    for (int i = 0; i < 64; i += 8)
+        w |= (ULL)(PACK2(0) | PACK2(2) | PACK2(4) | PACK2(6)) << i;
+    return w;
+#undef PACK2
+#else
+    // четыре независимые цепочки OR вместо одной
+    ULL w0 = 0, w1 = 0, w2 = 0, w3 = 0;
+    for (int i = 0; i < 64; i += 4)
+    {
+        w0 |= (p[i] & 1) << i;
+        w1 |= (p[i + 1] & 1) << (i + 1);
+        w2 |= (p[i + 2] & 1) << (i + 2);
+        w3 |= (p[i + 3] & 1) << (i + 3);
+    }
+    return w0 | w1 | w2 | w3;
+#endif
+}
+
+void pol_gf2_pack(const ULL* c, size_t n, ULL* words)
+{
+    size_t full = n / 64;
+    for (size_t q = 0; q < full; q++)
+        words[q] = pack_word(c + 64 * q);
+
+    if (n % 64 != 0)
+    {
+        ULL w = 0;
+        for (size_t i = 0; i < n % 64; i++)
+            w |= (c[64 * full + i] & 1) << i;
+        words[full] = w;
+    }
+}
+
+void pol_gf2_unpack(const ULL* words, size_t n, ULL* c)
+{
+    size_t full = n / 64;
+    for (size_t q = 0; q < full; q++)
+    {
+        ULL w = words[q];
+        for (int j = 0; j < 16; j++)
+            memcpy(c + 64 * q + 4 * j, NIBBLE_COEFFS[(w >> (4 * j)) & 15], sizeof(NIBBLE_COEFFS[0]));
+    }
+
+    for (size_t i = 64 * full; i < n; i++)
+        c[i] = (words[full] >> (i % 64)) & 1;
+}
+
+size_t pol_gf2_mul_mod_coeffs_scratch_size(size_t na, size_t nb, size_t nm)
+{
+    size_t aw = gf2_words(na), bw = gf2_words(nb), mw = gf2_words(nm);
+    size_t s_mul = mul_scratch(aw, bw);
+    size_t s_rem = rem_scratch(na + nb - 1, nm - 1);
+
+    return aw + bw + mw + (aw + bw) + ((s_mul > s_rem) ? s_mul : s_rem);
+}
+
+const ULL* pol_gf2_mul_mod_coeffs(const ULL* a, size_t na, const ULL* b, size_t nb,
+                                  const ULL* m, size_t nm, ULL* scratch)
+{
+    size_t aw = gf2_words(na), bw = gf2_words(nb), mw = gf2_words(nm);
+    ULL* pa = scratch;
+    ULL* pb = pa + aw;
+    ULL* pm = pb + bw;
+    ULL* t = pm + mw;
+    ULL* rest = t + aw + bw;
+
+    pol_gf2_pack(a, na, pa);
+    pol_gf2_pack(b, nb, pb);
+    pol_gf2_pack(m, nm, pm);
+
+    Gf2BaseMul base = gf2_base();
+    mul_words(pa, aw, pb, bw, t, rest, base);
+
+    Gf2Mod gm;
+    gf2_mod_init(&gm, pm, nm - 1);
+    gf2_rem(t, na + nb - 1, &gm, rest, base);
+    return t;
+}
+
+/*--------------------- УПАКОВАННЫЕ МНОГОЧЛЕНЫ ---------------------*/
+
+/* Не меньше words слов; прежние коэффициенты сохраняются */
+static int gf2_reserve(PolGF2* P, size_t words)
+{
+    if (P->words != NULL && P->capacity >= words)
+        return POL_SUCCESS;
+
+    ULL* fresh = calloc(words, sizeof(ULL));
+    if (fresh == NULL)
+        return POL_MEMORY_ERROR;
+
+    if (P->words != NULL)
+    {
+        memcpy(fresh, P->words, POL_GF2_WORDS(P->degree) * sizeof(ULL));
+        free(P->words, P->capacity * sizeof(ULL));
+    }
+    P->words = fresh;
+    P->capacity = words;
+    return POL_SUCCESS;
+}
+
+/* Заменяет буфер P на fresh из cap слов */
+static void gf2_adopt(PolGF2* P, ULL* fresh, size_t cap)
+{
+    if (P->words != NULL)
+        free(P->words, P->capacity * sizeof(ULL));
+    P->words = fresh;
+    P->capacity = cap;
+}
+
+/* Степень по старшему ненулевому биту первых nw слов */
+static void gf2_normalize(PolGF2* P, size_t nw)
+{
+    while (nw > 1 && P->words[nw - 1] == 0)
+        nw--;
+
+    ULL top = P->words[nw - 1];
+    P->degree = (top == 0) ? 0 : (nw - 1) * 64 + 63 - (size_t)__builtin_clzll(top);
+}
+
+int pol_gf2_new(PolGF2* P, size_t degree)
+{
+    if (P == NULL)
+        return POL_NULL_PTR;
+
+    P->words = NULL;
+    P->capacity = 0;
+    P->degree = 0;
+    return gf2_reserve(P, POL_GF2_WORDS(degree));
+}
+
+void pol_gf2_free(PolGF2* P)
+{
+    if (P == NULL || P->words == NULL)
+        return;
+
+    free(P->words, P->capacity * sizeof(ULL));
+    P->words = NULL;
+    P->capacity = 0;
+    P->degree = 0;
+}
+
+int pol_gf2_from_pol(const Polynomial* A, PolGF2* P)
+{
+    if (A == NULL || P == NULL || A->coeffs == NULL)
+        return POL_NULL_PTR;
+
+    if (A->modulo != 2)
+        return POL_INVALID_MODULO;
+
+    size_t nw = POL_GF2_WORDS(A->degree);
+    if (gf2_reserve(P, nw) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    pol_gf2_pack(A->coeffs, A->degree + 1, P->words);
+    gf2_normalize(P, nw);
+    return POL_SUCCESS;
+}
+
+int pol_gf2_to_pol(const PolGF2* P, Polynomial* R)
+{
+    if (P == NULL || R == NULL || P->words == NULL)
+        return POL_NULL_PTR;
+
+    if (realloc_coeffs(R, P->degree) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    pol_gf2_unpack(P->words, P->degree + 1, R->coeffs);
+    set_pol_params(R, P->degree, 2);
+    return POL_SUCCESS;
+}
+
+int pol_gf2_add(const PolGF2* A, const PolGF2* B, PolGF2* R)
+{
+    if (A == NULL || B == NULL || R == NULL || A->words == NULL || B->words == NULL)
+        return POL_NULL_PTR;
+
+    size_t aw = POL_GF2_WORDS(A->degree), bw = POL_GF2_WORDS(B->degree);
+    size_t nw = (aw > bw) ? aw : bw;
+
+    // при R == A или R == B перевыделение сохраняет коэффициенты
+    if (gf2_reserve(R, nw) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    const ULL* a = A->words;
+    const ULL* b = B->words;
+    for (size_t i = 0; i < nw; i++)
+        R->words[i] = ((i < aw) ? a[i] : 0) ^ ((i < bw) ? b[i] : 0);
+
+    gf2_normalize(R, nw);
+    return POL_SUCCESS;
+}
+
+int pol_gf2_mul(const PolGF2* A, const PolGF2* B, PolGF2* R)
+{
+    if (A == NULL || B == NULL || R == NULL || A->words == NULL || B->words == NULL)
+        return POL_NULL_PTR;
+
+    size_t aw = POL_GF2_WORDS(A->degree), bw = POL_GF2_WORDS(B->degree);
+    size_t ns = mul_scratch(aw, bw);
+
+    ULL* t = malloc((aw + bw) * sizeof(ULL));
+    ULL* scratch = (ns > 0) ? malloc(ns * sizeof(ULL)) : NULL;
+    if (t == NULL || (ns > 0 && scratch == NULL))
+    {
+        if (t != NULL) free(t, (aw + bw) * sizeof(ULL));
+        if (scratch != NULL) free(scratch, ns * sizeof(ULL));
+        return POL_MEMORY_ERROR;
+    }
+
+    mul_words(A->words, aw, B->words, bw, t, scratch, gf2_base());
+
+    if (scratch != NULL)
+        free(scratch, ns * sizeof(ULL));
+    gf2_adopt(R, t, aw + bw);
+    gf2_normalize(R, aw + bw);
+    return POL_SUCCESS;
+}
+
+/* R = (T mod M) для T из nt бит в буфере t из tw слов; t переходит к R */
+static int gf2_finish_rem(ULL* t, size_t tw, size_t nt, const PolGF2* M, PolGF2* R)
+{
+    Gf2Mod gm;
+    gf2_mod_init(&gm, M->words, M->degree);
+
+    size_t ns = rem_scratch(nt, M->degree);
+    ULL* scratch = (ns > 0) ? malloc(ns * sizeof(ULL)) : NULL;
+    if (ns > 0 && scratch == NULL)
+    {
+        free(t, tw * sizeof(ULL));
+        return POL_MEMORY_ERROR;
+    }
+
+    gf2_rem(t, nt, &gm, scratch, gf2_base());
+
+    if (scratch != NULL)
+        free(scratch, ns * sizeof(ULL));
+    gf2_adopt(R, t, tw);
+    gf2_normalize(R, tw);
+    return POL_SUCCESS;
+}
+
+int pol_gf2_rem(const PolGF2* A, const PolGF2* M, PolGF2* R)
+{
+    if (A == NULL || M == NULL || R == NULL || A->words == NULL || M->words == NULL)
+        return POL_NULL_PTR;
+
+    if (M->degree == 0 && M->words[0] == 0)
+        return POL_ZERO_DIV;
+
+    size_t aw = POL_GF2_WORDS(A->degree);
+    ULL* t = malloc(aw * sizeof(ULL));
+    if (t == NULL)
+        return POL_MEMORY_ERROR;
+
+    memcpy(t, A->words, aw * sizeof(ULL));
+    return gf2_finish_rem(t, aw, A->degree + 1, M, R);
+}
+
+int pol_gf2_mul_mod(const PolGF2* A, const PolGF2* B, const PolGF2* M, PolGF2* R)
+{
+    if (A == NULL || B == NULL || M == NULL || R == NULL ||
+        A->words == NULL || B->words == NULL || M->words == NULL)
+        return POL_NULL_PTR;
+
+    if (M->degree == 0 && M->words[0] == 0)
+        return POL_ZERO_DIV;
+
+    // R может совпадать с M: произведение копится в отдельном буфере до конца
+    PolGF2 T = { NULL, 0, 0 };
+    int status = pol_gf2_mul(A, B, &T);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return gf2_finish_rem(T.words, T.capacity, A->degree + B->degree + 1, M, R);
+}
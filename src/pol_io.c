@@ -0,0 +1,383 @@
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define POL_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define POL_HAVE_MMAP 0
+#endif
+
+#include "../include/pol_io.h"
+#include "../include/mem_tracker.h"
+
+/* Коэффициентов в буфере упаковки и распаковки */
+#define BIN_CHUNK 4096
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BIN_HOST_LE 1
+#else
+#define BIN_HOST_LE 0
+#endif
+
+static void put_le(unsigned char* p, ULL v, int width)
+{
+    for (int i = 0; i < width; i++)
+        p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static ULL get_le(const unsigned char* p, int width)
+{
+    ULL v = 0;
+    for (int i = 0; i < width; i++)
+        v |= (ULL)p[i] << (8 * i);
+    return v;
+}
+
+/* Наименьшая ширина из 1, 2, 4, 8 байт, вмещающая max */
+static int bin_width_for(ULL max)
+{
+    if (max <= 0xFFULL) return 1;
+    if (max <= 0xFFFFULL) return 2;
+    if (max <= 0xFFFFFFFFULL) return 4;
+    return 8;
+}
+
+static int bin_check_width(int width)
+{
+    return width == 1 || width == 2 || width == 4 || width == 8;
+}
+
+static void bin_make_header(unsigned char* h, const Polynomial* P, int width)
+{
+    memset(h, 0, POL_BIN_HEADER_SIZE);
+    memcpy(h, POL_BIN_MAGIC, 4);
+    put_le(h + 4, POL_BIN_VERSION, 2);
+    h[6] = (unsigned char)width;
+    put_le(h + 8, P->modulo, 8);
+    put_le(h + 16, P->degree, 8);
+}
+
+static int bin_parse_header(const unsigned char* h, ULL* modulo, size_t* degree, int* width)
+{
+    if (memcmp(h, POL_BIN_MAGIC, 4) != 0 || get_le(h + 4, 2) != POL_BIN_VERSION || h[7] != 0)
+        return POL_SYNTAX_ERROR;
+
+    *width = h[6];
+    if (!bin_check_width(*width))
+        return POL_SYNTAX_ERROR;
+
+    *modulo = get_le(h + 8, 8);
+    if (*modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    // degree + 1 коэффициентов вместе с заголовком должны адресоваться size_t
+    ULL deg = get_le(h + 16, 8);
+    if (deg >= (SIZE_MAX - POL_BIN_HEADER_SIZE) / (size_t)*width)
+        return POL_SYNTAX_ERROR;
+
+    *degree = (size_t)deg;
+    return POL_SUCCESS;
+}
+
+/* Распаковка n коэффициентов; 0 — встретился коэффициент >= modulo */
+static int bin_unpack(const unsigned char* src, int width, ULL modulo, ULL* dst, size_t n)
+{
+    ULL bad = 0;
+    if (BIN_HOST_LE && width == 4)
+    {
+        // частый случай (modulo < 2^32): чтение словами вместо побайтовой сборки
+        for (size_t i = 0; i < n; i++)
+        {
+            uint32_t v;
+            memcpy(&v, src + 4 * i, 4);
+            dst[i] = v;
+            bad |= (dst[i] >= modulo);
+        }
+        return bad == 0;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] = get_le(src + i * (size_t)width, width);
+        bad |= (dst[i] >= modulo);
+    }
+    return bad == 0;
+}
+
+static int bin_check_range(const ULL* c, size_t n, ULL modulo)
+{
+    ULL bad = 0;
+    for (size_t i = 0; i < n; i++)
+        bad |= (c[i] >= modulo);
+    return bad == 0;
+}
+
+/* При ошибке в данных P остаётся нулевым многочленом */
+static int bin_read_fail(Polynomial* P, ULL modulo, int status)
+{
+    set_pol_params(P, 0, modulo);
+    P->coeffs[0] = 0;
+    return status;
+}
+
+int pol_write_bin(FILE* f, const Polynomial* P, int width)
+{
+    if (f == NULL || P == NULL || P->coeffs == NULL)
+        return POL_NULL_PTR;
+
+    if (P->modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    int need = bin_width_for(P->modulo - 1);
+    if (width == 0)
+        width = need;
+    if (!bin_check_width(width) || width < need)
+        return POL_INVALID_ARG;
+
+    // проверка до записи: неприведённый коэффициент не должен оставить полфайла
+    size_t n = P->degree + 1;
+    if (!bin_check_range(P->coeffs, n, P->modulo))
+        return POL_INVALID_ARG;
+
+    unsigned char header[POL_BIN_HEADER_SIZE];
+    bin_make_header(header, P, width);
+    if (fwrite(header, 1, sizeof(header), f) != sizeof(header))
+        return POL_IO_ERROR;
+
+    unsigned char buf[BIN_CHUNK * sizeof(ULL)];
+
+    for (size_t at = 0; at < n; at += BIN_CHUNK)
+    {
+        size_t len = (n - at < BIN_CHUNK) ? n - at : BIN_CHUNK;
+        const ULL* c = P->coeffs + at;
+
+        // родной порядок байт совпадает с форматом: пишем без упаковки
+        const void* out = c;
+        if (BIN_HOST_LE && width == 4)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                uint32_t v = (uint32_t)c[i];
+                memcpy(buf + 4 * i, &v, 4);
+            }
+            out = buf;
+        }
+        else if (!(BIN_HOST_LE && width == 8))
+        {
+            for (size_t i = 0; i < len; i++)
+                put_le(buf + i * (size_t)width, c[i], width);
+            out = buf;
+        }
+
+        if (fwrite(out, (size_t)width, len, f) != len)
+            return POL_IO_ERROR;
+    }
+
+    return POL_SUCCESS;
+}
+
+int pol_save_bin(const char* path, const Polynomial* P, int width)
+{
+    if (path == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+        return POL_IO_ERROR;
+
+    int status = pol_write_bin(f, P, width);
+    if (fclose(f) != 0 && status == POL_SUCCESS)
+        status = POL_IO_ERROR;
+
+    // недописанный файл с верным заголовком хуже, чем никакого
+    if (status != POL_SUCCESS)
+        remove(path);
+    return status;
+}
+
+int pol_read_bin(FILE* f, Polynomial* P)
+{
+    if (f == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    unsigned char header[POL_BIN_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header))
+        return ferror(f) ? POL_IO_ERROR : POL_SYNTAX_ERROR;
+
+    ULL modulo;
+    size_t degree;
+    int width;
+    int status = bin_parse_header(header, &modulo, &degree, &width);
+    if (status != POL_SUCCESS)
+        return status;
+
+    // у файла остаток известен: оборванные данные не приводят к выделению по заголовку
+    long pos = ftell(f);
+    if (pos >= 0 && fseek(f, 0, SEEK_END) == 0)
+    {
+        long end = ftell(f);
+        if (fseek(f, pos, SEEK_SET) != 0)
+            return POL_IO_ERROR;
+        if (end >= pos && (ULL)(end - pos) / (ULL)width < (ULL)degree + 1)
+            return POL_IO_ERROR;
+    }
+    clearerr(f);
+
+    if (realloc_coeffs(P, degree) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    unsigned char buf[BIN_CHUNK * sizeof(ULL)];
+    size_t n = degree + 1;
+
+    for (size_t at = 0; at < n; at += BIN_CHUNK)
+    {
+        size_t len = (n - at < BIN_CHUNK) ? n - at : BIN_CHUNK;
+        ULL* c = P->coeffs + at;
+
+        int ok;
+        if (BIN_HOST_LE && width == 8)
+        {
+            if (fread(c, sizeof(ULL), len, f) != len)
+                return bin_read_fail(P, modulo, POL_IO_ERROR);
+            ok = bin_check_range(c, len, modulo);
+        }
+        else
+        {
+            if (fread(buf, (size_t)width, len, f) != len)
+                return bin_read_fail(P, modulo, POL_IO_ERROR);
+            ok = bin_unpack(buf, width, modulo, c, len);
+        }
+
+        if (!ok)
+            return bin_read_fail(P, modulo, POL_SYNTAX_ERROR);
+    }
+
+    set_pol_params(P, degree, modulo);
+    return POL_SUCCESS;
+}
+
+int pol_load_bin(const char* path, Polynomial* P)
+{
+    if (path == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return POL_IO_ERROR;
+
+    int status = pol_read_bin(f, P);
+    fclose(f);
+    return status;
+}
+
+#if POL_HAVE_MMAP
+
+int pol_map_bin(const char* path, PolMapping* map, Polynomial* P)
+{
+    if (path == NULL || map == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    map->addr = NULL;
+    map->size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return POL_IO_ERROR;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return POL_IO_ERROR;
+    }
+    if ((ULL)st.st_size < POL_BIN_HEADER_SIZE || (ULL)st.st_size > SIZE_MAX)
+    {
+        close(fd);
+        return POL_SYNTAX_ERROR;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return POL_IO_ERROR;
+
+    const unsigned char* bytes = addr;
+    ULL modulo;
+    size_t degree;
+    int width;
+    int status = bin_parse_header(bytes, &modulo, &degree, &width);
+    if (status == POL_SUCCESS && (size - POL_BIN_HEADER_SIZE) / (size_t)width < degree + 1)
+        status = POL_IO_ERROR;
+    else if (status == POL_SUCCESS && size != POL_BIN_HEADER_SIZE + (degree + 1) * (size_t)width)
+        status = POL_SYNTAX_ERROR;
+
+    if (status == POL_SUCCESS && BIN_HOST_LE && width == 8)
+    {
+        ULL* coeffs = (ULL*)(void*)(bytes + POL_BIN_HEADER_SIZE);
+        if (!bin_check_range(coeffs, degree + 1, modulo))
+        {
+            status = POL_SYNTAX_ERROR;
+        }
+        else
+        {
+            // коэффициенты остаются в отображении: P их только заимствует
+            free_pol(P);
+            P->coeffs = coeffs;
+            P->capacity = 0;
+            set_pol_params(P, degree, modulo);
+
+            map->addr = addr;
+            map->size = size;
+            return POL_SUCCESS;
+        }
+    }
+    else if (status == POL_SUCCESS)
+    {
+        if (realloc_coeffs(P, degree) != POL_SUCCESS)
+            status = POL_MEMORY_ERROR;
+        else if (!bin_unpack(bytes + POL_BIN_HEADER_SIZE, width, modulo, P->coeffs, degree + 1))
+            status = bin_read_fail(P, modulo, POL_SYNTAX_ERROR);
+        else
+            set_pol_params(P, degree, modulo);
+    }
+
+    munmap(addr, size);
+    return status;
+}
+
+void pol_unmap_bin(PolMapping* map)
+{
+    if (map == NULL || map->addr == NULL)
+        return;
+
+    munmap(map->addr, map->size);
+    map->addr = NULL;
+    map->size = 0;
+}
+
+#else
+
+int pol_map_bin(const char* path, PolMapping* map, Polynomial* P)
+{
+    if (path == NULL || map == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    map->addr = NULL;
+    map->size = 0;
+    return pol_load_bin(path, P);
+}
+
+void pol_unmap_bin(PolMapping* map)
+{
+    if (map != NULL)
+    {
+        map->addr = NULL;
+        map->size = 0;
+    }
+}
+
+#endif
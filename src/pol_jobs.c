@@ -0,0 +1,345 @@
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../include/pol_jobs.h"
+#include "../include/string_utils.h"
+#include "../include/mem_tracker.h"
+
+/* Буфер записи: короткие результаты форматируются в него целиком */
+#define JOBS_OUT_BUF 65536
+
+enum JobState
+{
+    JOB_FREE = 0,   // ячейка свободна
+    JOB_PARSED,     // разобрано, ждёт вычисления
+    JOB_DONE        // вычислено (или ошибка), ждёт записи
+};
+
+typedef struct JobSlot
+{
+    Polynomial A, B, M, R;
+    int status;     // код разбора, затем вычисления
+    int state;      // значение из JobState
+} JobSlot;
+
+/*
+ * Кольцо заданий. Номера растут монотонно: written <= taken <= parsed,
+ * parsed - written <= size; задание seq лежит в ячейке seq % size.
+ */
+typedef struct JobRing
+{
+    JobSlot* slots;
+    size_t size;
+    size_t parsed;      // заданий разобрано
+    size_t taken;       // заданий взято на вычисление
+    size_t written;     // заданий записано
+    int input_done;     // разбор закончен
+    int fatal;          // код ошибки, останавливающей конвейер
+    pthread_mutex_t lock;
+    pthread_cond_t can_parse;
+    pthread_cond_t can_compute;
+    pthread_cond_t can_write;
+
+    PolReader reader;
+    ULL modulo;
+    int serial_workers; // вычисляющих потоков несколько: без OpenMP внутри задания
+} JobRing;
+
+static double jobs_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Останавливает все стадии (под блокировкой) */
+static void ring_fail(JobRing* ring, int status)
+{
+    if (ring->fatal == POL_SUCCESS)
+        ring->fatal = status;
+    pthread_cond_broadcast(&ring->can_parse);
+    pthread_cond_broadcast(&ring->can_compute);
+    pthread_cond_broadcast(&ring->can_write);
+}
+
+/* Разбор одной строки в ячейку; POL_IO_ERROR — вход больше читать нельзя */
+static int parse_job(JobRing* ring, JobSlot* slot)
+{
+    PolReader* rd = &ring->reader;
+
+    int status = pol_reader_next(rd, ring->modulo, &slot->A);
+    if (status == POL_SUCCESS) status = pol_reader_next(rd, ring->modulo, &slot->B);
+    if (status == POL_SUCCESS) status = pol_reader_next(rd, ring->modulo, &slot->M);
+    if (status == POL_IO_ERROR)
+        return status;
+
+    // остаток строки: после трёх многочленов допустимы только пробелы
+    int tail = pol_reader_end_line(rd);
+    if (tail == POL_IO_ERROR)
+        return tail;
+
+    slot->status = (status != POL_SUCCESS) ? status : tail;
+    return POL_SUCCESS;
+}
+
+static void* parse_stage(void* arg)
+{
+    JobRing* ring = arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ring->lock);
+        while (ring->fatal == POL_SUCCESS && ring->parsed - ring->written == ring->size)
+            pthread_cond_wait(&ring->can_parse, &ring->lock);
+        JobSlot* slot = &ring->slots[ring->parsed % ring->size];
+        int stop = ring->fatal != POL_SUCCESS;
+        pthread_mutex_unlock(&ring->lock);
+
+        if (stop)
+            break;
+
+        // ячейка принадлежит разбору, пока parsed не увеличен
+        int status = POL_SUCCESS;
+        int last = pol_reader_at_end(&ring->reader);
+        if (last)
+            status = ring->reader.error ? POL_IO_ERROR : POL_SUCCESS;
+        else
+            status = parse_job(ring, slot);
+
+        pthread_mutex_lock(&ring->lock);
+        if (status != POL_SUCCESS)
+        {
+            ring_fail(ring, status);
+        }
+        else if (last)
+        {
+            ring->input_done = 1;
+            pthread_cond_broadcast(&ring->can_compute);
+            pthread_cond_signal(&ring->can_write);
+        }
+        else
+        {
+            slot->state = JOB_PARSED;
+            ring->parsed++;
+            pthread_cond_signal(&ring->can_compute);
+        }
+        pthread_mutex_unlock(&ring->lock);
+
+        if (status != POL_SUCCESS || last)
+            break;
+    }
+    return NULL;
+}
+
+static void* compute_stage(void* arg)
+{
+    JobRing* ring = arg;
+
+#ifdef _OPENMP
+    // параллельность — между заданиями; вложенные команды OpenMP лишь мешали бы
+    if (ring->serial_workers)
+        omp_set_num_threads(1);
+#endif
+
+    PolModCtx ctx;
+    PolWorkspace ws;
+    pol_modctx_init(&ctx, ring->modulo);
+    pol_ws_init(&ws, 0);
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ring->lock);
+        while (ring->fatal == POL_SUCCESS && ring->taken == ring->parsed && !ring->input_done)
+            pthread_cond_wait(&ring->can_compute, &ring->lock);
+        if (ring->fatal != POL_SUCCESS || ring->taken == ring->parsed)
+        {
+            pthread_mutex_unlock(&ring->lock);
+            break;
+        }
+        size_t seq = ring->taken++;
+        JobSlot* slot = &ring->slots[seq % ring->size];
+        pthread_mutex_unlock(&ring->lock);
+
+        if (slot->status == POL_SUCCESS)
+            slot->status = pol_mul_mod_unit_ws(&slot->A, &slot->B, &slot->M, &slot->R, &ws, &ctx);
+
+        pthread_mutex_lock(&ring->lock);
+        slot->state = JOB_DONE;
+        if (seq == ring->written)
+            pthread_cond_signal(&ring->can_write);
+        pthread_mutex_unlock(&ring->lock);
+    }
+
+    pol_ws_free(&ws);
+    return NULL;
+}
+
+/* Строка результата; короткие собираются в буфере и пишутся одним fwrite */
+static int write_job(FILE* out, const JobSlot* slot, char* buf)
+{
+    if (slot->status != POL_SUCCESS)
+        return (fprintf(out, "error %d\n", slot->status) < 0) ? POL_IO_ERROR : POL_SUCCESS;
+
+    size_t len;
+    if (pol_str_bound(&slot->R) < JOBS_OUT_BUF &&
+        pol_to_str_buf(&slot->R, buf, JOBS_OUT_BUF - 1, &len) == POL_SUCCESS)
+    {
+        buf[len++] = '\n';
+        return (fwrite(buf, 1, len, out) == len) ? POL_SUCCESS : POL_IO_ERROR;
+    }
+
+    int status = pol_write_str(out, &slot->R);
+    if (status == POL_SUCCESS && fputc('\n', out) == EOF)
+        status = POL_IO_ERROR;
+    return status;
+}
+
+static int online_cpus(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0)
+        return (int)n;
+#endif
+    return 1;
+}
+
+int pol_jobs_run(FILE* in, FILE* out, const PolJobsConfig* cfg, PolJobsStats* stats)
+{
+    if (in == NULL || out == NULL || cfg == NULL)
+        return POL_NULL_PTR;
+
+    if (stats != NULL)
+        memset(stats, 0, sizeof(*stats));
+
+    if (cfg->modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    double start = jobs_now();
+    int workers = (cfg->workers > 0) ? cfg->workers : online_cpus();
+    size_t size = (cfg->queue > 0) ? cfg->queue : (size_t)workers * POL_JOBS_QUEUE_PER_WORKER;
+
+    JobRing ring;
+    memset(&ring, 0, sizeof(ring));
+    ring.size = size;
+    ring.modulo = cfg->modulo;
+    ring.serial_workers = workers > 1;
+
+    ring.slots = calloc(size, sizeof(JobSlot));
+    char* buf = malloc(JOBS_OUT_BUF);
+    pthread_t* threads = calloc((size_t)workers + 1, sizeof(pthread_t));
+    int status = (ring.slots && buf && threads) ? POL_SUCCESS : POL_MEMORY_ERROR;
+
+    if (status == POL_SUCCESS)
+        status = pol_reader_init(&ring.reader, in);
+
+    // буферы ячеек сразу выделены: многочлены разбираются в них повторно
+    for (size_t i = 0; i < size && status == POL_SUCCESS; i++)
+    {
+        JobSlot* s = &ring.slots[i];
+        status = new_pol(&s->A, 0, cfg->modulo);
+        if (status == POL_SUCCESS) status = new_pol(&s->B, 0, cfg->modulo);
+        if (status == POL_SUCCESS) status = new_pol(&s->M, 0, cfg->modulo);
+        if (status == POL_SUCCESS) status = new_pol(&s->R, 0, cfg->modulo);
+    }
+
+    size_t started = 0;
+    if (status == POL_SUCCESS)
+    {
+        pthread_mutex_init(&ring.lock, NULL);
+        pthread_cond_init(&ring.can_parse, NULL);
+        pthread_cond_init(&ring.can_compute, NULL);
+        pthread_cond_init(&ring.can_write, NULL);
+
+        if (pthread_create(&threads[started], NULL, parse_stage, &ring) == 0)
+            started++;
+        for (int w = 0; w < workers && started == (size_t)w + 1; w++)
+        {
+            if (pthread_create(&threads[started], NULL, compute_stage, &ring) == 0)
+                started++;
+        }
+
+        pthread_mutex_lock(&ring.lock);
+        if (started != (size_t)workers + 1)
+            ring_fail(&ring, POL_IO_ERROR);
+        pthread_mutex_unlock(&ring.lock);
+
+        // стадия записи — в вызывающем потоке
+        size_t failed = 0;
+        for (;;)
+        {
+            pthread_mutex_lock(&ring.lock);
+            JobSlot* slot = &ring.slots[ring.written % size];
+            while (ring.fatal == POL_SUCCESS &&
+                   !(ring.written < ring.parsed && slot->state == JOB_DONE) &&
+                   !(ring.input_done && ring.written == ring.parsed))
+                pthread_cond_wait(&ring.can_write, &ring.lock);
+            int stop = ring.fatal != POL_SUCCESS || ring.written == ring.parsed;
+            pthread_mutex_unlock(&ring.lock);
+
+            if (stop)
+                break;
+
+            int written = write_job(out, slot, buf);
+            failed += (slot->status != POL_SUCCESS);
+
+            pthread_mutex_lock(&ring.lock);
+            if (written != POL_SUCCESS)
+            {
+                ring_fail(&ring, written);
+            }
+            else
+            {
+                slot->state = JOB_FREE;
+                ring.written++;
+                pthread_cond_signal(&ring.can_parse);
+            }
+            pthread_mutex_unlock(&ring.lock);
+        }
+
+        for (size_t t = 0; t < started; t++)
+            pthread_join(threads[t], NULL);
+
+        status = ring.fatal;
+        if (status == POL_SUCCESS && fflush(out) != 0)
+            status = POL_IO_ERROR;
+
+        if (stats != NULL)
+        {
+            stats->jobs = ring.written;
+            stats->failed = failed;
+            stats->workers = workers;
+        }
+
+        pthread_cond_destroy(&ring.can_write);
+        pthread_cond_destroy(&ring.can_compute);
+        pthread_cond_destroy(&ring.can_parse);
+        pthread_mutex_destroy(&ring.lock);
+    }
+
+    pol_reader_free(&ring.reader);
+    if (ring.slots != NULL)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            free_pol(&ring.slots[i].A);
+            free_pol(&ring.slots[i].B);
+            free_pol(&ring.slots[i].M);
+            free_pol(&ring.slots[i].R);
+        }
+        free(ring.slots, size * sizeof(JobSlot));
+    }
+    if (buf != NULL)
+        free(buf, JOBS_OUT_BUF);
+    if (threads != NULL)
+        free(threads, ((size_t)workers + 1) * sizeof(pthread_t));
+
+    if (stats != NULL)
+        stats->seconds = jobs_now() - start;
+    return status;
+}
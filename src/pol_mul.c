@@ -0,0 +1,401 @@
+#include "../include/pol_mul.h"
+#include "../include/pol_arith.h"
+#include "../include/ntt.h"
+#include "../include/pol_par.h"
+#include "../include/mem_tracker.h"
+
+size_t g_karatsuba_threshold = POL_KARATSUBA_THRESHOLD;
+
+static size_t kara_base(void)
+{
+    return (g_karatsuba_threshold < 1) ? 1 : g_karatsuba_threshold;
+}
+
+/*--------------------- ОТЛОЖЕННОЕ ПРИВЕДЕНИЕ ---------------------*/
+
+/*
+ * Ширина накопителя для суммы n произведений x * y (x <= max_x, y <= max_y):
+ * сумма меньше 2^(bits(max_x) + bits(max_y) + bits(n)), поэтому её можно
+ * копить без приведения и делить один раз в конце.
+ */
+enum AccKind
+{
+    ACC_64,     // сумма помещается в 64 бита
+    ACC_128,    // сумма помещается в 128 бит
+    ACC_192     // 128 бит и счётчик переносов
+};
+
+static enum AccKind acc_kind(ULL max_x, ULL max_y, size_t n)
+{
+    unsigned bits = bit_length(max_x) + bit_length(max_y) + bit_length(n);
+    if (bits <= 64)
+        return ACC_64;
+    if (bits <= 128)
+        return ACC_128;
+    return ACC_192;
+}
+
+static ULL max_coeff(const ULL* a, size_t n)
+{
+    ULL mx = 0;
+    for (size_t i = 0; i < n; i++)
+        if (a[i] > mx) mx = a[i];
+    return mx;
+}
+
+/* (x[0] * y[0] + x[1] * y[step] + ... + x[n-1] * y[(n-1) * step]) mod m */
+static inline ULL lazy_sum(const ULL* x, const ULL* y, ptrdiff_t step, size_t n,
+                           enum AccKind kind, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    switch (kind)
+    {
+        case ACC_64:
+        {
+            ULL acc = 0;
+            for (size_t t = 0; t < n; t++)
+                acc += x[t] * y[(ptrdiff_t)t * step];
+            return ctx_reduce(ctx, acc);
+        }
+        case ACC_128:
+        {
+            unsigned __int128 acc = 0;
+            for (size_t t = 0; t < n; t++)
+                acc += (unsigned __int128)x[t] * y[(ptrdiff_t)t * step];
+            return mod128((ULL)(acc >> 64), (ULL)acc, m);
+        }
+        default:
+        {
+            unsigned __int128 acc = 0;
+            ULL top = 0;
+            for (size_t t = 0; t < n; t++)
+            {
+                unsigned __int128 p = (unsigned __int128)x[t] * y[(ptrdiff_t)t * step];
+                acc += p;
+                top += (acc < p);
+            }
+            return mod128(mod128(top, (ULL)(acc >> 64), m), (ULL)acc, m);
+        }
+    }
+}
+
+void schoolbook_mul(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                    const PolModCtx* ctx)
+{
+    size_t n_min = (na < nb) ? na : nb;
+    enum AccKind kind = acc_kind(max_coeff(a, na), max_coeff(b, nb), n_min);
+
+    // r[k] = sum a[i] * b[k - i] по всем допустимым i
+    for (size_t k = 0; k < na + nb - 1; k++)
+    {
+        size_t lo = (k >= nb) ? k - nb + 1 : 0;
+        size_t hi = (k < na) ? k : na - 1;
+        r[k] = lazy_sum(a + lo, b + (k - lo), -1, hi - lo + 1, kind, ctx);
+    }
+}
+
+ULL dot_coeffs(const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    if (n == 0)
+        return 0;
+
+    enum AccKind kind = acc_kind(max_coeff(a, n), max_coeff(b, n), n);
+    return lazy_sum(a, b, 1, n, kind, ctx);
+}
+
+/*--------------------- КАРАЦУБА ---------------------*/
+
+/* Сколько верхних уровней Карацубы выполняются параллельно при меньшем множителе длины n */
+static unsigned kara_levels(size_t n)
+{
+    return (n > g_par_threshold) ? POL_PAR_KARATSUBA_DEPTH : 0;
+}
+
+/* Уровень с раздельной памятью для трёх подзадач */
+static int kara_is_split(size_t n, unsigned levels)
+{
+    return levels > 0 && n > POL_PAR_GRAIN;
+}
+
+/* Рабочая память для сбалансированного случая na == nb == n */
+static size_t kara_balanced_scratch(size_t n, unsigned levels)
+{
+    if (n <= kara_base())
+        return 0;
+
+    size_t h = n / 2;
+    size_t k = n - h;
+
+    // sa, sb, mid; на параллельном уровне у каждой подзадачи своя память
+    if (kara_is_split(n, levels))
+        return (4 * k - 1) + 2 * kara_balanced_scratch(k, levels - 1)
+                           + kara_balanced_scratch(h, levels - 1);
+
+    size_t total = 0;
+    while (n > kara_base())
+    {
+        k = n - n / 2;
+        total += 4 * k - 1;
+        n = k;
+    }
+    return total;
+}
+
+size_t karatsuba_scratch_size(size_t na, size_t nb)
+{
+    if (na < nb)
+    {
+        size_t t = na; na = nb; nb = t;
+    }
+
+    if (nb <= kara_base())
+        return 0;
+
+    unsigned levels = kara_levels(nb);
+    if (na == nb)
+        return kara_balanced_scratch(na, levels);
+
+    size_t rem = na % nb;
+    size_t inner = kara_balanced_scratch(nb, levels);
+    if (rem > 0)
+    {
+        size_t tail = karatsuba_scratch_size(nb, rem);
+        if (tail > inner) inner = tail;
+    }
+    return (2 * nb - 1) + inner;
+}
+
+static void kara_balanced(const ULL* a, const ULL* b, size_t n, ULL* r,
+                          ULL* scratch, unsigned levels, const PolModCtx* ctx);
+
+/* mid = (a0+a1)(b0+b1) - a0*b0 - a1*b1, прибавляется к r[h ..] */
+static void kara_combine(ULL* r, ULL* mid, size_t h, size_t k, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    for (size_t i = 0; i < 2 * h - 1; i++)
+        mid[i] = sub_mod(mid[i], r[i], m);
+    for (size_t i = 0; i < 2 * k - 1; i++)
+        mid[i] = sub_mod(mid[i], r[2 * h + i], m);
+
+    for (size_t i = 0; i < 2 * k - 1; i++)
+        r[h + i] = add_mod(r[h + i], mid[i], m);
+}
+
+static void kara_sums(const ULL* a, const ULL* b, size_t h, size_t k,
+                      ULL* sa, ULL* sb, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    for (size_t i = 0; i < k; i++)
+    {
+        ULL lo_a = (i < h) ? ctx_reduce(ctx, a[i]) : 0;
+        ULL lo_b = (i < h) ? ctx_reduce(ctx, b[i]) : 0;
+        sa[i] = add_mod(lo_a, ctx_reduce(ctx, a[h + i]), m);
+        sb[i] = add_mod(lo_b, ctx_reduce(ctx, b[h + i]), m);
+    }
+}
+
+/* Три произведения уровня независимы: два отдаются другим потокам, третье считается здесь */
+static void kara_split(const ULL* a, const ULL* b, size_t n, ULL* r,
+                       ULL* scratch, unsigned levels, const PolModCtx* ctx)
+{
+    size_t h = n / 2;
+    size_t k = n - h;
+#ifdef _OPENMP
+    int split = par_in_team();
+#endif
+
+    ULL* sa  = scratch;
+    ULL* sb  = sa + k;
+    ULL* mid = sb + k;
+    ULL* rest_mid = mid + 2 * k - 1;
+    ULL* rest_lo = rest_mid + kara_balanced_scratch(k, levels - 1);
+    ULL* rest_hi = rest_lo + kara_balanced_scratch(h, levels - 1);
+
+    #pragma omp task if (split)
+    kara_balanced(a, b, h, r, rest_lo, levels - 1, ctx);
+
+    #pragma omp task if (split)
+    kara_balanced(a + h, b + h, k, r + 2 * h, rest_hi, levels - 1, ctx);
+
+    kara_sums(a, b, h, k, sa, sb, ctx);
+    kara_balanced(sa, sb, k, mid, rest_mid, levels - 1, ctx);
+
+    #pragma omp taskwait
+
+    r[2 * h - 1] = 0;
+    kara_combine(r, mid, h, k, ctx);
+}
+
+static void kara_balanced(const ULL* a, const ULL* b, size_t n, ULL* r,
+                          ULL* scratch, unsigned levels, const PolModCtx* ctx)
+{
+    if (n <= kara_base())
+    {
+        schoolbook_mul(a, n, b, n, r, ctx);
+        return;
+    }
+
+    if (kara_is_split(n, levels))
+    {
+        kara_split(a, b, n, r, scratch, levels, ctx);
+        return;
+    }
+
+    size_t h = n / 2;       // младшая половина
+    size_t k = n - h;       // старшая половина, k >= h
+
+    // a0*b0 -> r[0 .. 2h-2], a1*b1 -> r[2h .. 2n-2]
+    kara_balanced(a, b, h, r, scratch, 0, ctx);
+    r[2 * h - 1] = 0;
+    kara_balanced(a + h, b + h, k, r + 2 * h, scratch, 0, ctx);
+
+    ULL* sa  = scratch;
+    ULL* sb  = sa + k;
+    ULL* mid = sb + k;
+    ULL* rest = mid + 2 * k - 1;
+
+    kara_sums(a, b, h, k, sa, sb, ctx);
+    kara_balanced(sa, sb, k, mid, rest, 0, ctx);
+    kara_combine(r, mid, h, k, ctx);
+}
+
+void karatsuba_mul(const ULL* a, size_t na, const ULL* b, size_t nb,
+                   ULL* r, ULL* scratch, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+
+    if (na < nb)
+    {
+        const ULL* t = a; a = b; b = t;
+        size_t tn = na; na = nb; nb = tn;
+    }
+
+    if (nb <= kara_base())
+    {
+        schoolbook_mul(a, na, b, nb, r, ctx);
+        return;
+    }
+
+    unsigned levels = kara_levels(nb);
+    if (na == nb)
+    {
+        kara_balanced(a, b, na, r, scratch, levels, ctx);
+        return;
+    }
+
+    // Несбалансированный случай: режем a на куски длины nb
+    ULL* part = scratch;
+    ULL* rest = scratch + 2 * nb - 1;
+
+    for (size_t i = 0; i < na + nb - 1; i++)
+        r[i] = 0;
+
+    for (size_t off = 0; off < na; off += nb)
+    {
+        size_t len = (na - off < nb) ? na - off : nb;
+
+        if (len == nb)
+            kara_balanced(a + off, b, nb, part, rest, levels, ctx);
+        else
+            karatsuba_mul(b, nb, a + off, len, part, rest, ctx);
+
+        for (size_t i = 0; i < len + nb - 1; i++)
+            r[off + i] = add_mod(r[off + i], part[i], m);
+    }
+}
+
+/*--------------------- ВЫБОР АЛГОРИТМА ---------------------*/
+
+enum MulAlgo
+{
+    MUL_NTT,
+    MUL_CRT,
+    MUL_SCHOOLBOOK,
+    MUL_KARATSUBA
+};
+
+static enum MulAlgo choose_mul(size_t na, size_t nb, const PolModCtx* ctx)
+{
+    size_t n_min = (na < nb) ? na : nb;
+
+    if (n_min > g_ntt_threshold && ntt_length(ctx->modulo, na, nb) != 0)
+        return MUL_NTT;
+
+    if (n_min > g_ntt_crt_threshold && ntt_crt_scratch_size(na, nb) != 0)
+        return MUL_CRT;
+
+    if (n_min <= kara_base())
+        return MUL_SCHOOLBOOK;
+
+    return MUL_KARATSUBA;
+}
+
+size_t mul_coeffs_scratch_size(size_t na, size_t nb, const PolModCtx* ctx)
+{
+    switch (choose_mul(na, nb, ctx))
+    {
+        case MUL_NTT:
+            return ntt_scratch_size(ctx->modulo, na, nb);
+        case MUL_CRT:
+            return ntt_crt_scratch_size(na, nb);
+        case MUL_KARATSUBA:
+            return karatsuba_scratch_size(na, nb);
+        default:
+            return 0;
+    }
+}
+
+static int mul_dispatch(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                        ULL* scratch, const PolModCtx* ctx)
+{
+    switch (choose_mul(na, nb, ctx))
+    {
+        case MUL_NTT:
+            return ntt_mul(a, na, b, nb, r, scratch, ctx->modulo);
+        case MUL_CRT:
+            return ntt_crt_mul(a, na, b, nb, r, scratch, ctx);
+        case MUL_KARATSUBA:
+            karatsuba_mul(a, na, b, nb, r, scratch, ctx);
+            return POL_SUCCESS;
+        default:
+            schoolbook_mul(a, na, b, nb, r, ctx);
+            return POL_SUCCESS;
+    }
+}
+
+int mul_coeffs_ws(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+                  ULL* scratch, const PolModCtx* ctx)
+{
+    size_t n_min = (na < nb) ? na : nb;
+    if (n_min <= g_par_threshold || !par_can_fork())
+        return mul_dispatch(a, na, b, nb, r, scratch, ctx);
+
+    // один поток строит дерево задач, остальные команды их разбирают
+    int status = POL_SUCCESS;
+
+    #pragma omp parallel num_threads(pol_get_num_threads())
+    #pragma omp single
+    status = mul_dispatch(a, na, b, nb, r, scratch, ctx);
+
+    return status;
+}
+
+int mul_coeffs(const ULL* a, size_t na, const ULL* b, size_t nb, ULL* r,
+               const PolModCtx* ctx)
+{
+    size_t scratch_len = mul_coeffs_scratch_size(na, nb, ctx);
+    if (scratch_len == 0)
+        return mul_coeffs_ws(a, na, b, nb, r, NULL, ctx);
+
+    ULL* scratch = malloc(scratch_len * sizeof(ULL));
+    if (scratch == NULL)
+        return POL_MEMORY_ERROR;
+
+    int status = mul_coeffs_ws(a, na, b, nb, r, scratch, ctx);
+
+    free(scratch, scratch_len * sizeof(ULL));
+    return status;
+}
@@ -0,0 +1,44 @@
+#include <stdatomic.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../include/pol_par.h"
+
+size_t g_par_threshold = POL_PAR_THRESHOLD;
+
+static atomic_int g_par_threads = 0;   // 0 — значение OpenMP по умолчанию
+
+void pol_set_num_threads(int n)
+{
+    atomic_store(&g_par_threads, (n > 0) ? n : 0);
+}
+
+int pol_get_num_threads(void)
+{
+#ifdef _OPENMP
+    int n = atomic_load(&g_par_threads);
+    return (n > 0) ? n : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int par_in_team(void)
+{
+#ifdef _OPENMP
+    return omp_get_num_threads() > 1;
+#else
+    return 0;
+#endif
+}
+
+int par_can_fork(void)
+{
+#ifdef _OPENMP
+    return !omp_in_parallel() && pol_get_num_threads() > 1;
+#else
+    return 0;
+#endif
+}
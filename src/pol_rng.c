@@ -0,0 +1,225 @@
+#include <stdatomic.h>
+
+#include "../include/pol_rng.h"
+#include "../include/pol_par.h"
+
+/* Пакеты меньше этого числа коэффициентов заполняются в одном потоке */
+#define RNG_PAR_MIN_COEFFS 65536
+
+static inline ULL rotl(ULL x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline ULL splitmix64(ULL* state)
+{
+    ULL z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline ULL rng_next(ULL* s)
+{
+    ULL result = rotl(s[1] * 5, 7) * 9;
+    ULL t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/* Старшие и младшие 64 бита произведения x * m */
+static inline ULL mul_hi_lo(ULL x, ULL m, ULL* lo)
+{
+    unsigned __int128 p = (unsigned __int128)x * m;
+    *lo = (ULL)p;
+    return (ULL)(p >> 64);
+}
+
+void pol_rng_seed(PolRng* rng, ULL seed)
+{
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = splitmix64(&seed);
+}
+
+void pol_rng_jump(PolRng* rng)
+{
+    static const ULL JUMP[4] =
+    {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+
+    ULL t[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (JUMP[i] & (1ULL << b))
+            {
+                t[0] ^= rng->s[0];
+                t[1] ^= rng->s[1];
+                t[2] ^= rng->s[2];
+                t[3] ^= rng->s[3];
+            }
+            rng_next(rng->s);
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = t[i];
+}
+
+void pol_rng_stream(PolRng* rng, ULL seed, size_t stream)
+{
+    pol_rng_seed(rng, seed);
+    for (size_t i = 0; i < stream; i++)
+        pol_rng_jump(rng);
+}
+
+ULL pol_rng_next(PolRng* rng)
+{
+    return rng_next(rng->s);
+}
+
+ULL pol_rng_below(PolRng* rng, ULL m)
+{
+    ULL lo;
+    ULL hi = mul_hi_lo(rng_next(rng->s), m, &lo);
+
+    if (lo < m)
+    {
+        // 2^64 mod m: значения lo ниже него дают смещение
+        ULL t = (0 - m) % m;
+        while (lo < t)
+            hi = mul_hi_lo(rng_next(rng->s), m, &lo);
+    }
+    return hi;
+}
+
+void pol_rng_fill(PolRng* rng, ULL* dst, size_t n, ULL m)
+{
+    // состояние в локальных переменных, чтобы компилятор держал его в регистрах
+    ULL s[4] = { rng->s[0], rng->s[1], rng->s[2], rng->s[3] };
+
+    if ((m & (m - 1)) == 0)
+    {
+        ULL mask = m - 1;
+        for (size_t i = 0; i < n; i++)
+            dst[i] = rng_next(s) & mask;
+    }
+    else
+    {
+        ULL t = (0 - m) % m;
+        for (size_t i = 0; i < n; i++)
+        {
+            ULL lo;
+            ULL hi = mul_hi_lo(rng_next(s), m, &lo);
+            while (lo < t)
+                hi = mul_hi_lo(rng_next(s), m, &lo);
+            dst[i] = hi;
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        rng->s[i] = s[i];
+}
+
+int pol_rng_pol(PolRng* rng, Polynomial* P, size_t degree, ULL modulo)
+{
+    if (rng == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    if (modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    if (P->capacity < degree + 1)
+    {
+        int status = realloc_coeffs(P, degree);
+        if (status != POL_SUCCESS)
+            return status;
+    }
+
+    pol_rng_fill(rng, P->coeffs, degree, modulo);
+    P->coeffs[degree] = 1 + pol_rng_below(rng, modulo - 1);
+    set_pol_params(P, degree, modulo);
+    return POL_SUCCESS;
+}
+
+int pol_rng_pols(PolRng* rng, Polynomial* P, size_t count, size_t degree, ULL modulo)
+{
+    if (rng == NULL || P == NULL)
+        return POL_NULL_PTR;
+
+    if (modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    ULL base = rng_next(rng->s);
+    size_t fail_index = count;
+    int fail_status = POL_SUCCESS;
+
+    #pragma omp parallel for schedule(dynamic, 4) num_threads(pol_get_num_threads()) \
+            if (count > 1 && count * (degree + 1) >= RNG_PAR_MIN_COEFFS && par_can_fork())
+    for (size_t i = 0; i < count; i++)
+    {
+        PolRng r;
+        pol_rng_seed(&r, base + i);
+
+        int status = pol_rng_pol(&r, &P[i], degree, modulo);
+        if (status != POL_SUCCESS)
+        {
+            #pragma omp critical (pol_rng_status)
+            {
+                if (i < fail_index)
+                {
+                    fail_index = i;
+                    fail_status = status;
+                }
+            }
+        }
+    }
+
+    return fail_status;
+}
+
+/*--------------------- ГЕНЕРАТОРЫ ПОТОКОВ ---------------------*/
+
+typedef struct RngLocal
+{
+    PolRng rng;
+    ULL epoch;      // 0 — ещё не инициализирован
+} RngLocal;
+
+static _Atomic ULL g_rng_seed = 1;
+static _Atomic ULL g_rng_epoch = 1;
+static atomic_size_t g_rng_next_stream = 0;
+
+static _Thread_local RngLocal t_rng;
+
+PolRng* pol_rng_local(void)
+{
+    ULL epoch = atomic_load(&g_rng_epoch);
+    if (t_rng.epoch != epoch)
+    {
+        size_t stream = atomic_fetch_add(&g_rng_next_stream, 1);
+        pol_rng_stream(&t_rng.rng, atomic_load(&g_rng_seed), stream);
+        t_rng.epoch = epoch;
+    }
+    return &t_rng.rng;
+}
+
+void pol_rng_global_seed(ULL seed)
+{
+    atomic_store(&g_rng_seed, seed);
+    atomic_store(&g_rng_next_stream, 1);
+    ULL epoch = atomic_fetch_add(&g_rng_epoch, 1) + 1;
+
+    pol_rng_stream(&t_rng.rng, seed, 0);
+    t_rng.epoch = epoch;
+}
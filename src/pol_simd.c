@@ -0,0 +1,664 @@
+#include "../include/pol_simd.h"
+#include "../include/pol_mul.h"
+#include "../include/pol_arith.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && !defined(POL_NO_SIMD)
+#define POL_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define POL_SIMD_X86 0
+#endif
+
+#include "../include/mem_tracker.h"
+
+/*--------------------- СКАЛЯРНЫЕ ЯДРА ---------------------*/
+
+static void add_scalar(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    for (size_t i = 0; i < n; i++)
+        r[i] = add_mod(ctx_reduce(ctx, a[i]), ctx_reduce(ctx, b[i]), ctx->modulo);
+}
+
+static void sub_scalar(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    for (size_t i = 0; i < n; i++)
+        r[i] = sub_mod(ctx_reduce(ctx, a[i]), ctx_reduce(ctx, b[i]), ctx->modulo);
+}
+
+static void reduce_scalar(ULL* r, const ULL* a, size_t n, const PolModCtx* ctx)
+{
+    for (size_t i = 0; i < n; i++)
+        r[i] = ctx_reduce(ctx, a[i]);
+}
+
+static void scale_scalar(ULL* r, const ULL* a, ULL k, size_t n, const PolModCtx* ctx)
+{
+    ULL kp = ctx_prep(ctx, ctx_reduce(ctx, k));
+
+    for (size_t i = 0; i < n; i++)
+        r[i] = ctx_mul_prep(ctx, ctx_reduce(ctx, a[i]), kp);
+}
+
+static const PolVecOps g_ops_scalar =
+{
+    "scalar", add_scalar, sub_scalar, reduce_scalar, scale_scalar, dot_coeffs
+};
+
+#if POL_SIMD_X86
+
+/*--------------------- ОБЩЕЕ ДЛЯ ВЕКТОРНЫХ ЯДЕР ---------------------*/
+
+/*
+ * 192-битная сумма для скалярного произведения. Векторные ядра копят
+ * в каждой дорожке 32-битные части произведений (c0 + c1*2^32 + c2*2^64 +
+ * c3*2^96) и сбрасывают их сюда раз в DOT_BLOCK элементов.
+ */
+typedef struct Acc192
+{
+    unsigned __int128 lo;
+    ULL top;
+} Acc192;
+
+/* Элементов на блок: каждая часть растёт не больше чем на 3 * 2^32 за шаг */
+#define DOT_BLOCK ((size_t)1 << 26)
+
+static inline void acc_add(Acc192* s, unsigned __int128 v)
+{
+    s->lo += v;
+    s->top += (s->lo < v);
+}
+
+static inline void acc_add_parts(Acc192* s, ULL c0, ULL c1, ULL c2, ULL c3)
+{
+    acc_add(s, c0);
+    acc_add(s, (unsigned __int128)c1 << 32);
+    acc_add(s, (unsigned __int128)c2 << 64);
+    acc_add(s, (unsigned __int128)(c3 & 0xFFFFFFFFULL) << 96);
+    s->top += c3 >> 32;
+}
+
+static inline ULL acc_mod(const Acc192* s, ULL m)
+{
+    return mod128(mod128(s->top, (ULL)(s->lo >> 64), m), (ULL)s->lo, m);
+}
+
+static void dot_tail(Acc192* s, const ULL* a, const ULL* b, size_t from, size_t n)
+{
+    for (size_t i = from; i < n; i++)
+        acc_add(s, (unsigned __int128)a[i] * b[i]);
+}
+
+/* floor(k * 2^32 / m) или floor(k * 2^64 / m) для умножения Шоупа на k < m */
+static inline ULL shoup32(ULL k, ULL m)
+{
+    return (k << 32) / m;
+}
+
+static inline ULL shoup64(ULL k, ULL m)
+{
+    return (ULL)(((unsigned __int128)k << 64) / m);
+}
+
+/*--------------------- AVX2 ---------------------*/
+
+#define AVX2_FN __attribute__((target("avx2")))
+
+/* a > b для беззнаковых 64-битных дорожек */
+static inline AVX2_FN __m256i gt_u64_avx2(__m256i a, __m256i b)
+{
+    const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+}
+
+/* Все дорожки маски установлены */
+static inline AVX2_FN int all_avx2(__m256i mask)
+{
+    return _mm256_movemask_pd(_mm256_castsi256_pd(mask)) == 0xF;
+}
+
+/* Старшие 64 бита произведения 64 x 64 через четыре умножения 32 x 32 */
+static inline AVX2_FN __m256i mulhi64_avx2(__m256i a, __m256i b)
+{
+    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    __m256i ah = _mm256_srli_epi64(a, 32);
+    __m256i bh = _mm256_srli_epi64(b, 32);
+
+    __m256i ll = _mm256_mul_epu32(a, b);
+    __m256i lh = _mm256_mul_epu32(a, bh);
+    __m256i hl = _mm256_mul_epu32(ah, b);
+    __m256i hh = _mm256_mul_epu32(ah, bh);
+
+    __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                  _mm256_add_epi64(_mm256_and_si256(lh, low), _mm256_and_si256(hl, low)));
+
+    return _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)),
+                            _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+}
+
+/* Младшие 64 бита произведения 64 x 64 */
+static inline AVX2_FN __m256i mullo64_avx2(__m256i a, __m256i b)
+{
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)),
+                                     _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+static AVX2_FN void add_avx2(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    const __m256i vm = _mm256_set1_epi64x((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+
+        if (!all_avx2(_mm256_and_si256(gt_u64_avx2(vm, va), gt_u64_avx2(vm, vb))))
+        {
+            add_scalar(r + i, a + i, b + i, 4, ctx);
+            continue;
+        }
+
+        // a + b без переполнения: a >= m - b ? a - (m - b) : a + b
+        __m256i d = _mm256_sub_epi64(vm, vb);
+        __m256i wrap = gt_u64_avx2(d, va);
+        __m256i res = _mm256_blendv_epi8(_mm256_sub_epi64(va, d), _mm256_add_epi64(va, vb), wrap);
+        _mm256_storeu_si256((__m256i*)(r + i), res);
+    }
+
+    add_scalar(r + i, a + i, b + i, n - i, ctx);
+}
+
+static AVX2_FN void sub_avx2(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    const __m256i vm = _mm256_set1_epi64x((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+
+        if (!all_avx2(_mm256_and_si256(gt_u64_avx2(vm, va), gt_u64_avx2(vm, vb))))
+        {
+            sub_scalar(r + i, a + i, b + i, 4, ctx);
+            continue;
+        }
+
+        __m256i res = _mm256_sub_epi64(va, vb);
+        __m256i borrow = gt_u64_avx2(vb, va);
+        res = _mm256_add_epi64(res, _mm256_and_si256(borrow, vm));
+        _mm256_storeu_si256((__m256i*)(r + i), res);
+    }
+
+    sub_scalar(r + i, a + i, b + i, n - i, ctx);
+}
+
+static AVX2_FN void reduce_avx2(ULL* r, const ULL* a, size_t n, const PolModCtx* ctx)
+{
+    const __m256i vm = _mm256_set1_epi64x((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+
+        if (!all_avx2(gt_u64_avx2(vm, va)))
+        {
+            reduce_scalar(r + i, a + i, 4, ctx);
+            continue;
+        }
+
+        _mm256_storeu_si256((__m256i*)(r + i), va);
+    }
+
+    reduce_scalar(r + i, a + i, n - i, ctx);
+}
+
+static AVX2_FN void scale_avx2(ULL* r, const ULL* a, ULL k, size_t n, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+    if (m > (1ULL << 63))
+    {
+        scale_scalar(r, a, k, n, ctx);
+        return;
+    }
+
+    ULL kr = ctx_reduce(ctx, k);
+    const __m256i vm = _mm256_set1_epi64x((long long)m);
+    const __m256i vk = _mm256_set1_epi64x((long long)kr);
+    size_t i = 0;
+
+    if (m <= 0xFFFFFFFFULL)
+    {
+        // Шоуп с 32-битной константой: a < 2^32 -> a * k - q * m < 2m
+        const __m256i vkq = _mm256_set1_epi64x((long long)shoup32(kr, m));
+        const __m256i high = _mm256_set1_epi64x((long long)0xFFFFFFFF00000000ULL);
+        const __m256i vm1 = _mm256_set1_epi64x((long long)(m - 1));
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+
+            if (!_mm256_testz_si256(va, high))
+            {
+                scale_scalar(r + i, a + i, k, 4, ctx);
+                continue;
+            }
+
+            __m256i q = _mm256_srli_epi64(_mm256_mul_epu32(va, vkq), 32);
+            __m256i res = _mm256_sub_epi64(_mm256_mul_epu32(va, vk), _mm256_mul_epu32(q, vm));
+            res = _mm256_sub_epi64(res, _mm256_and_si256(_mm256_cmpgt_epi64(res, vm1), vm));
+            _mm256_storeu_si256((__m256i*)(r + i), res);
+        }
+    }
+    else
+    {
+        // Шоуп с 64-битной константой: 2m < 2^64 при m <= 2^63
+        const __m256i vkq = _mm256_set1_epi64x((long long)shoup64(kr, m));
+
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+
+            __m256i q = mulhi64_avx2(va, vkq);
+            __m256i res = _mm256_sub_epi64(mullo64_avx2(va, vk), mullo64_avx2(q, vm));
+            __m256i over = _mm256_xor_si256(gt_u64_avx2(vm, res), _mm256_set1_epi64x(-1));
+            res = _mm256_sub_epi64(res, _mm256_and_si256(over, vm));
+            _mm256_storeu_si256((__m256i*)(r + i), res);
+        }
+    }
+
+    scale_scalar(r + i, a + i, k, n - i, ctx);
+}
+
+/* Все элементы < 2^32: одно умножение на дорожку. Возвращает 0, если встретился больший */
+static AVX2_FN int dot_narrow_avx2(Acc192* s, const ULL* a, const ULL* b, size_t n)
+{
+    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    size_t i = 0;
+
+    while (i + 4 <= n)
+    {
+        size_t end = (n - i > DOT_BLOCK) ? i + DOT_BLOCK : n;
+        __m256i c0 = _mm256_setzero_si256(), c1 = c0, seen = c0;
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+            seen = _mm256_or_si256(seen, _mm256_or_si256(va, vb));
+
+            __m256i p = _mm256_mul_epu32(va, vb);
+            c0 = _mm256_add_epi64(c0, _mm256_and_si256(p, low));
+            c1 = _mm256_add_epi64(c1, _mm256_srli_epi64(p, 32));
+        }
+
+        if (!_mm256_testz_si256(seen, _mm256_andnot_si256(low, _mm256_set1_epi64x(-1))))
+            return 0;
+
+        ULL l0[4], l1[4];
+        _mm256_storeu_si256((__m256i*)l0, c0);
+        _mm256_storeu_si256((__m256i*)l1, c1);
+        for (int l = 0; l < 4; l++)
+            acc_add_parts(s, l0[l], l1[l], 0, 0);
+    }
+
+    dot_tail(s, a, b, i, n);
+    return 1;
+}
+
+static AVX2_FN void dot_wide_avx2(Acc192* s, const ULL* a, const ULL* b, size_t n)
+{
+    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    size_t i = 0;
+
+    while (i + 4 <= n)
+    {
+        size_t end = (n - i > DOT_BLOCK) ? i + DOT_BLOCK : n;
+        __m256i c0 = _mm256_setzero_si256(), c1 = c0, c2 = c0, c3 = c0;
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+            __m256i ah = _mm256_srli_epi64(va, 32);
+            __m256i bh = _mm256_srli_epi64(vb, 32);
+
+            __m256i ll = _mm256_mul_epu32(va, vb);
+            __m256i lh = _mm256_mul_epu32(va, bh);
+            __m256i hl = _mm256_mul_epu32(ah, vb);
+            __m256i hh = _mm256_mul_epu32(ah, bh);
+
+            c0 = _mm256_add_epi64(c0, _mm256_and_si256(ll, low));
+            c1 = _mm256_add_epi64(c1, _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                 _mm256_add_epi64(_mm256_and_si256(lh, low), _mm256_and_si256(hl, low))));
+            c2 = _mm256_add_epi64(c2, _mm256_add_epi64(_mm256_and_si256(hh, low),
+                 _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32))));
+            c3 = _mm256_add_epi64(c3, _mm256_srli_epi64(hh, 32));
+        }
+
+        ULL l0[4], l1[4], l2[4], l3[4];
+        _mm256_storeu_si256((__m256i*)l0, c0);
+        _mm256_storeu_si256((__m256i*)l1, c1);
+        _mm256_storeu_si256((__m256i*)l2, c2);
+        _mm256_storeu_si256((__m256i*)l3, c3);
+        for (int l = 0; l < 4; l++)
+            acc_add_parts(s, l0[l], l1[l], l2[l], l3[l]);
+    }
+
+    dot_tail(s, a, b, i, n);
+}
+
+static AVX2_FN ULL dot_avx2(const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    Acc192 s = {0, 0};
+
+    if (ctx->modulo > 0xFFFFFFFFULL || !dot_narrow_avx2(&s, a, b, n))
+    {
+        s.lo = 0; s.top = 0;
+        dot_wide_avx2(&s, a, b, n);
+    }
+
+    return acc_mod(&s, ctx->modulo);
+}
+
+static const PolVecOps g_ops_avx2 =
+{
+    "avx2", add_avx2, sub_avx2, reduce_avx2, scale_avx2, dot_avx2
+};
+
+/*--------------------- AVX-512 ---------------------*/
+
+#define AVX512_FN __attribute__((target("avx512f,avx512dq")))
+
+static inline AVX512_FN __m512i mulhi64_avx512(__m512i a, __m512i b)
+{
+    const __m512i low = _mm512_set1_epi64(0xFFFFFFFFLL);
+    __m512i ah = _mm512_srli_epi64(a, 32);
+    __m512i bh = _mm512_srli_epi64(b, 32);
+
+    __m512i ll = _mm512_mul_epu32(a, b);
+    __m512i lh = _mm512_mul_epu32(a, bh);
+    __m512i hl = _mm512_mul_epu32(ah, b);
+    __m512i hh = _mm512_mul_epu32(ah, bh);
+
+    __m512i mid = _mm512_add_epi64(_mm512_srli_epi64(ll, 32),
+                  _mm512_add_epi64(_mm512_and_si512(lh, low), _mm512_and_si512(hl, low)));
+
+    return _mm512_add_epi64(_mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32)),
+                            _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+}
+
+static AVX512_FN void add_avx512(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    const __m512i vm = _mm512_set1_epi64((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+
+        if ((_mm512_cmplt_epu64_mask(va, vm) & _mm512_cmplt_epu64_mask(vb, vm)) != 0xFF)
+        {
+            add_scalar(r + i, a + i, b + i, 8, ctx);
+            continue;
+        }
+
+        __m512i d = _mm512_sub_epi64(vm, vb);
+        __mmask8 wrap = _mm512_cmpge_epu64_mask(va, d);
+        __m512i res = _mm512_mask_sub_epi64(_mm512_add_epi64(va, vb), wrap, va, d);
+        _mm512_storeu_si512(r + i, res);
+    }
+
+    add_scalar(r + i, a + i, b + i, n - i, ctx);
+}
+
+static AVX512_FN void sub_avx512(ULL* r, const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    const __m512i vm = _mm512_set1_epi64((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+
+        if ((_mm512_cmplt_epu64_mask(va, vm) & _mm512_cmplt_epu64_mask(vb, vm)) != 0xFF)
+        {
+            sub_scalar(r + i, a + i, b + i, 8, ctx);
+            continue;
+        }
+
+        __m512i res = _mm512_sub_epi64(va, vb);
+        res = _mm512_mask_add_epi64(res, _mm512_cmplt_epu64_mask(va, vb), res, vm);
+        _mm512_storeu_si512(r + i, res);
+    }
+
+    sub_scalar(r + i, a + i, b + i, n - i, ctx);
+}
+
+static AVX512_FN void reduce_avx512(ULL* r, const ULL* a, size_t n, const PolModCtx* ctx)
+{
+    const __m512i vm = _mm512_set1_epi64((long long)ctx->modulo);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512i va = _mm512_loadu_si512(a + i);
+
+        if (_mm512_cmplt_epu64_mask(va, vm) != 0xFF)
+        {
+            reduce_scalar(r + i, a + i, 8, ctx);
+            continue;
+        }
+
+        _mm512_storeu_si512(r + i, va);
+    }
+
+    reduce_scalar(r + i, a + i, n - i, ctx);
+}
+
+static AVX512_FN void scale_avx512(ULL* r, const ULL* a, ULL k, size_t n, const PolModCtx* ctx)
+{
+    ULL m = ctx->modulo;
+    if (m > (1ULL << 63))
+    {
+        scale_scalar(r, a, k, n, ctx);
+        return;
+    }
+
+    ULL kr = ctx_reduce(ctx, k);
+    const __m512i vm = _mm512_set1_epi64((long long)m);
+    const __m512i vk = _mm512_set1_epi64((long long)kr);
+    size_t i = 0;
+
+    if (m <= 0xFFFFFFFFULL)
+    {
+        const __m512i vkq = _mm512_set1_epi64((long long)shoup32(kr, m));
+        const __m512i high = _mm512_set1_epi64((long long)0xFFFFFFFF00000000ULL);
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512i va = _mm512_loadu_si512(a + i);
+
+            if (_mm512_test_epi64_mask(va, high) != 0)
+            {
+                scale_scalar(r + i, a + i, k, 8, ctx);
+                continue;
+            }
+
+            __m512i q = _mm512_srli_epi64(_mm512_mul_epu32(va, vkq), 32);
+            __m512i res = _mm512_sub_epi64(_mm512_mul_epu32(va, vk), _mm512_mul_epu32(q, vm));
+            res = _mm512_min_epu64(res, _mm512_sub_epi64(res, vm));
+            _mm512_storeu_si512(r + i, res);
+        }
+    }
+    else
+    {
+        const __m512i vkq = _mm512_set1_epi64((long long)shoup64(kr, m));
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512i va = _mm512_loadu_si512(a + i);
+
+            __m512i q = mulhi64_avx512(va, vkq);
+            __m512i res = _mm512_sub_epi64(_mm512_mullo_epi64(va, vk), _mm512_mullo_epi64(q, vm));
+            res = _mm512_min_epu64(res, _mm512_sub_epi64(res, vm));
+            _mm512_storeu_si512(r + i, res);
+        }
+    }
+
+    scale_scalar(r + i, a + i, k, n - i, ctx);
+}
+
+static AVX512_FN int dot_narrow_avx512(Acc192* s, const ULL* a, const ULL* b, size_t n)
+{
+    const __m512i low = _mm512_set1_epi64(0xFFFFFFFFLL);
+    size_t i = 0;
+
+    while (i + 8 <= n)
+    {
+        size_t end = (n - i > DOT_BLOCK) ? i + DOT_BLOCK : n;
+        __m512i c0 = _mm512_setzero_si512(), c1 = c0, seen = c0;
+
+        for (; i + 8 <= end; i += 8)
+        {
+            __m512i va = _mm512_loadu_si512(a + i);
+            __m512i vb = _mm512_loadu_si512(b + i);
+            seen = _mm512_or_si512(seen, _mm512_or_si512(va, vb));
+
+            __m512i p = _mm512_mul_epu32(va, vb);
+            c0 = _mm512_add_epi64(c0, _mm512_and_si512(p, low));
+            c1 = _mm512_add_epi64(c1, _mm512_srli_epi64(p, 32));
+        }
+
+        if (_mm512_test_epi64_mask(seen, _mm512_andnot_si512(low, _mm512_set1_epi64(-1))) != 0)
+            return 0;
+
+        ULL l0[8], l1[8];
+        _mm512_storeu_si512(l0, c0);
+        _mm512_storeu_si512(l1, c1);
+        for (int l = 0; l < 8; l++)
+            acc_add_parts(s, l0[l], l1[l], 0, 0);
+    }
+
+    dot_tail(s, a, b, i, n);
+    return 1;
+}
+
+static AVX512_FN void dot_wide_avx512(Acc192* s, const ULL* a, const ULL* b, size_t n)
+{
+    const __m512i low = _mm512_set1_epi64(0xFFFFFFFFLL);
+    size_t i = 0;
+
+    while (i + 8 <= n)
+    {
+        size_t end = (n - i > DOT_BLOCK) ? i + DOT_BLOCK : n;
+        __m512i c0 = _mm512_setzero_si512(), c1 = c0, c2 = c0, c3 = c0;
+
+        for (; i + 8 <= end; i += 8)
+        {
+            __m512i va = _mm512_loadu_si512(a + i);
+            __m512i vb = _mm512_loadu_si512(b + i);
+            __m512i ah = _mm512_srli_epi64(va, 32);
+            __m512i bh = _mm512_srli_epi64(vb, 32);
+
+            __m512i ll = _mm512_mul_epu32(va, vb);
+            __m512i lh = _mm512_mul_epu32(va, bh);
+            __m512i hl = _mm512_mul_epu32(ah, vb);
+            __m512i hh = _mm512_mul_epu32(ah, bh);
+
+            c0 = _mm512_add_epi64(c0, _mm512_and_si512(ll, low));
+            c1 = _mm512_add_epi64(c1, _mm512_add_epi64(_mm512_srli_epi64(ll, 32),
+                 _mm512_add_epi64(_mm512_and_si512(lh, low), _mm512_and_si512(hl, low))));
+            c2 = _mm512_add_epi64(c2, _mm512_add_epi64(_mm512_and_si512(hh, low),
+                 _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32))));
+            c3 = _mm512_add_epi64(c3, _mm512_srli_epi64(hh, 32));
+        }
+
+        ULL l0[8], l1[8], l2[8], l3[8];
+        _mm512_storeu_si512(l0, c0);
+        _mm512_storeu_si512(l1, c1);
+        _mm512_storeu_si512(l2, c2);
+        _mm512_storeu_si512(l3, c3);
+        for (int l = 0; l < 8; l++)
+            acc_add_parts(s, l0[l], l1[l], l2[l], l3[l]);
+    }
+
+    dot_tail(s, a, b, i, n);
+}
+
+static AVX512_FN ULL dot_avx512(const ULL* a, const ULL* b, size_t n, const PolModCtx* ctx)
+{
+    Acc192 s = {0, 0};
+
+    if (ctx->modulo > 0xFFFFFFFFULL || !dot_narrow_avx512(&s, a, b, n))
+    {
+        s.lo = 0; s.top = 0;
+        dot_wide_avx512(&s, a, b, n);
+    }
+
+    return acc_mod(&s, ctx->modulo);
+}
+
+static const PolVecOps g_ops_avx512 =
+{
+    "avx512", add_avx512, sub_avx512, reduce_avx512, scale_avx512, dot_avx512
+};
+
+#endif // POL_SIMD_X86
+
+/*--------------------- ВЫБОР НАБОРА ИНСТРУКЦИЙ ---------------------*/
+
+static const PolVecOps* _Atomic g_vec_ops = NULL;
+
+const PolVecOps* pol_vec_ops_for(int isa)
+{
+    switch (isa)
+    {
+        case POL_ISA_SCALAR:
+            return &g_ops_scalar;
+#if POL_SIMD_X86
+        case POL_ISA_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &g_ops_avx2 : NULL;
+        case POL_ISA_AVX512:
+            __builtin_cpu_init();
+            return (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+                   ? &g_ops_avx512 : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+const PolVecOps* pol_vec_ops(void)
+{
+    if (g_vec_ops == NULL)
+    {
+        const PolVecOps* ops = &g_ops_scalar;
+        for (int isa = POL_ISA_COUNT - 1; isa > POL_ISA_SCALAR; isa--)
+        {
+            const PolVecOps* cand = pol_vec_ops_for(isa);
+            if (cand != NULL)
+            {
+                ops = cand;
+                break;
+            }
+        }
+        g_vec_ops = ops;
+    }
+    return g_vec_ops;
+}
+
+int pol_vec_set_isa(int isa)
+{
+    const PolVecOps* ops = pol_vec_ops_for(isa);
+    if (ops == NULL)
+        return POL_INVALID_ARG;
+
+    g_vec_ops = ops;
+    return POL_SUCCESS;
+}
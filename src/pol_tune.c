@@ -0,0 +1,478 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/pol_tune.h"
+#include "../include/pol_mul.h"
+#include "../include/pol_div.h"
+#include "../include/ntt.h"
+#include "../include/pol_par.h"
+#include "../include/pol_rng.h"
+#include "../include/pol_gf2.h"
+#include "../include/mem_tracker.h"
+
+typedef struct TuneKey
+{
+    const char* name;
+    size_t* value;
+} TuneKey;
+
+static const TuneKey g_tune_keys[] =
+{
+    { "karatsuba",     &g_karatsuba_threshold },
+    { "ntt",           &g_ntt_threshold },
+    { "ntt_crt",       &g_ntt_crt_threshold },
+    { "newton",        &g_newton_threshold },
+    { "newton_crt",    &g_newton_crt_threshold },
+    { "parallel",      &g_par_threshold },
+    { "gf2_karatsuba", &g_gf2_karatsuba_threshold },
+    { "gf2_newton",    &g_gf2_newton_threshold },
+};
+
+#define TUNE_KEY_COUNT (sizeof(g_tune_keys) / sizeof(g_tune_keys[0]))
+
+/* Номер ключа в g_tune_keys; TUNE_KEY_COUNT — такого ключа нет */
+static size_t tune_key_index(const char* name)
+{
+    size_t k = 0;
+    while (k < TUNE_KEY_COUNT && strcmp(g_tune_keys[k].name, name) != 0)
+        k++;
+    return k;
+}
+
+static const char* tune_path(const char* path)
+{
+    if (path != NULL)
+        return path;
+
+    const char* env = getenv("POL_TUNE_FILE");
+    return (env != NULL && env[0] != '\0') ? env : POL_TUNE_DEFAULT_FILE;
+}
+
+/*--------------------- ФАЙЛ ПОРОГОВ ---------------------*/
+
+static char* trim(char* s)
+{
+    while (*s == ' ' || *s == '\t')
+        s++;
+
+    size_t len = strlen(s);
+    while (len > 0 && (s[len - 1] == ' ' || s[len - 1] == '\t' ||
+                       s[len - 1] == '\n' || s[len - 1] == '\r'))
+        s[--len] = '\0';
+    return s;
+}
+
+int pol_tune_load(const char* path)
+{
+    FILE* f = fopen(tune_path(path), "r");
+    if (f == NULL)
+        return POL_IO_ERROR;
+
+    // значения применяются только если разобран весь файл
+    size_t values[TUNE_KEY_COUNT];
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        values[k] = *g_tune_keys[k].value;
+
+    char line[256];
+    int status = POL_SUCCESS;
+
+    while (status == POL_SUCCESS && fgets(line, sizeof(line), f) != NULL)
+    {
+        char* hash = strchr(line, '#');
+        if (hash != NULL)
+            *hash = '\0';
+
+        char* key = trim(line);
+        if (*key == '\0')
+            continue;
+
+        char* eq = strchr(key, '=');
+        if (eq == NULL)
+        {
+            status = POL_SYNTAX_ERROR;
+            break;
+        }
+        *eq = '\0';
+        key = trim(key);
+        char* text = trim(eq + 1);
+
+        char* end;
+        unsigned long long v = strtoull(text, &end, 10);
+        if (end == text || *end != '\0' || text[0] == '-')
+        {
+            status = POL_SYNTAX_ERROR;
+            break;
+        }
+
+        size_t k = tune_key_index(key);
+        if (k == TUNE_KEY_COUNT)
+        {
+            status = POL_SYNTAX_ERROR;
+            break;
+        }
+        values[k] = (size_t)v;
+    }
+
+    if (ferror(f))
+        status = POL_IO_ERROR;
+    fclose(f);
+
+    if (status != POL_SUCCESS)
+        return status;
+
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        *g_tune_keys[k].value = values[k];
+    return POL_SUCCESS;
+}
+
+int pol_tune_save(const char* path)
+{
+    FILE* f = fopen(tune_path(path), "w");
+    if (f == NULL)
+        return POL_IO_ERROR;
+
+    fprintf(f, "# Пороги переключения алгоритмов (pol_tune.h)\n");
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        fprintf(f, "%-13s = %zu\n", g_tune_keys[k].name, *g_tune_keys[k].value);
+
+    int status = ferror(f) ? POL_IO_ERROR : POL_SUCCESS;
+    if (fclose(f) != 0)
+        status = POL_IO_ERROR;
+    return status;
+}
+
+/*--------------------- ПОДБОР ---------------------*/
+
+/* Один замер длится не меньше TUNE_MIN_NS; берётся лучший из TUNE_ROUNDS */
+#define TUNE_MIN_NS 1000000.0
+#define TUNE_ROUNDS 5
+
+/* Наибольшие длины сравнения: последовательные алгоритмы и параллельное умножение */
+#define TUNE_SEQ_LEN 8192
+#define TUNE_MAX_LEN ((size_t)1 << 18)
+
+typedef struct TuneData
+{
+    PolModCtx ctx;
+    ULL* a;         // множители и делитель, TUNE_MAX_LEN
+    ULL* b;
+    ULL* src;       // делимое, 2 * TUNE_MAX_LEN
+    ULL* w;         // рабочая копия делимого и произведение
+    ULL* scratch;
+    size_t scratch_len;
+    PolRng rng;
+} TuneData;
+
+/* Сравниваемая операция длины n: fast = 0 — более простой алгоритм, 1 — следующий */
+typedef int (*TuneOp)(TuneData* d, size_t n, int fast);
+
+static double tune_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void tune_fill(TuneData* d, ULL modulo)
+{
+    pol_modctx_init(&d->ctx, modulo);
+
+    // постоянный seed: одни и те же данные при каждом запуске
+    pol_rng_fill(&d->rng, d->src, 2 * TUNE_MAX_LEN, modulo);
+    memcpy(d->a, d->src, TUNE_MAX_LEN * sizeof(ULL));
+    pol_rng_fill(&d->rng, d->b, TUNE_MAX_LEN, modulo);
+    d->a[TUNE_MAX_LEN - 1] = 1;
+}
+
+/* Рабочий буфер растёт по мере надобности; 0 — нехватка памяти */
+static int tune_scratch(TuneData* d, size_t need)
+{
+    if (need <= d->scratch_len)
+        return 1;
+
+    ULL* p = malloc(need * sizeof(ULL));
+    if (p == NULL)
+        return 0;
+
+    if (d->scratch != NULL)
+        free(d->scratch, d->scratch_len * sizeof(ULL));
+    d->scratch = p;
+    d->scratch_len = need;
+    return 1;
+}
+
+static int op_karatsuba(TuneData* d, size_t n, int fast)
+{
+    // один уровень Карацубы над школьными половинами против школьного умножения
+    g_karatsuba_threshold = fast ? n - n / 2 : n;
+    if (!tune_scratch(d, mul_coeffs_scratch_size(n, n, &d->ctx)))
+        return POL_MEMORY_ERROR;
+    return mul_coeffs_ws(d->a, n, d->b, n, d->w, d->scratch, &d->ctx);
+}
+
+static int op_ntt(TuneData* d, size_t n, int fast)
+{
+    g_ntt_threshold = fast ? 0 : SIZE_MAX;
+    if (!tune_scratch(d, mul_coeffs_scratch_size(n, n, &d->ctx)))
+        return POL_MEMORY_ERROR;
+    return mul_coeffs_ws(d->a, n, d->b, n, d->w, d->scratch, &d->ctx);
+}
+
+static int op_ntt_crt(TuneData* d, size_t n, int fast)
+{
+    g_ntt_crt_threshold = fast ? 0 : SIZE_MAX;
+    if (!tune_scratch(d, mul_coeffs_scratch_size(n, n, &d->ctx)))
+        return POL_MEMORY_ERROR;
+    return mul_coeffs_ws(d->a, n, d->b, n, d->w, d->scratch, &d->ctx);
+}
+
+static int op_newton(TuneData* d, size_t n, int fast)
+{
+    // частное и делитель длины n; делитель плотный, так что разреженный путь не включается
+    size_t* threshold = (ntt_length(d->ctx.modulo, n, n) != 0) ? &g_newton_threshold
+                                                               : &g_newton_crt_threshold;
+    *threshold = fast ? 0 : SIZE_MAX;
+    if (!tune_scratch(d, rem_coeffs_scratch_size(2 * n - 1, n, &d->ctx)))
+        return POL_MEMORY_ERROR;
+
+    memcpy(d->w, d->src, (2 * n - 1) * sizeof(ULL));
+    return rem_coeffs_ws(d->w, 2 * n - 1, d->a + TUNE_MAX_LEN - n, n, d->scratch, &d->ctx);
+}
+
+static int op_parallel(TuneData* d, size_t n, int fast)
+{
+    g_par_threshold = fast ? 0 : SIZE_MAX;
+    if (!tune_scratch(d, mul_coeffs_scratch_size(n, n, &d->ctx)))
+        return POL_MEMORY_ERROR;
+    return mul_coeffs_ws(d->a, n, d->b, n, d->w, d->scratch, &d->ctx);
+}
+
+/*
+ * Упакованное умножение над GF(2) без приведения: n слов на множитель,
+ * модуль длиннее произведения. Порог Карацубы здесь строгий (n < порога —
+ * школьное), поэтому одному уровню Карацубы соответствует порог n - n/2 + 1.
+ */
+static int op_gf2_karatsuba(TuneData* d, size_t n, int fast)
+{
+    size_t na = 64 * n, nm = 2 * na;
+    g_gf2_karatsuba_threshold = fast ? n - n / 2 + 1 : n + 1;
+    if (!tune_scratch(d, pol_gf2_mul_mod_coeffs_scratch_size(na, na, nm)))
+        return POL_MEMORY_ERROR;
+    pol_gf2_mul_mod_coeffs(d->a, na, d->b, na, d->src + 2 * TUNE_MAX_LEN - nm, nm, d->scratch);
+    return POL_SUCCESS;
+}
+
+/* (A * B) mod M над GF(2) с частным из n бит; M из src — плотный, без разреженного пути */
+static int op_gf2_newton(TuneData* d, size_t n, int fast)
+{
+    g_gf2_newton_threshold = fast ? 0 : SIZE_MAX;
+    if (!tune_scratch(d, pol_gf2_mul_mod_coeffs_scratch_size(n, n, n)))
+        return POL_MEMORY_ERROR;
+    pol_gf2_mul_mod_coeffs(d->a, n, d->b, n, d->src + 2 * TUNE_MAX_LEN - n, n, d->scratch);
+    return POL_SUCCESS;
+}
+
+/* Время одного вызова, нс: не меньше TUNE_MIN_NS повторений подряд */
+static double tune_time(TuneOp op, TuneData* d, size_t n, int fast)
+{
+    size_t calls = 0;
+    double start = tune_now();
+    double elapsed;
+    do
+    {
+        op(d, n, fast);
+        calls++;
+        elapsed = tune_now() - start;
+    } while (elapsed < TUNE_MIN_NS);
+
+    return elapsed / (double)calls;
+}
+
+/*
+ * Лучшее время обоих вариантов; замеры чередуются, чтобы помехи
+ * (частота процессора, соседние процессы) доставались обоим поровну.
+ */
+static int tune_compare(TuneOp op, TuneData* d, size_t n, double* slow, double* fast)
+{
+    // прогрев: таблицы корней, рабочий буфер
+    int status = op(d, n, 0);
+    if (status == POL_SUCCESS)
+        status = op(d, n, 1);
+    if (status != POL_SUCCESS)
+        return status;
+
+    for (int round = 0; round < TUNE_ROUNDS; round++)
+    {
+        double t_slow = tune_time(op, d, n, 0);
+        double t_fast = tune_time(op, d, n, 1);
+        if (round == 0 || t_slow < *slow) *slow = t_slow;
+        if (round == 0 || t_fast < *fast) *fast = t_fast;
+    }
+    return POL_SUCCESS;
+}
+
+/* Наибольшее число точек сетки длин */
+#define TUNE_MAX_POINTS 64
+
+/*
+ * Порог для пары алгоритмов на сетке lo, lo * 5/4, ..., hi. Стоимость NTT
+ * растёт скачками на степенях двойки, поэтому кривые могут пересекаться
+ * несколько раз: берётся порог с наименьшей суммой относительных потерь
+ * sum t(n) / min(slow(n), fast(n)) по всей сетке. Сетка обрывается, когда
+ * fast дважды подряд быстрее вдвое — дальше он только выигрывает.
+ */
+static int tune_crossover(const char* name, TuneOp op, TuneData* d,
+                          size_t lo, size_t hi, size_t* result, FILE* log)
+{
+    size_t len[TUNE_MAX_POINTS];
+    double slow[TUNE_MAX_POINTS], fast[TUNE_MAX_POINTS];
+    size_t count = 0;
+    size_t clear_wins = 0;
+
+    for (size_t n = lo; n <= hi && count < TUNE_MAX_POINTS && clear_wins < 2;
+         n += (n / 4 > 0) ? n / 4 : 1)
+    {
+        int status = tune_compare(op, d, n, &slow[count], &fast[count]);
+        if (status != POL_SUCCESS)
+            return status;
+
+        if (log != NULL)
+            fprintf(log, "  %-10s n = %-6zu %12.0f нс %12.0f нс\n", name, n,
+                    slow[count], fast[count]);
+
+        clear_wins = (2 * fast[count] < slow[count]) ? clear_wins + 1 : 0;
+        len[count++] = n;
+    }
+
+    // порог t: простой алгоритм для точек 0 .. t-1, fast для остальных
+    size_t best_t = 0;
+    double best_loss = 0;
+    for (size_t t = 0; t <= count; t++)
+    {
+        double loss = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            double chosen = (i < t) ? slow[i] : fast[i];
+            double ideal = (slow[i] < fast[i]) ? slow[i] : fast[i];
+            loss += chosen / ideal;
+        }
+        if (t == 0 || loss < best_loss)
+        {
+            best_t = t;
+            best_loss = loss;
+        }
+    }
+
+    if (best_t == count && clear_wins < 2)
+        *result = hi;               // fast не выиграл на всей сетке
+    else
+        *result = (best_t == 0) ? lo - 1 : len[best_t - 1];
+    return POL_SUCCESS;
+}
+
+/*
+ * tune_crossover для ключа name: результат — в found[номер ключа] и сразу
+ * в сам порог, чтобы следующие замеры шли уже с ним.
+ */
+static int tune_key(const char* name, TuneOp op, TuneData* d, size_t lo, size_t hi,
+                    size_t* found, FILE* log)
+{
+    size_t k = tune_key_index(name);
+    if (k == TUNE_KEY_COUNT)
+        return POL_INVALID_ARG;
+
+    int status = tune_crossover(name, op, d, lo, hi, &found[k], log);
+    if (status == POL_SUCCESS)
+        *g_tune_keys[k].value = found[k];
+    return status;
+}
+
+int pol_tune_run(FILE* log)
+{
+    size_t saved[TUNE_KEY_COUNT];
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        saved[k] = *g_tune_keys[k].value;
+
+    TuneData d;
+    memset(&d, 0, sizeof(d));
+    pol_rng_seed(&d.rng, 1);
+    d.a = malloc(TUNE_MAX_LEN * sizeof(ULL));
+    d.b = malloc(TUNE_MAX_LEN * sizeof(ULL));
+    d.src = malloc(2 * TUNE_MAX_LEN * sizeof(ULL));
+    d.w = malloc(2 * TUNE_MAX_LEN * sizeof(ULL));
+
+    size_t found[TUNE_KEY_COUNT];
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        found[k] = saved[k];
+
+    int status = (d.a && d.b && d.src && d.w) ? POL_SUCCESS : POL_MEMORY_ERROR;
+
+    // умножение без NTT и параллельности: школьное -> Карацуба
+    g_ntt_threshold = g_ntt_crt_threshold = g_par_threshold = SIZE_MAX;
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 1000000007ULL);
+        status = tune_key("karatsuba", op_karatsuba, &d, 8, 512, found, log);
+    }
+
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 998244353ULL);
+        status = tune_key("ntt", op_ntt, &d, 8, 2048, found, log);
+    }
+
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 1000000007ULL);
+        status = tune_key("ntt_crt", op_ntt_crt, &d, 16, TUNE_SEQ_LEN, found, log);
+    }
+
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 998244353ULL);
+        status = tune_key("newton", op_newton, &d, 32, TUNE_SEQ_LEN, found, log);
+    }
+
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 1000000007ULL);
+        status = tune_key("newton_crt", op_newton, &d, 32, TUNE_SEQ_LEN, found, log);
+    }
+
+    // над GF(2): школьное -> Карацуба по словам, деление сдвигами -> Ньютон
+    if (status == POL_SUCCESS)
+    {
+        tune_fill(&d, 2);
+        for (size_t i = 2 * TUNE_MAX_LEN - TUNE_SEQ_LEN; i < 2 * TUNE_MAX_LEN; i++)
+            d.src[i] = 1;
+
+        // оба порога строгие: быстрый алгоритм — начиная со следующей длины
+        status = tune_key("gf2_karatsuba", op_gf2_karatsuba, &d, 2, 256, found, log);
+        if (status == POL_SUCCESS)
+        {
+            g_gf2_karatsuba_threshold = ++found[tune_key_index("gf2_karatsuba")];
+            status = tune_key("gf2_newton", op_gf2_newton, &d, 8, TUNE_SEQ_LEN, found, log);
+        }
+        if (status == POL_SUCCESS)
+            g_gf2_newton_threshold = ++found[tune_key_index("gf2_newton")];
+    }
+
+    // в одном потоке параллельный порог не на чем мерить — остаётся прежним
+    if (status == POL_SUCCESS && pol_get_num_threads() > 1)
+    {
+        tune_fill(&d, 998244353ULL);
+        status = tune_key("parallel", op_parallel, &d, POL_PAR_GRAIN, TUNE_MAX_LEN, found, log);
+    }
+
+    if (d.scratch != NULL) free(d.scratch, d.scratch_len * sizeof(ULL));
+    if (d.a != NULL) free(d.a, TUNE_MAX_LEN * sizeof(ULL));
+    if (d.b != NULL) free(d.b, TUNE_MAX_LEN * sizeof(ULL));
+    if (d.src != NULL) free(d.src, 2 * TUNE_MAX_LEN * sizeof(ULL));
+    if (d.w != NULL) free(d.w, 2 * TUNE_MAX_LEN * sizeof(ULL));
+
+    for (size_t k = 0; k < TUNE_KEY_COUNT; k++)
+        *g_tune_keys[k].value = (status == POL_SUCCESS) ? found[k] : saved[k];
+    return status;
+}
@@ -1,21 +1,46 @@
 #include "../include/polynomial.h"
+#include "../include/pol_mul.h"
+#include "../include/pol_arith.h"
+#include "../include/pol_simd.h"
+#include "../include/pol_div.h"
+#include "../include/ntt.h"
+#include "../include/pol_par.h"
+#include "../include/pol_gf2.h"
 #include "../include/mem_tracker.h"
 
 /*--------------------- ВСПОМОГАТЕЛЬНЫЕ ОПЕРАЦИИ ---------------------*/
 
 int realloc_coeffs(Polynomial* R, size_t required_degree)
 {
-    if (R->coeffs == NULL || R->degree < required_degree)
-    {
-        ULL *new_coeffs = calloc(required_degree + 1, sizeof(ULL));
-        if (new_coeffs == NULL)
-            return POL_MEMORY_ERROR;
+    size_t need = required_degree + 1;
+    if (R->coeffs != NULL && R->capacity >= need)
+        return POL_SUCCESS;
+
+    size_t capacity = R->capacity + R->capacity / 2;
+    if (capacity < need)
+        capacity = need;
 
-        if (R->coeffs != NULL)
-            free(R->coeffs, (R->degree + 1) * sizeof(ULL));
+    ULL *new_coeffs = calloc(capacity, sizeof(ULL));
+    if (new_coeffs == NULL)
+        return POL_MEMORY_ERROR;
 
-        R->coeffs = new_coeffs;
+    if (R->coeffs != NULL)
+    {
+        // чужой массив (capacity == 0) имеет как минимум degree + 1 элементов;
+        // новый буфер может быть короче старых данных
+        size_t keep = R->degree + 1;
+        if (R->capacity != 0 && keep > R->capacity)
+            keep = R->capacity;
+        if (keep > capacity)
+            keep = capacity;
+        memcpy(new_coeffs, R->coeffs, keep * sizeof(ULL));
+
+        if (R->capacity != 0)
+            free(R->coeffs, R->capacity * sizeof(ULL));
     }
+
+    R->coeffs = new_coeffs;
+    R->capacity = capacity;
     return POL_SUCCESS;
 }
 
@@ -54,25 +79,29 @@ ULL egcd(ULL a, ULL b, long long *x, long long *y)
     return a;   /* gcd */
 }
 
-/* Обратный по модулю М */
+/* Обратный по модулю М: расширенный Евклид с коэффициентами, хранимыми по модулю m */
 int modulo_inverse(ULL a, ULL m, ULL *inv)
 {
-    long long x, y;
+    ULL r0 = m, r1 = a % m;
+    ULL t0 = 0, t1 = 1;     // t_i * a = r_i (mod m)
 
-    ULL g = egcd(a, m, &x, &y);
+    while (r1 != 0)
+    {
+        ULL q = r0 / r1;
 
-    if (g != 1)
-        return POL_NO_INVERSE;
+        ULL tmp_r = r0 - q * r1;
+        r0 = r1;
+        r1 = tmp_r;
 
-    if (m > LLONG_MAX)
-        return POL_NO_INVERSE;  // Слишком большой модуль
+        ULL tmp_t = sub_mod(t0, mul_mod(q % m, t1, m), m);
+        t0 = t1;
+        t1 = tmp_t;
+    }
 
-    long long m_ll = (long long)m;
-    long long res = x % m_ll;
-    if (res < 0)
-        res += m_ll;
+    if (r0 != 1)
+        return POL_NO_INVERSE;
 
-    *inv = (ULL)res;
+    *inv = t0;
     return POL_SUCCESS;
 }
 
@@ -93,6 +122,45 @@ void print_polynomial(const Polynomial* p, const char* name)
     printf("]\n");
 }
 
+int pol_modctx_init(PolModCtx* ctx, ULL modulo)
+{
+    if (ctx == NULL)
+        return POL_NULL_PTR;
+
+    if (modulo <= 1)
+        return POL_INVALID_MODULO;
+
+    ctx->modulo = modulo;
+    ctx->barrett = 0;
+    ctx->mont_inv = 0;
+    ctx->mont_r2 = 0;
+
+    if (modulo <= 0xFFFFFFFFULL)
+    {
+        ctx->kind = POL_RED_BARRETT;
+        ctx->barrett = ~0ULL / modulo;
+    }
+    else if (modulo & 1)
+    {
+        ctx->kind = POL_RED_MONTGOMERY;
+
+        // Ньютон: m * m = 1 (mod 8), каждый шаг удваивает число верных битов
+        ULL inv = modulo;
+        for (int i = 0; i < 5; i++)
+            inv *= 2 - modulo * inv;
+        ctx->mont_inv = inv;
+
+        ULL r = (0 - modulo) % modulo;   // 2^64 mod m
+        ctx->mont_r2 = mul_mod(r, r, modulo);
+    }
+    else
+    {
+        ctx->kind = POL_RED_GENERIC;
+    }
+
+    return POL_SUCCESS;
+}
+
 /*--------------------- БАЗОВЫЕ ОПЕРАЦИИ ---------------------*/
 
 int new_pol(Polynomial *p, const size_t degree, const ULL modulo)
@@ -110,9 +178,11 @@ int new_pol(Polynomial *p, const size_t degree, const ULL modulo)
     p->coeffs = calloc(degree + 1, sizeof(ULL));
     if (p->coeffs == NULL)
     {
+        p->capacity = 0;
         return POL_MEMORY_ERROR;
     }
 
+    p->capacity = degree + 1;
     set_pol_params(p, degree, modulo);
 
     return POL_SUCCESS;
@@ -125,12 +195,13 @@ void free_pol(Polynomial *p)
         return;
     }
 
-    if (p->coeffs != NULL)
+    if (p->coeffs != NULL && p->capacity != 0)
     {
-        free(p->coeffs, (p->degree + 1) * sizeof(ULL));
-        p->coeffs = NULL;
+        free(p->coeffs, p->capacity * sizeof(ULL));
     }
 
+    p->coeffs = NULL;
+    p->capacity = 0;
     set_pol_params(p, 0, 0);
 }
 
@@ -139,10 +210,13 @@ int copy_pol(const Polynomial *src, Polynomial *dst)
     if (src == NULL || dst == NULL)
         return POL_NULL_PTR;
 
-    realloc_coeffs(dst,src->degree);
+    if (src == dst)
+        return POL_SUCCESS;
+
+    if (realloc_coeffs(dst, src->degree) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
 
-    for (size_t i = 0; i <= src->degree; i++)
-        dst->coeffs[i] = src->coeffs[i];
+    memcpy(dst->coeffs, src->coeffs, (src->degree + 1) * sizeof(ULL));
 
     set_pol_params(dst, src->degree, src->modulo);
 
@@ -156,18 +230,123 @@ int normalize_pol(Polynomial *p)
         return POL_NULL_PTR;
     }
 
-    if (p->modulo <= 1)
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, p->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return normalize_pol_ctx(p, &ctx);
+}
+
+int sum_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return sum_pol_ctx(A, B, R, &ctx);
+}
+
+int sub_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return sub_pol_ctx(A, B, R, &ctx);
+}
+
+int scalar_mul_pol(const Polynomial* A, ULL k, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return scalar_mul_pol_ctx(A, k, R, &ctx);
+}
+
+int dot_pol(const Polynomial* A, const Polynomial* B, ULL* result)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return dot_pol_ctx(A, B, result, &ctx);
+}
+
+int pol_mul_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return pol_mul_pol_ctx(A, B, R, &ctx);
+}
+
+/* Остаток полиномиального деления: R = A modulo M */
+int modulo_unit_pol(const Polynomial* A, const Polynomial* M, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return modulo_unit_pol_ctx(A, M, R, &ctx);
+}
+
+int pol_mul_mod_unit(const Polynomial* A, const Polynomial* B,
+                      const Polynomial* M, Polynomial* R)
+{
+    if (A == NULL)
+        return POL_NULL_PTR;
+
+    PolModCtx ctx;
+    int status = pol_modctx_init(&ctx, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
+
+    return pol_mul_mod_unit_ctx(A, B, M, R, &ctx);
+}
+
+/*------------------ ОПЕРАЦИИ С КОНТЕКСТОМ МОДУЛЯ ------------------*/
+
+int normalize_pol_ctx(Polynomial *p, const PolModCtx* ctx)
+{
+    if (p == NULL || ctx == NULL)
     {
-        return POL_INVALID_MODULO;
+        return POL_NULL_PTR;
     }
 
-    ULL m = p->modulo;
-
-    for (size_t i = 0; i <= p->degree; i++)
+    if (p->modulo != ctx->modulo)
     {
-        p->coeffs[i] = p->coeffs[i] % m;
+        return POL_MODULO_MISMATCH;
     }
 
+    pol_vec_ops()->reduce(p->coeffs, p->coeffs, p->degree + 1, ctx);
+
     while (p->degree > 0 && p->coeffs[p->degree] == 0)
     {
         p->degree--;
@@ -176,93 +355,89 @@ int normalize_pol(Polynomial *p)
     return POL_SUCCESS;
 }
 
-int sum_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+int sum_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                const PolModCtx* ctx)
 {
-    if (A == NULL || B == NULL || R == NULL)
+    if (A == NULL || B == NULL || R == NULL || ctx == NULL)
     {
         return POL_NULL_PTR;
     }
 
-    if (A->modulo != B->modulo)
+    if (A->modulo != B->modulo || A->modulo != ctx->modulo)
     {
         return POL_MODULO_MISMATCH;
     }
 
-    size_t max_deg = (A->degree > B->degree) ? A->degree : B->degree;
+    size_t deg_a = A->degree, deg_b = B->degree;
+    size_t max_deg = (deg_a > deg_b) ? deg_a : deg_b;
+    size_t min_deg = (deg_a < deg_b) ? deg_a : deg_b;
 
-    realloc_coeffs(R, max_deg);
+    if (realloc_coeffs(R, max_deg) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
     set_pol_params(R, max_deg, A->modulo);
 
-    ULL m = R->modulo;
-
-    for (size_t i = 0; i <= max_deg; i++)
-    {
-        ULL a = (i <= A->degree) ? A->coeffs[i] : 0; // подгоняет до нужных размеров
-        ULL b = (i <= B->degree) ? B->coeffs[i] : 0;
-
-        ULL sum = (a % m + b % m) % m;
+    const PolVecOps* ops = pol_vec_ops();
+    const Polynomial* L = (deg_a > deg_b) ? A : B; // подгоняет до нужных размеров
 
-        R->coeffs[i] = sum;
-    }
+    ops->add(R->coeffs, A->coeffs, B->coeffs, min_deg + 1, ctx);
+    ops->reduce(R->coeffs + min_deg + 1, L->coeffs + min_deg + 1, max_deg - min_deg, ctx);
 
-    normalize_pol(R);
+    normalize_pol_ctx(R, ctx);
     return POL_SUCCESS;
 }
 
-int sub_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+int sub_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                const PolModCtx* ctx)
 {
-    if (A == NULL || B == NULL || R == NULL)
+    if (A == NULL || B == NULL || R == NULL || ctx == NULL)
     {
         return POL_NULL_PTR;
     }
 
-    if (A->modulo != B->modulo)
+    if (A->modulo != B->modulo || A->modulo != ctx->modulo)
     {
         return POL_MODULO_MISMATCH;
     }
 
-    size_t max_deg = (A->degree > B->degree) ? A->degree : B->degree;
+    size_t deg_a = A->degree, deg_b = B->degree;
+    size_t max_deg = (deg_a > deg_b) ? deg_a : deg_b;
+    size_t min_deg = (deg_a < deg_b) ? deg_a : deg_b;
 
-    realloc_coeffs(R, max_deg);
+    if (realloc_coeffs(R, max_deg) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
     set_pol_params(R, max_deg, A->modulo);
 
-    ULL m = R->modulo;
-    ULL diff;
+    const PolVecOps* ops = pol_vec_ops();
 
-    for (size_t i = 0; i <= max_deg; i++)
+    ops->sub(R->coeffs, A->coeffs, B->coeffs, min_deg + 1, ctx);
+    if (deg_a > deg_b)
+        ops->reduce(R->coeffs + min_deg + 1, A->coeffs + min_deg + 1, max_deg - min_deg, ctx);
+    else
     {
-        ULL a = (i <= A->degree) ? A->coeffs[i] : 0;
-        ULL b = (i <= B->degree) ? B->coeffs[i] : 0;
-
-        if (a >= b)
-        {
-            diff = (a - b) % m;
-        }
-        else
-        {
-            diff = (m - ((b - a) % m)) % m;
-        }
-
-        R->coeffs[i] = diff;
+        // 0 - b
+        for (size_t i = min_deg + 1; i <= max_deg; i++)
+            R->coeffs[i] = sub_mod(0, ctx_reduce(ctx, B->coeffs[i]), ctx->modulo);
     }
 
-    normalize_pol(R);
+    normalize_pol_ctx(R, ctx);
     return POL_SUCCESS;
 }
 
-int scalar_mul_pol(const Polynomial* A, ULL k, Polynomial* R)
+int scalar_mul_pol_ctx(const Polynomial* A, ULL k, Polynomial* R,
+                       const PolModCtx* ctx)
 {
-    if (A == NULL || R == NULL)
+    if (A == NULL || R == NULL || ctx == NULL)
     {
         return POL_NULL_PTR;
     }
 
-    if (A->modulo <= 1)
+    if (A->modulo != ctx->modulo)
     {
-        return POL_INVALID_MODULO;
+        return POL_MODULO_MISMATCH;
     }
 
-    realloc_coeffs(R, A->degree);
+    if (realloc_coeffs(R, A->degree) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
 
     // k == 0 -> 0 poly
     if (k == 0)
@@ -274,45 +449,188 @@ int scalar_mul_pol(const Polynomial* A, ULL k, Polynomial* R)
 
     set_pol_params(R, A->degree, A->modulo);
 
-    ULL m = R->modulo;
+    pol_vec_ops()->scale(R->coeffs, A->coeffs, k, A->degree + 1, ctx);
 
-    for (size_t i = 0; i <= A->degree; i++)
-        R->coeffs[i] = (A->coeffs[i] * (k % m)) % m;
+    normalize_pol_ctx(R, ctx);
+    return POL_SUCCESS;
+}
+
+int dot_pol_ctx(const Polynomial* A, const Polynomial* B, ULL* result,
+                const PolModCtx* ctx)
+{
+    if (A == NULL || B == NULL || result == NULL || ctx == NULL)
+        return POL_NULL_PTR;
+
+    if (A->modulo != B->modulo || A->modulo != ctx->modulo)
+        return POL_MODULO_MISMATCH;
 
-    normalize_pol(R);
+    size_t min_deg = (A->degree < B->degree) ? A->degree : B->degree;
+
+    *result = pol_vec_ops()->dot(A->coeffs, B->coeffs, min_deg + 1, ctx);
     return POL_SUCCESS;
 }
 
-int dot_pol(const Polynomial* A, const Polynomial* B, ULL* result)
+int pol_mul_pol_ctx(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                    const PolModCtx* ctx)
+{
+    PolWorkspace ws = { NULL, 0, 0 };
+
+    int status = pol_mul_pol_ws(A, B, R, &ws, ctx);
+
+    pol_ws_free(&ws);
+    return status;
+}
+
+int modulo_unit_pol_ctx(const Polynomial* A, const Polynomial* M, Polynomial* R,
+                        const PolModCtx* ctx)
 {
-    if (A == NULL || B == NULL || result == NULL)
+    if (A == NULL || M == NULL || R == NULL || ctx == NULL)
+    {
         return POL_NULL_PTR;
+    }
 
-    if (A->modulo != B->modulo)
+    if (A->modulo != M->modulo || A->modulo != ctx->modulo)
+    {
         return POL_MODULO_MISMATCH;
+    }
 
     ULL m = A->modulo;
-    ULL sum = 0;
 
-    size_t min_deg = (A->degree < B->degree) ? A->degree : B->degree;
+    if (M->degree == 0 && M->coeffs[0] == 0)
+    {
+        return POL_ZERO_DIV;
+    }
 
-    for (size_t i = 0; i <= min_deg; i++)
+    size_t deg_a = A->degree;
+    if (realloc_coeffs(R, deg_a) != POL_SUCCESS)
     {
-        sum = (sum + (A->coeffs[i] * B->coeffs[i]) % m) % m;
+        return POL_MEMORY_ERROR;
+    }
+
+    pol_vec_ops()->reduce(R->coeffs, A->coeffs, deg_a + 1, ctx);
+    set_pol_params(R, deg_a, m);
+
+    int status = rem_coeffs(R->coeffs, deg_a + 1, M->coeffs, M->degree + 1, ctx);
+    if (status != POL_SUCCESS)
+    {
+        return status;
+    }
+
+    while (R->degree > 0 && R->coeffs[R->degree] == 0)
+    {
+        R->degree--;
     }
 
-    *result = sum;
     return POL_SUCCESS;
 }
 
-int pol_mul_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
+int pol_mul_mod_unit_ctx(const Polynomial* A, const Polynomial* B,
+                         const Polynomial* M, Polynomial* R, const PolModCtx* ctx)
+{
+    PolWorkspace ws = { NULL, 0, 0 };
+
+    int status = pol_mul_mod_unit_ws(A, B, M, R, &ws, ctx);
+
+    pol_ws_free(&ws);
+    return status;
+}
+
+/*------------------ РАБОЧАЯ ПАМЯТЬ ------------------*/
+
+int pol_ws_init(PolWorkspace* ws, size_t capacity)
 {
-    if (A == NULL || B == NULL || R == NULL)
+    if (ws == NULL)
+        return POL_NULL_PTR;
+
+    ws->base = NULL;
+    ws->capacity = 0;
+    ws->used = 0;
+
+    return (capacity > 0) ? pol_ws_reserve(ws, capacity) : POL_SUCCESS;
+}
+
+void pol_ws_free(PolWorkspace* ws)
+{
+    if (ws == NULL)
+        return;
+
+    if (ws->base != NULL)
+        free(ws->base, ws->capacity * sizeof(ULL));
+
+    ws->base = NULL;
+    ws->capacity = 0;
+    ws->used = 0;
+}
+
+void pol_ws_reset(PolWorkspace* ws)
+{
+    if (ws != NULL)
+        ws->used = 0;
+}
+
+int pol_ws_reserve(PolWorkspace* ws, size_t capacity)
+{
+    if (ws == NULL)
+        return POL_NULL_PTR;
+
+    if (ws->capacity >= capacity)
+        return POL_SUCCESS;
+
+    if (ws->used != 0)
+        return POL_INVALID_ARG;
+
+    ULL* base = malloc(capacity * sizeof(ULL));
+    if (base == NULL)
+        return POL_MEMORY_ERROR;
+
+    if (ws->base != NULL)
+        free(ws->base, ws->capacity * sizeof(ULL));
+
+    ws->base = base;
+    ws->capacity = capacity;
+    return POL_SUCCESS;
+}
+
+ULL* pol_ws_alloc(PolWorkspace* ws, size_t n)
+{
+    if (ws == NULL || n == 0 || ws->capacity - ws->used < n)
+        return NULL;
+
+    ULL* p = ws->base + ws->used;
+    ws->used += n;
+    return p;
+}
+
+/* Начало операции: не меньше need свободных элементов (пустая арена расширяется) */
+static int ws_begin(PolWorkspace* ws, size_t need)
+{
+    if (ws->capacity - ws->used >= need)
+        return POL_SUCCESS;
+
+    return (ws->used == 0) ? pol_ws_reserve(ws, need) : POL_MEMORY_ERROR;
+}
+
+/* R совпадает с A или B (или разделяет с ними массив коэффициентов) */
+static int pol_aliases(const Polynomial* R, const Polynomial* A, const Polynomial* B)
+{
+    return R == A || R == B ||
+           (R->coeffs != NULL && (R->coeffs == A->coeffs || R->coeffs == B->coeffs));
+}
+
+size_t pol_mul_pol_ws_size(size_t deg_a, size_t deg_b, const PolModCtx* ctx)
+{
+    return (deg_a + deg_b + 1) + mul_coeffs_scratch_size(deg_a + 1, deg_b + 1, ctx);
+}
+
+int pol_mul_pol_ws(const Polynomial* A, const Polynomial* B, Polynomial* R,
+                   PolWorkspace* ws, const PolModCtx* ctx)
+{
+    if (A == NULL || B == NULL || R == NULL || ws == NULL || ctx == NULL)
     {
         return POL_NULL_PTR;
     }
 
-    if (A->modulo != B->modulo)
+    if (A->modulo != B->modulo || A->modulo != ctx->modulo)
         return POL_MODULO_MISMATCH;
 
     int is_A_zero = (A->degree == 0 && A->coeffs[0] == 0);
@@ -320,127 +638,647 @@ int pol_mul_pol(const Polynomial* A, const Polynomial* B, Polynomial* R)
 
     if (is_A_zero || is_B_zero)
     {
+        if (realloc_coeffs(R, 0) != POL_SUCCESS)
+            return POL_MEMORY_ERROR;
         set_pol_params(R, 0, A->modulo);
         R->coeffs[0] = 0;
         return POL_SUCCESS;
     }
 
+    size_t na = A->degree + 1, nb = B->degree + 1;
     size_t result_degree = A->degree + B->degree;
+    size_t scratch_len = mul_coeffs_scratch_size(na, nb, ctx);
 
-    ULL* temp_coeffs = calloc(result_degree + 1, sizeof(ULL));
-    if (temp_coeffs == NULL) return POL_MEMORY_ERROR;
+    // без пересечения с A и B произведение пишется сразу в R
+    int alias = pol_aliases(R, A, B);
+    size_t temp_len = alias ? result_degree + 1 : 0;
 
-    ULL m = A->modulo;
+    if (!alias && realloc_coeffs(R, result_degree) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
 
-    for (size_t i = 0; i <= A->degree; i++)
-    {
-        ULL a = A->coeffs[i];
-        if (a == 0) continue;
+    size_t mark = ws->used;
+    int status = ws_begin(ws, temp_len + scratch_len);
+    if (status != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
 
-        for (size_t j = 0; j <= B->degree; j++)
-        {
-            ULL b = B->coeffs[j];
-            if (b == 0) continue;
+    ULL* out = alias ? pol_ws_alloc(ws, temp_len) : R->coeffs;
+    ULL* scratch = pol_ws_alloc(ws, scratch_len);
 
-            temp_coeffs[i + j] = (temp_coeffs[i + j] + (a * b) % m) % m;
-        }
+    status = mul_coeffs_ws(A->coeffs, na, B->coeffs, nb, out, scratch, ctx);
+    if (status == POL_SUCCESS && alias)
+    {
+        status = realloc_coeffs(R, result_degree);
+        if (status == POL_SUCCESS)
+            memcpy(R->coeffs, out, temp_len * sizeof(ULL));
     }
+    ws->used = mark;
 
-    set_pol_params(R, result_degree, A->modulo);
+    if (status != POL_SUCCESS)
+        return status;
 
-    for (size_t i = 0; i <= result_degree; i++)
-        R->coeffs[i] = temp_coeffs[i];
+    // коэффициенты произведения уже приведены
+    set_pol_params(R, result_degree, A->modulo);
+    while (R->degree > 0 && R->coeffs[R->degree] == 0)
+        R->degree--;
 
-    free(temp_coeffs, (result_degree + 1) * sizeof(ULL));
-    normalize_pol(R);
     return POL_SUCCESS;
 }
 
-/* Остаток полиномиального деления: R = A modulo M */
-int modulo_unit_pol(const Polynomial* A, const Polynomial* M, Polynomial* R)
+size_t pol_mul_mod_unit_ws_size(size_t deg_a, size_t deg_b, size_t deg_m,
+                                const PolModCtx* ctx)
+{
+    if (ctx->modulo == 2)
+        return pol_gf2_mul_mod_coeffs_scratch_size(deg_a + 1, deg_b + 1, deg_m + 1);
+
+    size_t nt = deg_a + deg_b + 1;
+    size_t s_mul = mul_coeffs_scratch_size(deg_a + 1, deg_b + 1, ctx);
+    size_t s_rem = rem_coeffs_scratch_size(nt, deg_m + 1, ctx);
+
+    return nt + ((s_mul > s_rem) ? s_mul : s_rem);
+}
+
+/* pol_mul_mod_unit_ws над GF(2): по биту на коэффициент вместо ULL (pol_gf2.h) */
+static int mul_mod_unit_gf2(const Polynomial* A, const Polynomial* B,
+                            const Polynomial* M, Polynomial* R, PolWorkspace* ws)
 {
-    if (A == NULL || M == NULL || R == NULL)
+    size_t na = A->degree + 1, nb = B->degree + 1, nm = M->degree + 1;
+    size_t nt = na + nb - 1;
+    size_t need = pol_gf2_mul_mod_coeffs_scratch_size(na, nb, nm);
+
+    size_t mark = ws->used;
+    int status = ws_begin(ws, need);
+    if (status != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    // остаток упакован в арене: R перевыделяется, когда A и B уже прочитаны
+    ULL* scratch = pol_ws_alloc(ws, need);
+    const ULL* rw = pol_gf2_mul_mod_coeffs(A->coeffs, na, B->coeffs, nb, M->coeffs, nm, scratch);
+
+    size_t nr = (nt < nm - 1) ? nt : nm - 1;
+    status = realloc_coeffs(R, (nr > 0) ? nr - 1 : 0);
+    if (status == POL_SUCCESS)
     {
+        set_pol_params(R, (nr > 0) ? nr - 1 : 0, 2);
+        if (nr > 0)
+            pol_gf2_unpack(rw, nr, R->coeffs);
+        else
+            R->coeffs[0] = 0;
+
+        while (R->degree > 0 && R->coeffs[R->degree] == 0)
+            R->degree--;
+    }
+
+    ws->used = mark;
+    return status;
+}
+
+int pol_mul_mod_unit_ws(const Polynomial* A, const Polynomial* B,
+                        const Polynomial* M, Polynomial* R,
+                        PolWorkspace* ws, const PolModCtx* ctx)
+{
+    if (A == NULL || B == NULL || M == NULL || R == NULL || ws == NULL || ctx == NULL)
         return POL_NULL_PTR;
+
+    if (A->modulo != B->modulo || A->modulo != M->modulo || A->modulo != ctx->modulo)
+        return POL_MODULO_MISMATCH;
+
+    if (M->degree == 0 && M->coeffs[0] == 0)
+        return POL_ZERO_DIV;
+
+    if (M->coeffs[M->degree] != 1)
+        return POL_INVALID_ARG;
+
+    size_t na = A->degree + 1, nb = B->degree + 1;
+    size_t nt = na + nb - 1;
+    size_t nm = M->degree + 1;
+
+    if (ctx->modulo == 2)
+        return mul_mod_unit_gf2(A, B, M, R, ws);
+
+    size_t s_mul = mul_coeffs_scratch_size(na, nb, ctx);
+    size_t s_rem = 0;
+    if (sparse_weight(M->coeffs, nm, POL_SPARSE_MAX_WEIGHT, ctx) > POL_SPARSE_MAX_WEIGHT)
+        s_rem = rem_coeffs_scratch_size(nt, nm, ctx);
+    size_t scratch_len = (s_mul > s_rem) ? s_mul : s_rem;
+
+    size_t mark = ws->used;
+    int status = ws_begin(ws, nt + scratch_len);
+    if (status != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    // T = A * B и остаток на месте в арене; R записывается в конце, поэтому может совпадать с A или B
+    ULL* t = pol_ws_alloc(ws, nt);
+    ULL* scratch = pol_ws_alloc(ws, scratch_len);
+
+    status = mul_coeffs_ws(A->coeffs, na, B->coeffs, nb, t, scratch, ctx);
+    if (status == POL_SUCCESS)
+        status = rem_coeffs_ws(t, nt, M->coeffs, nm, scratch, ctx);
+
+    size_t nr = (nt < nm - 1) ? nt : nm - 1;
+    if (status == POL_SUCCESS)
+        status = realloc_coeffs(R, (nr > 0) ? nr - 1 : 0);
+
+    if (status == POL_SUCCESS)
+    {
+        set_pol_params(R, (nr > 0) ? nr - 1 : 0, A->modulo);
+        if (nr > 0)
+            memcpy(R->coeffs, t, nr * sizeof(ULL));
+        else
+            R->coeffs[0] = 0;
+
+        while (R->degree > 0 && R->coeffs[R->degree] == 0)
+            R->degree--;
     }
 
-    if (A->modulo != M->modulo)
+    ws->used = mark;
+    return status;
+}
+
+/*------------------ ПРИВЕДЕНИЕ ПО ФИКСИРОВАННОМУ МОДУЛЮ ------------------*/
+
+static void release_coeffs(ULL** p, size_t len)
+{
+    if (*p != NULL)
+        free(*p, len * sizeof(ULL));
+    *p = NULL;
+}
+
+/* Гарантирует рабочий буфер контекста не меньше len элементов */
+static int modulus_reserve(PolModulusCtx* ctx, size_t len)
+{
+    if (ctx->work_len >= len)
+        return POL_SUCCESS;
+
+    ULL* work = malloc(len * sizeof(ULL));
+    if (work == NULL)
+        return POL_MEMORY_ERROR;
+
+    release_coeffs(&ctx->work, ctx->work_len);
+    ctx->work = work;
+    ctx->work_len = len;
+    return POL_SUCCESS;
+}
+
+static size_t pow2_at_least(size_t n)
+{
+    size_t len = 2;
+    while (len < n)
+        len <<= 1;
+    return len;
+}
+
+/* Образ длины len массива a (свёрнутого по модулю x^len - 1), подготовленный под ctx_mul_prep */
+static int prepared_transform(const ULL* a, size_t na, size_t len, const PolModCtx* mc,
+                              ULL** out)
+{
+    ULL* hat = calloc(len, sizeof(ULL));
+    if (hat == NULL)
+        return POL_MEMORY_ERROR;
+
+    for (size_t i = 0; i < na; i++)
+        hat[i % len] = add_mod(hat[i % len], a[i], mc->modulo);
+
+    int status = ntt_transform(hat, len, mc->modulo);
+    if (status != POL_SUCCESS)
     {
-        return POL_MODULO_MISMATCH;
+        free(hat, len * sizeof(ULL));
+        return status;
     }
 
-    ULL m = A->modulo;
+    for (size_t i = 0; i < len; i++)
+        hat[i] = ctx_prep(mc, hat[i]);
+
+    *out = hat;
+    return POL_SUCCESS;
+}
+
+void pol_modulus_free(PolModulusCtx* ctx)
+{
+    if (ctx == NULL)
+        return;
+
+    if (ctx->m != NULL)
+        release_coeffs(&ctx->m, ctx->degree + 1);
+    if (ctx->inv != NULL)
+        release_coeffs(&ctx->inv, ctx->degree - 1);
+    release_coeffs(&ctx->inv_hat, ctx->ntt_len);
+    release_coeffs(&ctx->m_hat, ctx->ntt_len_low);
+    release_coeffs(&ctx->work, ctx->work_len);
+
+    ctx->ntt_len = 0;
+    ctx->ntt_len_low = 0;
+    ctx->work_len = 0;
+}
+
+/* Обратный ряд rev(M)^(-1) mod x^(n-1) и, для NTT, образы inv и M */
+static int modulus_build_inverse(PolModulusCtx* ctx, int use_ntt)
+{
+    const PolModCtx* mc = &ctx->mod;
+    size_t n = ctx->degree;
+    size_t nq = n - 1;
+
+    size_t work_len = use_ntt ? 2 * pow2_at_least(2 * n - 1) + pow2_at_least(n)
+                              : 6 * n + mul_coeffs_scratch_size(n, n, mc);
+
+    int status = modulus_reserve(ctx, work_len);
+    if (status != POL_SUCCESS)
+        return status;
+
+    ctx->inv = malloc(nq * sizeof(ULL));
+    if (ctx->inv == NULL)
+        return POL_MEMORY_ERROR;
+
+    // rev(M) во временном буфере: нужны только первые nq членов
+    for (size_t i = 0; i < nq; i++)
+        ctx->work[i] = ctx->m[n - i];
+
+    status = inv_series(ctx->work, nq, nq, ctx->inv, mc);
+    if (status != POL_SUCCESS || !use_ntt)
+        return status;
+
+    size_t l2 = pow2_at_least(2 * n - 1);
+    status = prepared_transform(ctx->inv, nq, l2, mc, &ctx->inv_hat);
+    if (status != POL_SUCCESS)
+        return status;
+    ctx->ntt_len = l2;
+
+    size_t l1 = pow2_at_least(n);
+    status = prepared_transform(ctx->m, n + 1, l1, mc, &ctx->m_hat);
+    if (status != POL_SUCCESS)
+        return status;
+    ctx->ntt_len_low = l1;
+
+    return POL_SUCCESS;
+}
+
+int pol_modulus_init(PolModulusCtx* ctx, const Polynomial* M)
+{
+    if (ctx == NULL || M == NULL)
+        return POL_NULL_PTR;
+
+    ctx->m = ctx->inv = ctx->inv_hat = ctx->m_hat = ctx->work = NULL;
+    ctx->degree = ctx->ntt_len = ctx->ntt_len_low = ctx->work_len = 0;
+
+    int status = pol_modctx_init(&ctx->mod, M->modulo);
+    if (status != POL_SUCCESS)
+        return status;
 
     if (M->degree == 0 && M->coeffs[0] == 0)
-    {
         return POL_ZERO_DIV;
+
+    if (M->coeffs[M->degree] != 1)
+        return POL_INVALID_ARG;
+
+    const PolModCtx* mc = &ctx->mod;
+    size_t n = M->degree;
+
+    ctx->m = malloc((n + 1) * sizeof(ULL));
+    if (ctx->m == NULL)
+        return POL_MEMORY_ERROR;
+    ctx->degree = n;
+    pol_vec_ops()->reduce(ctx->m, M->coeffs, n + 1, mc);
+
+    // A * B имеет не больше 2n - 1 коэффициентов, частное — не больше n - 1
+    unsigned max_log = ntt_max_log(mc->modulo);
+    int use_ntt = n >= 2 && n > g_ntt_threshold && max_log > 0 && max_log < 64 &&
+                  pow2_at_least(2 * n - 1) <= ((size_t)1 << max_log);
+
+    // разреженный M приводится быстрее любого умножения (см. rem_coeffs);
+    // готовый обратный ряд снимает с Ньютона около половины работы, поэтому
+    // без NTT он окупается примерно с половины обычного порога
+    int sparse = sparse_weight(ctx->m, n + 1, POL_SPARSE_MAX_WEIGHT, mc) <= POL_SPARSE_MAX_WEIGHT;
+    if (!sparse && (use_ntt || (n >= 2 && n > g_newton_crt_threshold / 2)))
+        status = modulus_build_inverse(ctx, use_ntt);
+    else
+        status = modulus_reserve(ctx, 2 * n + mul_coeffs_scratch_size(n, n, mc));   // деление столбиком
+
+    if (status != POL_SUCCESS)
+        pol_modulus_free(ctx);
+    return status;
+}
+
+/*
+ * NTT-путь: T = A * B, rev(Q) = rev(T) * rev(M)^(-1), и Q * M по модулю
+ * x^l1 - 1: при l1 >= n старшие члены Q * M совпадают с членами T,
+ * поэтому R[j] = T[j] - C[j] + T[j + l1], где C — циклическая свёртка.
+ * Остаток остаётся в начале рабочего буфера.
+ */
+static int modulus_mul_ntt(const PolModulusCtx* ctx, ULL* work, const ULL* a, size_t na,
+                           const ULL* b, size_t nb)
+{
+    const PolModCtx* mc = &ctx->mod;
+    ULL p = mc->modulo;
+    size_t n = ctx->degree;
+    size_t l2 = ctx->ntt_len;
+    size_t l1 = ctx->ntt_len_low;
+    size_t nt = na + nb - 1;
+
+    ULL* fa = work;
+    ULL* fb = fa + l2;
+    ULL* fc = fb + l2;
+
+    for (size_t i = 0; i < l2; i++)
+        fa[i] = (i < na) ? ctx_reduce(mc, a[i]) : 0;
+    int status = ntt_transform(fa, l2, p);
+    if (status != POL_SUCCESS)
+        return status;
+
+    if (a == b && na == nb)
+    {
+        for (size_t i = 0; i < l2; i++)
+            fa[i] = ctx_mul(mc, fa[i], fa[i]);
+    }
+    else
+    {
+        for (size_t i = 0; i < l2; i++)
+            fb[i] = (i < nb) ? ctx_reduce(mc, b[i]) : 0;
+        status = ntt_transform(fb, l2, p);
+        if (status != POL_SUCCESS)
+            return status;
+
+        for (size_t i = 0; i < l2; i++)
+            fa[i] = ctx_mul(mc, fa[i], fb[i]);
     }
 
-    realloc_coeffs(R, A->degree);
-    set_pol_params(R, A->degree, m);
+    status = ntt_inverse_transform(fa, l2, p);
+    if (status != POL_SUCCESS || nt <= n)
+        return status;
 
-    for (size_t i = 0; i <= A->degree; i++)
-        R->coeffs[i] = A->coeffs[i] % m;
+    size_t nq = nt - n;
 
-    normalize_pol(R);
+    for (size_t i = 0; i < l2; i++)
+        fb[i] = (i < nq) ? fa[nt - 1 - i] : 0;
+    status = ntt_transform(fb, l2, p);
+    if (status != POL_SUCCESS)
+        return status;
+    for (size_t i = 0; i < l2; i++)
+        fb[i] = ctx_mul_prep(mc, fb[i], ctx->inv_hat[i]);
+    status = ntt_inverse_transform(fb, l2, p);
+    if (status != POL_SUCCESS)
+        return status;
 
-    ULL lead = M->coeffs[M->degree] % m;
-    ULL inv;
-    int status = modulo_inverse(lead, m, &inv);
+    for (size_t i = 0; i < l1; i++)
+        fc[i] = (i < nq) ? fb[nq - 1 - i] : 0;
+    status = ntt_transform(fc, l1, p);
+    if (status != POL_SUCCESS)
+        return status;
+    for (size_t i = 0; i < l1; i++)
+        fc[i] = ctx_mul_prep(mc, fc[i], ctx->m_hat[i]);
+    status = ntt_inverse_transform(fc, l1, p);
     if (status != POL_SUCCESS)
+        return status;
+
+    for (size_t j = 0; j < n; j++)
     {
-        return POL_NO_INVERSE;
+        ULL hi = (j + l1 < nt) ? fa[j + l1] : 0;
+        fa[j] = add_mod(sub_mod(fa[j], fc[j], p), hi, p);
     }
 
-    while (R->degree >= M->degree && !(R->degree == 0 && R->coeffs[0] == 0))
+    return POL_SUCCESS;
+}
+
+/* Размер рабочего буфера для одного умножения по контексту (na, nb <= n) */
+static size_t modulus_work_size(const PolModulusCtx* ctx, size_t na, size_t nb)
+{
+    const PolModCtx* mc = &ctx->mod;
+    size_t n = ctx->degree;
+    size_t nt = na + nb - 1;
+    size_t nq = (nt > n) ? nt - n : 0;
+
+    if (ctx->ntt_len != 0)
+        return 2 * ctx->ntt_len + ctx->ntt_len_low;
+
+    size_t need = mul_coeffs_scratch_size(na, nb, mc);
+    if (ctx->inv == NULL)
+        return 2 * n + need;
+
+    if (nq > 0)
     {
-        size_t shift = R->degree - M->degree;
-        ULL coeff = (R->coeffs[R->degree] * inv) % m;
+        size_t s_quo = mul_coeffs_scratch_size(nq, nq, mc);
+        size_t s_rem = mul_coeffs_scratch_size(nq, n, mc);
+        if (s_quo > need) need = s_quo;
+        if (s_rem > need) need = s_rem;
+    }
+    return 6 * n + need;
+}
 
-        for (size_t i = 0; i <= M->degree; i++)
-        {
-            size_t pos = i + shift;
-            ULL sub = (M->coeffs[i] * coeff) % m;
+/* Общий путь: умножения через mul_coeffs_ws, деление Ньютоном с готовым inv или столбиком */
+static int modulus_mul_generic(const PolModulusCtx* ctx, ULL* work, const ULL* a, size_t na,
+                               const ULL* b, size_t nb)
+{
+    const PolModCtx* mc = &ctx->mod;
+    size_t n = ctx->degree;
+    size_t nt = na + nb - 1;
+    size_t nq = (nt > n) ? nt - n : 0;
 
-            if (R->coeffs[pos] >= sub)
-                R->coeffs[pos] = (R->coeffs[pos] - sub) % m;
-            else
-                R->coeffs[pos] = (m - ((sub - R->coeffs[pos]) % m)) % m;
-        }
+    if (ctx->inv == NULL)
+    {
+        ULL* t = work;
+        int status = mul_coeffs_ws(a, na, b, nb, t, t + 2 * n, mc);
+        if (status != POL_SUCCESS || nq == 0)
+            return status;
 
-        normalize_pol(R);
+        return rem_coeffs(t, nt, ctx->m, n + 1, mc);
     }
 
+    ULL* t = work;
+    ULL* rt = t + 2 * n;
+    ULL* q = rt + n;
+    ULL* prod = q + n;
+    ULL* scratch = prod + 2 * n;
+
+    int status = mul_coeffs_ws(a, na, b, nb, t, scratch, mc);
+    if (status != POL_SUCCESS || nq == 0)
+        return status;
+
+    for (size_t i = 0; i < nq; i++)
+        rt[i] = t[nt - 1 - i];
+
+    status = mul_coeffs_ws(rt, nq, ctx->inv, nq, prod, scratch, mc);
+    if (status != POL_SUCCESS)
+        return status;
+    for (size_t i = 0; i < nq; i++)
+        q[i] = prod[nq - 1 - i];
+
+    status = mul_coeffs_ws(q, nq, ctx->m, n, prod, scratch, mc);
+    if (status != POL_SUCCESS)
+        return status;
+    for (size_t j = 0; j < n; j++)
+        t[j] = sub_mod(t[j], prod[j], mc->modulo);
+
     return POL_SUCCESS;
 }
 
-int pol_mul_mod_unit(const Polynomial* A, const Polynomial* B,
-                      const Polynomial* M, Polynomial* R)
+/* Остаток A * B по контексту в начале work (не меньше modulus_work_size), deg A, deg B < n */
+static int modulus_mul(const PolModulusCtx* ctx, ULL* work, const Polynomial* A,
+                       const Polynomial* B)
 {
-    if (A == NULL || B == NULL || M == NULL || R == NULL)
+    size_t na = A->degree + 1;
+    size_t nb = B->degree + 1;
+
+    return (ctx->ntt_len != 0)
+           ? modulus_mul_ntt(ctx, work, A->coeffs, na, B->coeffs, nb)
+           : modulus_mul_generic(ctx, work, A->coeffs, na, B->coeffs, nb);
+}
+
+/* R = первые min(nt, n) элементов work без старших нулей */
+static int modulus_store(const PolModulusCtx* ctx, const ULL* work, size_t nt, Polynomial* R)
+{
+    size_t n = ctx->degree;
+    size_t nr = (nt < n) ? nt : n;
+
+    if (realloc_coeffs(R, nr - 1) != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+    set_pol_params(R, nr - 1, ctx->mod.modulo);
+    memcpy(R->coeffs, work, nr * sizeof(ULL));
+
+    while (R->degree > 0 && R->coeffs[R->degree] == 0)
+        R->degree--;
+
+    return POL_SUCCESS;
+}
+
+int pol_mul_mod_ctx(const Polynomial* A, const Polynomial* B, PolModulusCtx* ctx,
+                    Polynomial* R)
+{
+    if (A == NULL || B == NULL || ctx == NULL || R == NULL)
         return POL_NULL_PTR;
 
-    if (A->modulo != B->modulo || A->modulo != M->modulo)
+    ULL m = ctx->mod.modulo;
+    if (A->modulo != m || B->modulo != m)
         return POL_MODULO_MISMATCH;
 
-    if (M->degree == 0 && M->coeffs[0] == 0)
-        return POL_ZERO_DIV;
+    size_t n = ctx->degree;
 
-    if (M->coeffs[M->degree] != 1)
-        return POL_INVALID_ARG;
+    if (n == 0)
+    {
+        if (realloc_coeffs(R, 0) != POL_SUCCESS)
+            return POL_MEMORY_ERROR;
+        set_pol_params(R, 0, m);
+        R->coeffs[0] = 0;
+        return POL_SUCCESS;
+    }
+
+    if (A->degree >= n || B->degree >= n)
+    {
+        Polynomial M = { ctx->m, n, m, 0 };
+        return pol_mul_mod_unit_ctx(A, B, &M, R, &ctx->mod);
+    }
 
-    Polynomial T;
+    int status = modulus_reserve(ctx, modulus_work_size(ctx, A->degree + 1, B->degree + 1));
+    if (status == POL_SUCCESS)
+        status = modulus_mul(ctx, ctx->work, A, B);
 
-    new_pol(&T, A->degree + B->degree, A->modulo);
+    // остаток уже в начале рабочего буфера; A и B больше не читаются
+    if (status == POL_SUCCESS)
+        status = modulus_store(ctx, ctx->work, A->degree + B->degree + 1, R);
+    return status;
+}
+
+int pol_mul_mod_ctx_ws(const Polynomial* A, const Polynomial* B, const PolModulusCtx* ctx,
+                       Polynomial* R, PolWorkspace* ws)
+{
+    if (A == NULL || B == NULL || ctx == NULL || R == NULL || ws == NULL)
+        return POL_NULL_PTR;
+
+    ULL m = ctx->mod.modulo;
+    if (A->modulo != m || B->modulo != m)
+        return POL_MODULO_MISMATCH;
 
-    int status = pol_mul_pol(A, B, &T);
+    size_t n = ctx->degree;
+
+    if (n == 0)
+    {
+        if (realloc_coeffs(R, 0) != POL_SUCCESS)
+            return POL_MEMORY_ERROR;
+        set_pol_params(R, 0, m);
+        R->coeffs[0] = 0;
+        return POL_SUCCESS;
+    }
+
+    if (A->degree >= n || B->degree >= n)
+    {
+        Polynomial M = { ctx->m, n, m, 0 };
+        return pol_mul_mod_unit_ws(A, B, &M, R, ws, &ctx->mod);
+    }
+
+    size_t work_len = modulus_work_size(ctx, A->degree + 1, B->degree + 1);
+    size_t mark = ws->used;
+    int status = ws_begin(ws, work_len);
     if (status != POL_SUCCESS)
+        return POL_MEMORY_ERROR;
+
+    ULL* work = pol_ws_alloc(ws, work_len);
+    status = modulus_mul(ctx, work, A, B);
+    if (status == POL_SUCCESS)
+        status = modulus_store(ctx, work, A->degree + B->degree + 1, R);
+
+    ws->used = mark;
+    return status;
+}
+
+int pol_mul_mod_batch_ctx(const Polynomial* A, const Polynomial* B, size_t n,
+                          const PolModulusCtx* ctx, Polynomial* R)
+{
+    if (A == NULL || B == NULL || ctx == NULL || R == NULL)
+        return POL_NULL_PTR;
+
+    // таблица векторных ядер выбирается до параллельной части
+    pol_vec_ops();
+
+    size_t fail_index = n;
+    int fail_status = POL_SUCCESS;
+
+    #pragma omp parallel if (n > 1) num_threads(pol_get_num_threads())
     {
-        free_pol(&T);
-        return status;
+        PolWorkspace ws = { NULL, 0, 0 };
+
+        #pragma omp for schedule(dynamic, 4)
+        for (size_t i = 0; i < n; i++)
+        {
+            int status = pol_mul_mod_ctx_ws(&A[i], &B[i], ctx, &R[i], &ws);
+            if (status != POL_SUCCESS)
+            {
+                // сообщаем ошибку с наименьшим номером, как при последовательном цикле
+                #pragma omp critical (pol_batch_status)
+                {
+                    if (i < fail_index)
+                    {
+                        fail_index = i;
+                        fail_status = status;
+                    }
+                }
+            }
+        }
+
+        pol_ws_free(&ws);
+    }
+
+    return fail_status;
+}
+
+int pol_mul_mod_unit_batch(const Polynomial* A, const Polynomial* B, size_t n,
+                           const Polynomial* M, Polynomial* R)
+{
+    if (A == NULL || B == NULL || M == NULL || R == NULL)
+        return POL_NULL_PTR;
+
+    if (n == 0)
+        return POL_SUCCESS;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (A[i].modulo != M->modulo || B[i].modulo != M->modulo)
+            return POL_MODULO_MISMATCH;
     }
-    status = modulo_unit_pol(&T, M, R);
 
-    free_pol(&T);
+    PolModulusCtx ctx;
+    int status = pol_modulus_init(&ctx, M);
+    if (status != POL_SUCCESS)
+        return status;
+
+    status = pol_mul_mod_batch_ctx(A, B, n, &ctx, R);
+
+    pol_modulus_free(&ctx);
     return status;
-}
\ No newline at end of file
+}
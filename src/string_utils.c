@@ -1,108 +1,644 @@
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PARSE_HAVE_FD 1
+#include <errno.h>
+#include <sys/types.h>
+#include <unistd.h>
+#else
+#define PARSE_HAVE_FD 0
+#endif
+
 #include "../include/string_utils.h"
 #include "../include/mem_tracker.h"
 
-int str_to_pol(const char* str, ULL modulo, Polynomial* pol)
+/*--------------------- РАЗБОР ---------------------*/
+
+/* Порция чтения и записи для потоковых вариантов */
+#define PARSE_CHUNK 65536
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PARSE_SWAR 1
+#else
+#define PARSE_SWAR 0
+#endif
+
+static const ULL POW10[9] =
 {
-    if (!str || !pol) return POL_NULL_PTR;
-    if (modulo <= 1) return POL_INVALID_MODULO;
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL
+};
+
+enum ParseState
+{
+    PS_OPEN = 0,    // ждём '('
+    PS_VALUE,       // ждём знак или первую цифру коэффициента
+    PS_SIGN,        // после знака обязательна цифра
+    PS_DIGITS,      // внутри числа
+    PS_NEXT,        // ждём ',' или ')'
+    PS_DONE         // прочитана ')'
+};
+
+/*
+ * Состояние разбора: текст можно подавать порциями, число может
+ * начинаться в одной порции и заканчиваться в следующей.
+ */
+typedef struct PolParser
+{
+    Polynomial* pol;
+    ULL modulo;
+    int state;
+    int negative;
+    int reduced;        // число не поместилось в ULL, acc уже приведён по модулю
+    ULL acc;
+    size_t n;           // разобранных коэффициентов
+} PolParser;
+
+static int parse_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static int parse_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+#if PARSE_SWAR
+/* Сколько первых байт слова (в порядке текста) — цифры '0'..'9' */
+static int swar_digit_run(uint64_t w)
+{
+    // после xor цифры — байты 0..9; старший бит суммы отмечает байты >= 10
+    uint64_t x = w ^ 0x3030303030303030ULL;
+    uint64_t bad = (((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7676767676767676ULL) | x) & 0x8080808080808080ULL;
+    return bad ? __builtin_ctzll(bad) / 8 : 8;
+}
+
+/* Значение 8 цифр (первая — старшая): попарное сложение разрядов за три умножения */
+static ULL swar_8digits(uint64_t w)
+{
+    w = ((w & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+    w = ((w & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+    return (uint32_t)(((w & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+/* Значение первых len < 8 цифр: они сдвигаются в конец слова, спереди дописываются '0' */
+static ULL swar_ndigits(uint64_t w, int len)
+{
+    int shift = 8 * (8 - len);
+    return swar_8digits((w << shift) | (0x3030303030303030ULL >> (64 - shift)));
+}
+#endif
 
-    if (pol->coeffs != NULL)
+/* Дописывает k цифр со значением chunk; длинные числа приводятся по модулю без переполнения */
+static void parse_append(PolParser* ps, ULL chunk, int k)
+{
+    if (!ps->reduced)
     {
-        free(pol->coeffs, (pol->degree + 1) * sizeof(ULL));
+        ULL t;
+        if (!__builtin_mul_overflow(ps->acc, POW10[k], &t) &&
+            !__builtin_add_overflow(t, chunk, &t))
+        {
+            ps->acc = t;
+            return;
+        }
+
+        // переполнение: дальше считаем остаток по модулю
+        ps->acc %= ps->modulo;
+        ps->reduced = 1;
     }
-    set_pol_params(pol, 0, modulo);
+    ps->acc = (ULL)(((unsigned __int128)ps->acc * POW10[k] + chunk) % ps->modulo);
+}
+
+static int parse_push(PolParser* ps)
+{
+    ULL m = ps->modulo;
+    // обычно коэффициент уже меньше модуля: деление не нужно
+    ULL v = (ps->reduced || ps->acc < m) ? ps->acc : ps->acc % m;
+    if (ps->negative)
+        v = (m - v) % m;
+
+    Polynomial* pol = ps->pol;
+    if (ps->n >= pol->capacity)
+    {
+        // realloc_coeffs переносит degree + 1 элементов: уже разобранные
+        if (ps->n > 0)
+            pol->degree = ps->n - 1;
+        if (realloc_coeffs(pol, ps->n) != POL_SUCCESS)
+            return POL_MEMORY_ERROR;
+    }
+
+    pol->coeffs[ps->n++] = v;
+    return POL_SUCCESS;
+}
 
-    while (*str == ' ') str++;
+static void parse_begin(PolParser* ps, Polynomial* pol, ULL modulo)
+{
+    memset(ps, 0, sizeof(*ps));
+    ps->pol = pol;
+    ps->modulo = modulo;
+    ps->state = PS_OPEN;
+}
 
-    if (*str++ != '(') return POL_INVALID_ARG;
+/*
+ * Разбирает очередную порцию текста. Останавливается на ')' (PS_DONE);
+ * *used — сколько байт порции использовано.
+ */
+static int parse_feed(PolParser* ps, const char* text, size_t len, size_t* used)
+{
+    const char* p = text;
+    const char* end = text + len;
 
-    // Считаем запятые
-    size_t count = 1;
-    const char* p = str;
-    while (*p && *p != ')')
+    int status = POL_SUCCESS;
+    while (status == POL_SUCCESS && p < end && ps->state != PS_DONE)
     {
-        if (*p == ',') count++;
-        p++;
+        char c = *p;
+        switch (ps->state)
+        {
+            case PS_OPEN:
+                if (c == '(')
+                    ps->state = PS_VALUE;
+                else if (!parse_space(c))
+                {
+                    status = POL_INVALID_ARG;
+                    break;
+                }
+                p++;
+                break;
+
+            case PS_VALUE:
+                if (parse_space(c))
+                {
+                    p++;
+                    break;
+                }
+                ps->negative = 0;
+                ps->reduced = 0;
+                ps->acc = 0;
+                if (c == '-' || c == '+')
+                {
+                    ps->negative = (c == '-');
+                    ps->state = PS_SIGN;
+                    p++;
+                    break;
+                }
+                if (!parse_digit(c))
+                {
+                    status = POL_INVALID_ARG;
+                    break;
+                }
+                ps->state = PS_DIGITS;
+                break;
+
+            case PS_SIGN:
+                if (!parse_digit(c))
+                {
+                    status = POL_INVALID_ARG;
+                    break;
+                }
+                ps->state = PS_DIGITS;
+                break;
+
+            case PS_DIGITS:
+            {
+#if PARSE_SWAR
+                // по 8 байт: число цифр в слове определяется сразу, без побайтового цикла
+                int ended = 0;
+                while (end - p >= 8)
+                {
+                    uint64_t w;
+                    memcpy(&w, p, 8);
+                    int len = swar_digit_run(w);
+                    if (len == 8)
+                    {
+                        parse_append(ps, swar_8digits(w), 8);
+                        p += 8;
+                        continue;
+                    }
+                    if (len > 0)
+                    {
+                        parse_append(ps, swar_ndigits(w, len), len);
+                        p += len;
+                    }
+                    ended = 1;
+                    break;
+                }
+                if (!ended)
+#endif
+                while (p < end && parse_digit(*p))
+                {
+                    // хвост короче 8 цифр: копим до 8 и добавляем разом
+                    ULL chunk = 0;
+                    int k = 0;
+                    while (k < 8 && p < end && parse_digit(*p))
+                    {
+                        chunk = chunk * 10 + (ULL)(*p - '0');
+                        k++;
+                        p++;
+                    }
+                    parse_append(ps, chunk, k);
+                }
+
+                // число может продолжиться в следующей порции
+                if (p == end)
+                    break;
+
+                status = parse_push(ps);
+                if (status != POL_SUCCESS)
+                    break;
+
+                // частый случай "12,34": сразу следующее число, минуя PS_NEXT и PS_VALUE
+                if (end - p >= 2 && p[0] == ',' && parse_digit(p[1]))
+                {
+                    p++;
+                    ps->negative = 0;
+                    ps->reduced = 0;
+                    ps->acc = 0;
+                    break;
+                }
+                ps->state = PS_NEXT;
+                break;
+            }
+
+            case PS_NEXT:
+                if (c == ',')
+                    ps->state = PS_VALUE;
+                else if (c == ')')
+                    ps->state = PS_DONE;
+                else if (!parse_space(c))
+                {
+                    status = POL_INVALID_ARG;
+                    break;
+                }
+                p++;
+                break;
+
+            default:
+                status = POL_INVALID_ARG;
+                break;
+        }
     }
-    if (*p != ')') return POL_INVALID_ARG;
 
-    ULL* coeffs = malloc(count * sizeof(ULL));
-    if (!coeffs) return POL_MEMORY_ERROR;
+    *used = (size_t)(p - text);
+    return status;
+}
+
+/* Завершение разбора: без ')' текст неполон; ведущие нули отбрасываются */
+static int parse_end(PolParser* ps)
+{
+    if (ps->state != PS_DONE)
+        return POL_INVALID_ARG;
 
-    p = str;
-    for (size_t i = 0; i < count; i++)
+    size_t degree = ps->n - 1;
+    while (degree > 0 && ps->pol->coeffs[degree] == 0)
+        degree--;
+
+    set_pol_params(ps->pol, degree, ps->modulo);
+    return POL_SUCCESS;
+}
+
+/* При ошибке разбора pol остаётся прежним (ничего не записано) или нулевым многочленом */
+static int parse_fail(PolParser* ps, int status)
+{
+    if (ps->n > 0)
     {
-        // Пропускаем пробелы
-        while (*p == ' ') p++;
+        set_pol_params(ps->pol, 0, ps->modulo);
+        ps->pol->coeffs[0] = 0;
+    }
+    return status;
+}
 
-        int negative = 0;
-        if (*p == '-' || *p == '+')
-        {
-            negative = (*p == '-');
-            p++;
-        }
+int str_to_pol(const char* str, ULL modulo, Polynomial* pol)
+{
+    if (!str || !pol) return POL_NULL_PTR;
+    if (modulo <= 1) return POL_INVALID_MODULO;
 
-        if (*p < '0' || *p > '9')
-        {
-            free(coeffs, count * sizeof(ULL));
-            return POL_INVALID_ARG;
-        }
+    // длина нужна, чтобы чтение по 8 байт не выходило за конец строки
+    PolParser ps;
+    size_t used;
+    parse_begin(&ps, pol, modulo);
 
-        ULL val = 0;
-        while (*p >= '0' && *p <= '9')
-            val = val * 10 + (*p++ - '0');
+    int status = parse_feed(&ps, str, strlen(str), &used);
+    if (status == POL_SUCCESS)
+        status = parse_end(&ps);
+    return (status == POL_SUCCESS) ? status : parse_fail(&ps, status);
+}
 
-        if (negative)
-        {
-            coeffs[i] = (modulo - (val % modulo)) % modulo;
-        }
-        else
+int pol_read_str(FILE* f, ULL modulo, Polynomial* pol)
+{
+    if (!f || !pol) return POL_NULL_PTR;
+    if (modulo <= 1) return POL_INVALID_MODULO;
+
+    char* buf = malloc(PARSE_CHUNK);
+    if (buf == NULL)
+        return POL_MEMORY_ERROR;
+
+    PolParser ps;
+    parse_begin(&ps, pol, modulo);
+
+    int status = POL_SUCCESS;
+    while (status == POL_SUCCESS && ps.state != PS_DONE)
+    {
+        size_t got = fread(buf, 1, PARSE_CHUNK, f);
+        if (got == 0)
         {
-            coeffs[i] = val % modulo;
+            if (ferror(f))
+                status = POL_IO_ERROR;
+            break;
         }
 
-        while (*p == ' ') p++;
+        size_t used;
+        status = parse_feed(&ps, buf, got, &used);
+
+        // непрочитанный остаток порции возвращаем в поток, если он допускает перемотку
+        if (status == POL_SUCCESS && ps.state == PS_DONE && used < got)
+            fseek(f, -(long)(got - used), SEEK_CUR);
+    }
+    free(buf, PARSE_CHUNK);
+
+    if (status == POL_SUCCESS)
+        status = parse_end(&ps);
+    return (status == POL_SUCCESS) ? status : parse_fail(&ps, status);
+}
+
+#if PARSE_HAVE_FD
+
+int pol_read_str_fd(int fd, ULL modulo, Polynomial* pol)
+{
+    if (!pol) return POL_NULL_PTR;
+    if (fd < 0) return POL_IO_ERROR;
+    if (modulo <= 1) return POL_INVALID_MODULO;
+
+    char* buf = malloc(PARSE_CHUNK);
+    if (buf == NULL)
+        return POL_MEMORY_ERROR;
+
+    PolParser ps;
+    parse_begin(&ps, pol, modulo);
 
-        if (i < count - 1)
+    int status = POL_SUCCESS;
+    while (status == POL_SUCCESS && ps.state != PS_DONE)
+    {
+        ssize_t got = read(fd, buf, PARSE_CHUNK);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got < 0)
         {
-            if (*p != ',')
-            {
-                free(coeffs, count * sizeof(ULL));
-                return POL_INVALID_ARG;
-            }
-            p++; // Пропускаем запятую
+            status = POL_IO_ERROR;
+            break;
         }
+        if (got == 0)
+            break;
+
+        size_t used;
+        status = parse_feed(&ps, buf, (size_t)got, &used);
+
+        if (status == POL_SUCCESS && ps.state == PS_DONE && used < (size_t)got)
+            lseek(fd, -(off_t)((size_t)got - used), SEEK_CUR);
     }
+    free(buf, PARSE_CHUNK);
+
+    if (status == POL_SUCCESS)
+        status = parse_end(&ps);
+    return (status == POL_SUCCESS) ? status : parse_fail(&ps, status);
+}
 
-    // Пропускаем пробелы перед ')'
-    while (*p == ' ') p++;
-    if (*p != ')')
+#else
+
+int pol_read_str_fd(int fd, ULL modulo, Polynomial* pol)
+{
+    (void)fd; (void)modulo; (void)pol;
+    return POL_IO_ERROR;
+}
+
+#endif
+
+/*--------------------- ЧТЕНИЕ ПОДРЯД ---------------------*/
+
+/* Следующая порция в буфер; 0 — данных больше нет (или ошибка чтения) */
+static int reader_fill(PolReader* rd)
+{
+    if (rd->pos < rd->len)
+        return 1;
+    if (rd->eof)
+        return 0;
+
+    rd->pos = 0;
+    rd->len = fread(rd->buf, 1, PARSE_CHUNK, rd->f);
+    if (rd->len == 0)
     {
-        free(coeffs, count * sizeof(ULL));
-        return POL_INVALID_ARG;
+        rd->eof = 1;
+        rd->error = ferror(rd->f) != 0;
+        return 0;
     }
+    return 1;
+}
 
-    // Убираем ведущие нули
-    size_t degree = count - 1;
-    while (degree > 0 && coeffs[degree] == 0)
-        degree--;
+int pol_reader_init(PolReader* rd, FILE* f)
+{
+    if (rd == NULL || f == NULL)
+        return POL_NULL_PTR;
+
+    memset(rd, 0, sizeof(*rd));
+    rd->f = f;
+    rd->buf = malloc(PARSE_CHUNK);
+    return (rd->buf != NULL) ? POL_SUCCESS : POL_MEMORY_ERROR;
+}
+
+void pol_reader_free(PolReader* rd)
+{
+    if (rd == NULL || rd->buf == NULL)
+        return;
 
-    // Выделяем память для результата
-    ULL* result_coeffs = malloc((degree + 1) * sizeof(ULL));
-    if (!result_coeffs)
+    free(rd->buf, PARSE_CHUNK);
+    rd->buf = NULL;
+}
+
+int pol_reader_next(PolReader* rd, ULL modulo, Polynomial* pol)
+{
+    if (rd == NULL || pol == NULL) return POL_NULL_PTR;
+    if (modulo <= 1) return POL_INVALID_MODULO;
+
+    PolParser ps;
+    parse_begin(&ps, pol, modulo);
+
+    int status = POL_SUCCESS;
+    while (status == POL_SUCCESS && ps.state != PS_DONE && reader_fill(rd))
     {
-        free(coeffs, count * sizeof(ULL));
-        return POL_MEMORY_ERROR;
+        // многочлен не переходит через конец строки: '\n' остаётся в буфере
+        const char* p = rd->buf + rd->pos;
+        size_t avail = rd->len - rd->pos;
+        const char* nl = memchr(p, '\n', avail);
+        size_t used;
+        status = parse_feed(&ps, p, (nl != NULL) ? (size_t)(nl - p) : avail, &used);
+        rd->pos += used;
+        if (status == POL_SUCCESS && nl != NULL && ps.state != PS_DONE)
+            status = POL_INVALID_ARG;
+    }
+    if (status == POL_SUCCESS && rd->error)
+        status = POL_IO_ERROR;
+
+    if (status == POL_SUCCESS)
+        status = parse_end(&ps);
+    return (status == POL_SUCCESS) ? status : parse_fail(&ps, status);
+}
+
+int pol_reader_end_line(PolReader* rd)
+{
+    if (rd == NULL)
+        return POL_NULL_PTR;
+
+    int blank = 1;
+    while (reader_fill(rd))
+    {
+        const char* p = rd->buf + rd->pos;
+        const char* nl = memchr(p, '\n', rd->len - rd->pos);
+        const char* end = (nl != NULL) ? nl : rd->buf + rd->len;
+
+        for (; blank && p < end; p++)
+            blank = parse_space(*p);
+
+        rd->pos = (size_t)(end - rd->buf) + (nl != NULL);
+        if (nl != NULL)
+            break;
+    }
+
+    if (rd->error)
+        return POL_IO_ERROR;
+    return blank ? POL_SUCCESS : POL_INVALID_ARG;
+}
+
+int pol_reader_at_end(PolReader* rd)
+{
+    if (rd == NULL)
+        return 1;
+
+    while (reader_fill(rd))
+    {
+        if (!parse_space(rd->buf[rd->pos]))
+            return 0;
+        rd->pos++;
     }
+    return 1;
+}
 
-    for (size_t i = 0; i <= degree; i++)
-        result_coeffs[i] = coeffs[i];
+/*--------------------- ЗАПИСЬ ---------------------*/
 
-    free(coeffs, count * sizeof(ULL));
+/* Пары цифр "00".."99": две цифры за одно деление на 100 */
+static const char DIGITS2[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
-    set_pol_params(pol, degree, modulo);
-    pol->coeffs = result_coeffs;
+static const ULL POW10_FULL[20] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/* Наибольшая длина числа и запятой после него */
+#define FMT_MAX_ITEM 21
 
+/* Число десятичных цифр: оценка через log10(2) ~ 1233 / 4096 и одно сравнение */
+static int fmt_digits(ULL v)
+{
+    v |= 1;
+    int t = ((64 - __builtin_clzll(v)) * 1233) >> 12;
+    return t + (v >= POW10_FULL[t]);
+}
+
+/* Пишет v в out без '\0' слева направо, сразу на свои места; возвращает конец */
+static char* fmt_ull(char* out, ULL v)
+{
+    char* end = out + fmt_digits(v);
+    char* p = end;
+
+    while (v >= 100)
+    {
+        ULL q = v / 100;
+        p -= 2;
+        memcpy(p, DIGITS2 + 2 * (v - q * 100), 2);
+        v = q;
+    }
+    if (v >= 10)
+    {
+        p -= 2;
+        memcpy(p, DIGITS2 + 2 * v, 2);
+    }
+    else
+    {
+        *--p = (char)('0' + v);
+    }
+    return end;
+}
+
+/*
+ * Форматирует коэффициенты [*next, degree] в out, пока хватает места
+ * (с запасом FMT_MAX_ITEM на элемент); возвращает конец записанного.
+ * Открывающую скобку пишет вызывающая сторона, закрывающую — эта функция
+ * после последнего коэффициента.
+ */
+static char* fmt_coeffs(const Polynomial* pol, size_t* next, char* out, const char* limit)
+{
+    const ULL* c = pol->coeffs;
+    size_t i = *next;
+
+    while (i <= pol->degree && limit - out >= FMT_MAX_ITEM)
+    {
+        out = fmt_ull(out, c[i]);
+        *out++ = (i < pol->degree) ? ',' : ')';
+        i++;
+    }
+
+    *next = i;
+    return out;
+}
+
+size_t pol_str_bound(const Polynomial* pol)
+{
+    if (pol == NULL)
+        return 0;
+
+    // коэффициенты меньше modulo; у ненормализованного многочлена — до 20 цифр
+    int digits = (pol->modulo > 1) ? fmt_digits(pol->modulo - 1) : 20;
+    return (pol->degree + 1) * (size_t)(digits + 1) + 2;
+}
+
+int pol_to_str_buf(const Polynomial* pol, char* buf, size_t size, size_t* len)
+{
+    if (pol == NULL || buf == NULL)
+        return POL_NULL_PTR;
+
+    if (pol->coeffs == NULL)
+        return POL_INVALID_ARG;
+
+    if (size < 2)
+        return POL_BUFFER_SMALL;
+
+    const char* limit = buf + size - 1;     // место под '\0'
+    char* pos = buf;
+    *pos++ = '(';
+
+    size_t next = 0;
+    pos = fmt_coeffs(pol, &next, pos, limit);
+
+    // хвост, где запаса FMT_MAX_ITEM уже нет: точная длина каждого элемента
+    while (next <= pol->degree)
+    {
+        ULL v = pol->coeffs[next];
+        if ((size_t)(limit - pos) < (size_t)fmt_digits(v) + 1)
+            return POL_BUFFER_SMALL;
+
+        pos = fmt_ull(pos, v);
+        *pos++ = (next < pol->degree) ? ',' : ')';
+        next++;
+    }
+
+    *pos = '\0';
+    if (len != NULL)
+        *len = (size_t)(pos - buf);
     return POL_SUCCESS;
 }
 
@@ -114,53 +650,120 @@ int pol_to_str(const Polynomial* pol, char** str, size_t* out_size)
     if (pol->coeffs == NULL)
         return POL_INVALID_ARG;
 
-    size_t total_len = 2; // ( + )
+    // один проход: буфер по оценке pol_str_bound, без предварительного подсчёта длины
+    size_t size = pol_str_bound(pol);
+    *str = malloc(size);
+    if (*str == NULL)
+        return POL_MEMORY_ERROR;
 
-    for (size_t i = 0; i <= pol->degree; i++)
+    int status = pol_to_str_buf(pol, *str, size, NULL);
+    if (status == POL_BUFFER_SMALL)
     {
-        ULL num = pol->coeffs[i];
-        do {
-            total_len++;
-        } while (num /= 10);
-
-        if (i < pol->degree) total_len++; // запятая
+        // коэффициенты не приведены по модулю: берём оценку для 20-значных чисел
+        free(*str, size);
+        size = (pol->degree + 1) * FMT_MAX_ITEM + 2;
+        *str = malloc(size);
+        if (*str == NULL)
+            return POL_MEMORY_ERROR;
+        status = pol_to_str_buf(pol, *str, size, NULL);
     }
 
-    *str = malloc(total_len + 1);
-    if (*str == NULL)
+    *out_size = size;
+    return status;
+}
+
+int pol_write_str(FILE* f, const Polynomial* pol)
+{
+    if (f == NULL || pol == NULL)
+        return POL_NULL_PTR;
+
+    if (pol->coeffs == NULL)
+        return POL_INVALID_ARG;
+
+    char* buf = malloc(PARSE_CHUNK);
+    if (buf == NULL)
         return POL_MEMORY_ERROR;
 
-    char* pos = *str;
+    int status = POL_SUCCESS;
+    char* pos = buf;
     *pos++ = '(';
 
-    for (size_t i = 0; i <= pol->degree; i++)
+    size_t next = 0;
+    while (status == POL_SUCCESS)
     {
-        ULL num = pol->coeffs[i];
-        char* num_start = pos;
-
-        // в обратном порядке
-        do {
-            *pos++ = '0' + (num % 10); // ASCII NOLINT(*-narrowing-conversions)
-        } while (num /= 10);
+        pos = fmt_coeffs(pol, &next, pos, buf + PARSE_CHUNK);
 
-        // Разворачиваем цифры
-        char* num_end = pos - 1;
-        while (num_start < num_end)
-        {
-            char tmp = *num_start;
-            *num_start = *num_end;
-            *num_end = tmp;
-            num_start++;
-            num_end--;
-        }
+        size_t n = (size_t)(pos - buf);
+        if (fwrite(buf, 1, n, f) != n)
+            status = POL_IO_ERROR;
+        pos = buf;
 
-        if (i < pol->degree)
-            *pos++ = ',';
+        if (next > pol->degree)
+            break;
     }
 
-    *pos++ = ')';
-    *pos = '\0';
-    *out_size = total_len + 1; // + '\0'
+    free(buf, PARSE_CHUNK);
+    return status;
+}
+
+#if PARSE_HAVE_FD
 
+/* write до конца буфера: частичная запись и EINTR повторяются */
+static int fmt_write_all(int fd, const char* p, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t put = write(fd, p, n);
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return POL_IO_ERROR;
+        p += put;
+        n -= (size_t)put;
+    }
     return POL_SUCCESS;
 }
+
+int pol_write_str_fd(int fd, const Polynomial* pol)
+{
+    if (pol == NULL)
+        return POL_NULL_PTR;
+
+    if (fd < 0)
+        return POL_IO_ERROR;
+
+    if (pol->coeffs == NULL)
+        return POL_INVALID_ARG;
+
+    char* buf = malloc(PARSE_CHUNK);
+    if (buf == NULL)
+        return POL_MEMORY_ERROR;
+
+    int status = POL_SUCCESS;
+    char* pos = buf;
+    *pos++ = '(';
+
+    size_t next = 0;
+    while (status == POL_SUCCESS)
+    {
+        pos = fmt_coeffs(pol, &next, pos, buf + PARSE_CHUNK);
+        status = fmt_write_all(fd, buf, (size_t)(pos - buf));
+        pos = buf;
+
+        if (next > pol->degree)
+            break;
+    }
+
+    free(buf, PARSE_CHUNK);
+    return status;
+}
+
+#else
+
+int pol_write_str_fd(int fd, const Polynomial* pol)
+{
+    (void)fd; (void)pol;
+    return POL_IO_ERROR;
+}
+
+#endif
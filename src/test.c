@@ -1,4 +1,15 @@
 #include "../include/test.h"
+#include "../include/pol_mul.h"
+#include "../include/ntt.h"
+#include "../include/pol_arith.h"
+#include "../include/pol_simd.h"
+#include "../include/pol_div.h"
+#include "../include/pol_par.h"
+#include "../include/pol_tune.h"
+#include "../include/pol_rng.h"
+#include "../include/pol_io.h"
+#include "../include/pol_jobs.h"
+#include "../include/pol_gf2.h"
 #include "../include/mem_tracker.h"
 
 #define MAX_INPUT_LEN 1024
@@ -8,67 +19,878 @@ size_t currentMemory = 0;
 
 ULL rand64()
 {
-    return ((ULL)(rand() & 0xFFFF) << 48) |
-           ((ULL)(rand() & 0xFFFF) << 32) |
-           ((ULL)(rand() & 0xFFFF) << 16) |
-           ((ULL)(rand() & 0xFFFF));
+    return pol_rng_next(pol_rng_local());
 }
 
 int get_rand_pol(Polynomial* P, size_t degree, ULL modulo)
 {
-    if (P == NULL)
-        return POL_NULL_PTR;
+    return pol_rng_pol(pol_rng_local(), P, degree, modulo);
+}
+
+size_t pol_bytes(const Polynomial* P)
+{
+    if (!P || !P->coeffs) return 0;
+    return P->capacity * sizeof(ULL);
+}
+
+int manual_test()
+{
+    printf("=== Тестирование pol_mul_mod_unit ===\n\n");
+
+    int test_count = 0;
+    int passed_count = 0;
+    Polynomial A, B, M, R;
+    new_pol(&R, 0, 2);
+    // ----- ТЕСТ 1: обычное корректное вычисление -----
+    {
+        test_count++;
+        printf("[TEST 1] Обычное корректное вычисление\n");
+
+
+        new_pol(&A, 2, 7);  // A = x^2 + 2x + 3 в Z7
+        A.coeffs[0] = 3; A.coeffs[1] = 2; A.coeffs[2] = 1;
+
+        new_pol(&B, 1, 7);  // B = x + 4 в Z7
+        B.coeffs[0] = 4; B.coeffs[1] = 1;
+
+        new_pol(&M, 2, 7);  // M = x^2 + 1 (унитарный)
+        M.coeffs[0] = 1; M.coeffs[1] = 0; M.coeffs[2] = 1;
+
+        // Ожидаем: (x^2+2x+3)(x+4) mod (x^2+1) = 3x + 5 в Z7
+        Polynomial expected;
+        new_pol(&expected, 1, 7);
+        expected.coeffs[0] = 6; expected.coeffs[1] = 3;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A="); print_polynomial(&A, "");
+        printf("        B="); print_polynomial(&B, "");
+        printf("        M="); print_polynomial(&M, "");
+        printf("  Ожидаем: "); print_polynomial(&expected, "");
+        printf("  Получили: "); print_polynomial(&R, "");
+        printf("  Статус: %d", result);
+
+        // Простая проверка результата
+        int ok = (result == POL_SUCCESS && R.degree == expected.degree &&
+                 R.coeffs[0] == expected.coeffs[0] && R.coeffs[1] == expected.coeffs[1]);
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 2: произведение с нулевым многочленом -----
+    {
+        test_count++;
+        printf("[TEST 2] Произведение с нулевым многочленом\n");
+
+        new_pol(&A, 0, 5);  // A = 0
+        A.coeffs[0] = 0;
+
+        new_pol(&B, 2, 5);  // B = x^2 + 1
+        B.coeffs[0] = 1; B.coeffs[1] = 0; B.coeffs[2] = 1;
+
+        new_pol(&M, 2, 5);  // M = x^2 + x + 1 (унитарный)
+        M.coeffs[0] = 1; M.coeffs[1] = 1; M.coeffs[2] = 1;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A=0, B=x^2+1, M=x^2+x+1 mod 5\n");
+        printf("  Ожидаем: 0\n");
+        printf("  Получили: "); print_polynomial(&R, "");
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && R.degree == 0 && R.coeffs[0] == 0);
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 3: модуль степени 0 (M = 1) -----
+    {
+        test_count++;
+        printf("[TEST 3] Модуль степени 0 (M = 1)\n");
+
+        new_pol(&A, 1, 11);  // A = x + 2
+        A.coeffs[0] = 2; A.coeffs[1] = 1;
+
+        new_pol(&B, 1, 11);  // B = x + 3
+        B.coeffs[0] = 3; B.coeffs[1] = 1;
+
+        new_pol(&M, 0, 11);  // M = 1 (унитарный)
+        M.coeffs[0] = 1;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A=x+2, B=x+3, M=1 mod 11\n");
+        printf("  Ожидаем: 0 (любое число mod 1 = 0)\n");
+        printf("  Получили: "); print_polynomial(&R, "");
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && R.degree == 0 && R.coeffs[0] == 0);
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 4: M не унитарный -----
+    {
+        test_count++;
+        printf("[TEST 4] M не унитарный (старший коэффициент != 1)\n");
+
+        new_pol(&A, 0, 7);  // A = 1
+        A.coeffs[0] = 1;
+
+        new_pol(&B, 0, 7);  // B = 1
+        B.coeffs[0] = 1;
+
+        new_pol(&M, 1, 7);  // M = 2x + 1 (не унитарный, старший коэффициент 2)
+        M.coeffs[0] = 1; M.coeffs[1] = 2;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A=1, B=1, M=2x+1 mod 7\n");
+        printf("  Ожидаем: POL_INVALID_ARG (9, M не унитарный)\n");
+        printf("  Статус: %d", result);
+
+        if (result == POL_INVALID_ARG) {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        } else {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 5: деление на нулевой многочлен -----
+    {
+        test_count++;
+        printf("[TEST 5] Деление на нулевой многочлен\n");
+
+        new_pol(&A, 0, 13);  // A = 1
+        A.coeffs[0] = 1;
+
+        new_pol(&B, 0, 13);  // B = 1
+        B.coeffs[0] = 1;
+
+        new_pol(&M, 0, 13);  // M = 0
+        M.coeffs[0] = 0;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A=1, B=1, M=0 mod 13\n");
+        printf("  Ожидаем: POL_ZERO_DIV (5, деление на нулевой многочлен)\n");
+        printf("  Статус: %d", result);
+
+        if (result == POL_ZERO_DIV)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 6: большие степени, Карацуба против школьного умножения -----
+    {
+        test_count++;
+        printf("[TEST 6] Большие степени: Карацуба против школьного умножения\n");
+
+        ULL modulo = 1000003;
+        new_pol(&A, 700, modulo);
+        new_pol(&B, 260, modulo);
+        new_pol(&M, 300, modulo);
+        for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+        A.coeffs[A.degree] = 1; B.coeffs[B.degree] = 1; M.coeffs[M.degree] = 1;
+
+        Polynomial expected;
+        new_pol(&expected, 0, modulo);
+
+        // КТО отключено в обоих прогонах: иначе при этих длинах оно заменит и школьное, и Карацубу
+        size_t saved_threshold = g_karatsuba_threshold;
+        size_t saved_crt = g_ntt_crt_threshold;
+        g_ntt_crt_threshold = (size_t)-1;
+        g_karatsuba_threshold = (size_t)-1;
+        int status_ref = pol_mul_mod_unit(&A, &B, &M, &expected);
+        g_karatsuba_threshold = 8;
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        g_karatsuba_threshold = saved_threshold;
+        g_ntt_crt_threshold = saved_crt;
+
+        printf("  Вход: deg A=%zu, deg B=%zu, deg M=%zu mod %llu\n",
+               A.degree, B.degree, M.degree, modulo);
+        printf("  Ожидаем: deg R=%zu (школьное умножение)\n", expected.degree);
+        printf("  Получили: deg R=%zu\n", R.degree);
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && status_ref == POL_SUCCESS &&
+                  R.degree == expected.degree);
+        for (size_t i = 0; ok && i <= R.degree; i++)
+            ok = (R.coeffs[i] == expected.coeffs[i]);
+
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 7: NTT по простому модулю 998244353 -----
+    {
+        test_count++;
+        printf("[TEST 7] NTT по модулю 998244353 против школьного умножения\n");
+
+        ULL modulo = 998244353;
+        new_pol(&A, 1500, modulo);
+        new_pol(&B, 900, modulo);
+        new_pol(&M, 1200, modulo);
+        for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+        A.coeffs[A.degree] = 1; B.coeffs[B.degree] = 1; M.coeffs[M.degree] = 1;
+
+        Polynomial expected;
+        new_pol(&expected, 0, modulo);
+
+        size_t saved_kara = g_karatsuba_threshold;
+        size_t saved_ntt = g_ntt_threshold;
+        size_t saved_crt = g_ntt_crt_threshold;
+        g_karatsuba_threshold = (size_t)-1;
+        g_ntt_threshold = (size_t)-1;
+        g_ntt_crt_threshold = (size_t)-1;
+        int status_ref = pol_mul_mod_unit(&A, &B, &M, &expected);
+        g_karatsuba_threshold = saved_kara;
+        g_ntt_crt_threshold = saved_crt;
+        g_ntt_threshold = 0;
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        g_ntt_threshold = saved_ntt;
+
+        printf("  Вход: deg A=%zu, deg B=%zu, deg M=%zu mod %llu\n",
+               A.degree, B.degree, M.degree, modulo);
+        printf("  Ожидаем: deg R=%zu (школьное умножение)\n", expected.degree);
+        printf("  Получили: deg R=%zu\n", R.degree);
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && status_ref == POL_SUCCESS &&
+                  R.degree == expected.degree);
+        for (size_t i = 0; ok && i <= R.degree; i++)
+            ok = (R.coeffs[i] == expected.coeffs[i]);
+
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 8: многомодульное NTT с КТО для модуля 10^9 + 7 -----
+    {
+        test_count++;
+        printf("[TEST 8] NTT + КТО по модулю 1000000007 против школьного умножения\n");
+
+        ULL modulo = 1000000007;
+        new_pol(&A, 800, modulo);
+        new_pol(&B, 600, modulo);
+        new_pol(&M, 700, modulo);
+        for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+        for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+        A.coeffs[A.degree] = 1; B.coeffs[B.degree] = 1; M.coeffs[M.degree] = 1;
+
+        Polynomial expected;
+        new_pol(&expected, 0, modulo);
+
+        size_t saved_kara = g_karatsuba_threshold;
+        size_t saved_crt = g_ntt_crt_threshold;
+        g_karatsuba_threshold = (size_t)-1;
+        g_ntt_crt_threshold = (size_t)-1;
+        int status_ref = pol_mul_mod_unit(&A, &B, &M, &expected);
+        g_karatsuba_threshold = saved_kara;
+        g_ntt_crt_threshold = 0;
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        g_ntt_crt_threshold = saved_crt;
+
+        printf("  Вход: deg A=%zu, deg B=%zu, deg M=%zu mod %llu\n",
+               A.degree, B.degree, M.degree, modulo);
+        printf("  Ожидаем: deg R=%zu (школьное умножение)\n", expected.degree);
+        printf("  Получили: deg R=%zu\n", R.degree);
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && status_ref == POL_SUCCESS &&
+                  R.degree == expected.degree);
+        for (size_t i = 0; ok && i <= R.degree; i++)
+            ok = (R.coeffs[i] == expected.coeffs[i]);
+
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 9: 64-битный модуль -----
+    {
+        test_count++;
+        printf("[TEST 9] 64-битный модуль 2^64 - 59\n");
+
+        ULL modulo = 18446744073709551557ULL;
+
+        new_pol(&A, 1, modulo);  // A = -x - 2
+        A.coeffs[0] = modulo - 2; A.coeffs[1] = modulo - 1;
+
+        new_pol(&B, 1, modulo);  // B = -x - 3
+        B.coeffs[0] = modulo - 3; B.coeffs[1] = modulo - 1;
+
+        new_pol(&M, 2, modulo);  // M = x^2 + 1 (унитарный)
+        M.coeffs[0] = 1; M.coeffs[1] = 0; M.coeffs[2] = 1;
+
+        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+
+        printf("  Вход: A=-x-2, B=-x-3, M=x^2+1 mod 2^64-59\n");
+        printf("  Ожидаем: 5x + 5 (произведение x^2+5x+6 переполняет 64 бита)\n");
+        printf("  Получили: "); print_polynomial(&R, "");
+        printf("  Статус: %d", result);
+
+        int ok = (result == POL_SUCCESS && R.degree == 1 &&
+                  R.coeffs[0] == 5 && R.coeffs[1] == 5);
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B); free_pol(&M);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 10: накопление без промежуточных приведений -----
+    {
+        test_count++;
+        printf("[TEST 10] dot_pol: сумма 1000 произведений (m-1)^2 при m = 2^64 - 59\n");
+
+        ULL modulo = 18446744073709551557ULL;
+        size_t degree = 999;
+
+        new_pol(&A, degree, modulo);
+        new_pol(&B, degree, modulo);
+        for (size_t i = 0; i <= degree; i++)
+        {
+            A.coeffs[i] = modulo - 1;
+            B.coeffs[i] = modulo - 1;
+        }
+
+        ULL dot = 0;
+        int result = dot_pol(&A, &B, &dot);
+
+        printf("  Ожидаем: 1000 ((m-1)^2 = 1 mod m, сумма не помещается в 128 бит)\n");
+        printf("  Получили: %llu, статус: %d", dot, result);
+
+        if (result == POL_SUCCESS && dot == 1000)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+
+        free_pol(&A); free_pol(&B);
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 11: векторные ядра против скалярных -----
+    {
+        test_count++;
+        printf("[TEST 11] Векторные ядра против скалярной реализации\n");
+
+        ULL moduli[] = { 7, 998244353, 4294967295ULL, 2305843009213693951ULL,
+                         18446744073709551557ULL };
+        size_t n = 103;   // хвост не кратен ширине вектора
+        ULL a[103], b[103], r_ref[103], r_vec[103];
+
+        const PolVecOps* ref = pol_vec_ops_for(POL_ISA_SCALAR);
+        int ok = 1;
+
+        printf("  Наборы инструкций:");
+        for (int isa = POL_ISA_SCALAR + 1; isa < POL_ISA_COUNT; isa++)
+        {
+            const PolVecOps* ops = pol_vec_ops_for(isa);
+            if (ops == NULL)
+                continue;
+            printf(" %s", ops->name);
+
+            for (size_t t = 0; t < sizeof(moduli) / sizeof(moduli[0]); t++)
+            {
+                PolModCtx ctx;
+                pol_modctx_init(&ctx, moduli[t]);
+
+                // часть коэффициентов не приведена
+                for (size_t i = 0; i < n; i++)
+                {
+                    a[i] = (i % 10 == 0) ? rand64() : rand64() % moduli[t];
+                    b[i] = (i % 13 == 0) ? rand64() : rand64() % moduli[t];
+                }
+                ULL k = rand64();
+
+                ref->add(r_ref, a, b, n, &ctx); ops->add(r_vec, a, b, n, &ctx);
+                ok = ok && memcmp(r_ref, r_vec, sizeof(r_ref)) == 0;
+                ref->sub(r_ref, a, b, n, &ctx); ops->sub(r_vec, a, b, n, &ctx);
+                ok = ok && memcmp(r_ref, r_vec, sizeof(r_ref)) == 0;
+                ref->reduce(r_ref, a, n, &ctx); ops->reduce(r_vec, a, n, &ctx);
+                ok = ok && memcmp(r_ref, r_vec, sizeof(r_ref)) == 0;
+                ref->scale(r_ref, a, k, n, &ctx); ops->scale(r_vec, a, k, n, &ctx);
+                ok = ok && memcmp(r_ref, r_vec, sizeof(r_ref)) == 0;
+                ok = ok && ref->dot(a, b, n, &ctx) == ops->dot(a, b, n, &ctx);
+            }
+        }
+        printf("\n  Выбран по умолчанию: %s", pol_vec_ops()->name);
+
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 12: деление через Ньютона против деления столбиком -----
+    {
+        test_count++;
+        printf("[TEST 12] Остаток через обращение ряда против деления столбиком\n");
+
+        ULL moduli[] = { 998244353, 1000000007ULL };
+        int ok = 1;
+
+        for (size_t t = 0; t < 2; t++)
+        {
+            ULL modulo = moduli[t];
+            new_pol(&A, 3000, modulo);
+            new_pol(&M, 1100, modulo);
+            for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+            for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+            M.coeffs[M.degree] = 1;
+
+            Polynomial expected;
+            new_pol(&expected, 0, modulo);
+
+            size_t saved = g_newton_threshold, saved_crt = g_newton_crt_threshold;
+            g_newton_threshold = g_newton_crt_threshold = (size_t)-1;
+            int status_ref = modulo_unit_pol(&A, &M, &expected);
+            g_newton_threshold = g_newton_crt_threshold = 16;
+            int result = modulo_unit_pol(&A, &M, &R);
+            g_newton_threshold = saved;
+            g_newton_crt_threshold = saved_crt;
+
+            printf("  deg A=%zu, deg M=%zu mod %llu: статус %d/%d\n",
+                   A.degree, M.degree, modulo, status_ref, result);
+
+            ok = ok && status_ref == POL_SUCCESS && result == POL_SUCCESS &&
+                 R.degree == expected.degree;
+            for (size_t i = 0; ok && i <= R.degree; i++)
+                ok = (R.coeffs[i] == expected.coeffs[i]);
+
+            free_pol(&A); free_pol(&M); free_pol(&expected);
+        }
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 13: контекст фиксированного модуля -----
+    {
+        test_count++;
+        printf("[TEST 13] pol_mul_mod_ctx против pol_mul_mod_unit\n");
+
+        ULL moduli[] = { 998244353, 1000000007ULL };
+        size_t degrees[] = { 300, 50 };
+        int ok = 1;
+
+        for (size_t t = 0; t < 2; t++)
+        {
+            ULL modulo = moduli[t];
+            size_t n = degrees[t];
+
+            new_pol(&M, n, modulo);
+            for (size_t i = 0; i < n; i++) M.coeffs[i] = rand64() % modulo;
+            M.coeffs[n] = 1;
+
+            PolModulusCtx ctx;
+            int status = pol_modulus_init(&ctx, &M);
+
+            Polynomial expected;
+            new_pol(&expected, 0, modulo);
+            new_pol(&A, n - 1, modulo);
+            new_pol(&B, n - 1, modulo);
+
+            // несколько умножений подряд с одним контекстом, результат идёт в следующий шаг
+            for (int step = 0; step < 5 && ok && status == POL_SUCCESS; step++)
+            {
+                for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+                if (step == 0)
+                    for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+
+                int status_ref = pol_mul_mod_unit(&A, &B, &M, &expected);
+                int result = pol_mul_mod_ctx(&A, &B, &ctx, &A);
+
+                ok = status_ref == POL_SUCCESS && result == POL_SUCCESS &&
+                     A.degree == expected.degree;
+                for (size_t i = 0; ok && i <= A.degree; i++)
+                    ok = (A.coeffs[i] == expected.coeffs[i]);
+            }
+
+            printf("  deg M=%zu mod %llu (%s): статус %d\n", n, modulo,
+                   ctx.ntt_len ? "NTT" : (ctx.inv ? "Ньютон" : "столбиком"), status);
+            ok = ok && status == POL_SUCCESS;
+
+            pol_modulus_free(&ctx);
+            free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
+        }
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 14: разреженные модули x^n - c -----
+    {
+        test_count++;
+        printf("[TEST 14] Остаток по x^n - c (циклический, нециклический, общий)\n");
+
+        ULL modulo = (1ULL << 61) - 1;
+        ULL consts[] = { 1, modulo - 1, 5 };
+        size_t n = 100;
+        int ok = 1;
+
+        new_pol(&A, 350, modulo);
+        for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+
+        for (size_t t = 0; t < 3 && ok; t++)
+        {
+            ULL c = consts[t];
+            new_pol(&M, n, modulo);
+            for (size_t i = 0; i < n; i++) M.coeffs[i] = 0;
+            M.coeffs[0] = modulo - c;
+            M.coeffs[n] = 1;
+
+            int result = modulo_unit_pol(&A, &M, &R);
+            ok = (result == POL_SUCCESS);
+
+            // x^n = c, поэтому r_i = a_i + c * a_(i+n) + c^2 * a_(i+2n) + ...
+            for (size_t i = 0; ok && i < n; i++)
+            {
+                ULL expected = 0;
+                for (size_t j = A.degree / n + 1; j-- > 0; )
+                {
+                    expected = mul_mod(expected, c, modulo);
+                    if (i + j * n <= A.degree)
+                        expected = add_mod(expected, A.coeffs[i + j * n], modulo);
+                }
+                ULL got = (i <= R.degree) ? R.coeffs[i] : 0;
+                ok = (got == expected);
+            }
+
+            printf("  c = %llu: статус %d\n", c, result);
+            free_pol(&M);
+        }
+        free_pol(&A);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 15: переиспользование результата без выделений памяти -----
+    {
+        test_count++;
+        printf("[TEST 15] Повторное использование R: ёмкость вместо перевыделений\n");
+
+        ULL modulo = 1000000007ULL;
+        PolModCtx ctx;
+        pol_modctx_init(&ctx, modulo);
+
+        Polynomial S;
+        new_pol(&S, 0, modulo);
+        new_pol(&M, 64, modulo);
+        for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+        M.coeffs[M.degree] = 1;
+
+        size_t op_allocated = 0;
+        int ok = 1;
+
+        // остаток считается столбиком на месте, даже если pol_tune.cfg понизил порог Ньютона
+        size_t saved_newton = g_newton_crt_threshold;
+        g_newton_crt_threshold = POL_NEWTON_CRT_THRESHOLD;
+
+        // степени то растут, то падают; со второго круга ёмкости R и S должно хватать
+        for (int round = 0; round < 2 && ok; round++)
+        {
+            for (size_t deg = 1; deg <= 200 && ok; deg += 37)
+            {
+                new_pol(&A, deg, modulo);
+                new_pol(&B, 200 - deg, modulo);
+                for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+                for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+
+                size_t allocated = g_total_allocated;
+                ok = sum_pol_ctx(&A, &B, &R, &ctx) == POL_SUCCESS &&
+                     sub_pol_ctx(&R, &A, &R, &ctx) == POL_SUCCESS &&
+                     copy_pol(&R, &S) == POL_SUCCESS &&
+                     scalar_mul_pol_ctx(&A, 3, &S, &ctx) == POL_SUCCESS &&
+                     modulo_unit_pol_ctx(&A, &M, &R, &ctx) == POL_SUCCESS;
+                if (round == 1)
+                    op_allocated += g_total_allocated - allocated;
+
+                free_pol(&A); free_pol(&B);
+            }
+        }
+
+        g_newton_crt_threshold = saved_newton;
+
+        printf("  ёмкость R = %zu, выделено на втором круге: %zu байт\n",
+               R.capacity, op_allocated);
+        ok = ok && op_allocated == 0;
+
+        // чужой массив (capacity == 0) длиннее результата: переносится не больше новой ёмкости
+        size_t borrowed_len = 1001;
+        ULL* borrowed = malloc(borrowed_len * sizeof(ULL));
+        if (borrowed != NULL)
+        {
+            for (size_t i = 0; i < borrowed_len; i++) borrowed[i] = i;
+            Polynomial T = { borrowed, borrowed_len - 1, modulo, 0 };
+
+            ok = ok && str_to_pol("(1,2)", 7, &T) == POL_SUCCESS &&
+                 T.degree == 1 && T.coeffs[0] == 1 && T.coeffs[1] == 2 &&
+                 T.coeffs != borrowed && T.capacity >= 2 && borrowed[1] == 1;
+            if (T.coeffs != borrowed)
+                free_pol(&T);
+            free(borrowed, borrowed_len * sizeof(ULL));
+        }
+        else
+        {
+            ok = 0;
+        }
+
+        free_pol(&S); free_pol(&M);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 16: рабочая арена -----
+    {
+        test_count++;
+        printf("[TEST 16] pol_mul_mod_unit_ws: арена и R переиспользуются\n");
+
+        ULL modulo = 998244353;
+        PolModCtx ctx;
+        pol_modctx_init(&ctx, modulo);
+
+        PolWorkspace ws;
+        pol_ws_init(&ws, pol_mul_mod_unit_ws_size(599, 599, 600, &ctx));
+
+        Polynomial expected;
+        new_pol(&expected, 0, modulo);
+        new_pol(&A, 599, modulo);
+        new_pol(&B, 599, modulo);
+        new_pol(&M, 600, modulo);
+        for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+        M.coeffs[M.degree] = 1;
+
+        int ok = 1;
+        size_t allocated = 0;
+
+        for (int step = 0; step < 4 && ok; step++)
+        {
+            for (size_t i = 0; i <= A.degree; i++) A.coeffs[i] = rand64() % modulo;
+            for (size_t i = 0; i <= B.degree; i++) B.coeffs[i] = rand64() % modulo;
+
+            int status_ref = pol_mul_mod_unit(&A, &B, &M, &expected);
+
+            size_t before = g_total_allocated;
+            int result = pol_mul_mod_unit_ws(&A, &B, &M, &R, &ws, &ctx);
+            if (step > 0)
+                allocated += g_total_allocated - before;
+
+            ok = status_ref == POL_SUCCESS && result == POL_SUCCESS && ws.used == 0 &&
+                 R.degree == expected.degree;
+            for (size_t i = 0; ok && i <= R.degree; i++)
+                ok = (R.coeffs[i] == expected.coeffs[i]);
+        }
 
-    normalize_pol(P);
-    return POL_SUCCESS;
-}
+        // произведение на месте: R совпадает с A
+        if (ok)
+        {
+            ok = pol_mul_pol_ctx(&A, &B, &expected, &ctx) == POL_SUCCESS &&
+                 pol_mul_pol_ws(&A, &B, &A, &ws, &ctx) == POL_SUCCESS &&
+                 A.degree == expected.degree;
+            for (size_t i = 0; ok && i <= A.degree; i++)
+                ok = (A.coeffs[i] == expected.coeffs[i]);
+        }
 
-size_t pol_bytes(const Polynomial* P)
-{
-    if (!P || !P->coeffs) return 0;
-    return (P->degree + 1) * sizeof(ULL);
-}
+        printf("  выделено после первого шага: %zu байт\n", allocated);
+        ok = ok && allocated == 0;
 
-int manual_test()
-{
-    printf("=== Тестирование pol_mul_mod_unit ===\n\n");
+        pol_ws_free(&ws);
+        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
 
-    int test_count = 0;
-    int passed_count = 0;
-    Polynomial A, B, M, R;
-    new_pol(&R, 0, 2);
-    // ----- ТЕСТ 1: обычное корректное вычисление -----
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 17: снимки счётчиков памяти -----
     {
         test_count++;
-        printf("[TEST 1] Обычное корректное вычисление\n");
-
+        printf("[TEST 17] mem_snapshot / mem_diff: объём, пик, гистограмма\n");
 
-        new_pol(&A, 2, 7);  // A = x^2 + 2x + 3 в Z7
-        A.coeffs[0] = 3; A.coeffs[1] = 2; A.coeffs[2] = 1;
+        MemStats before, after, d;
+        mem_reset_peak();
+        mem_thread_snapshot(&before);
 
-        new_pol(&B, 1, 7);  // B = x + 4 в Z7
-        B.coeffs[0] = 4; B.coeffs[1] = 1;
+        void* p1 = malloc(1000);
+        free(p1, 1000);
+        void* p2 = malloc(500);
 
-        new_pol(&M, 2, 7);  // M = x^2 + 1 (унитарный)
-        M.coeffs[0] = 1; M.coeffs[1] = 0; M.coeffs[2] = 1;
+        mem_thread_snapshot(&after);
+        mem_diff(&before, &after, &d);
+        free(p2, 500);
 
-        // Ожидаем: (x^2+2x+3)(x+4) mod (x^2+1) = 3x + 5 в Z7
-        Polynomial expected;
-        new_pol(&expected, 1, 7);
-        expected.coeffs[0] = 6; expected.coeffs[1] = 3;
+        printf("  выделено %zu, занято %zu, пик %zu, выделений %zu, освобождений %zu\n",
+               d.total_allocated, d.current, d.peak, d.alloc_count, d.free_count);
 
-        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        // 1000 попадает в [512, 1024), 500 — в [256, 512)
+        int ok = d.total_allocated == 1500 && d.total_freed == 1000 && d.current == 500 &&
+                 d.peak == 1000 && d.alloc_count == 2 && d.free_count == 1 &&
+                 d.histogram[10] == 1 && d.histogram[9] == 1;
 
-        printf("  Вход: A="); print_polynomial(&A, "");
-        printf("        B="); print_polynomial(&B, "");
-        printf("        M="); print_polynomial(&M, "");
-        printf("  Ожидаем: "); print_polynomial(&expected, "");
-        printf("  Получили: "); print_polynomial(&R, "");
-        printf("  Статус: %d", result);
+        MemStats global;
+        mem_snapshot(&global);
+        ok = ok && global.peak >= global.current && global.total_allocated >= d.total_allocated;
 
-        // Простая проверка результата
-        int ok = (result == POL_SUCCESS && R.degree == expected.degree &&
-                 R.coeffs[0] == expected.coeffs[0] && R.coeffs[1] == expected.coeffs[1]);
+        printf("  Результат");
         if (ok)
         {
             printf(" -> ПРОЙДЕН\n");
@@ -78,34 +900,70 @@ int manual_test()
         {
             printf(" -> ПРОВАЛ\n");
         }
-
-        free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&expected);
     }
 
     printf("\n");
 
-    // ----- ТЕСТ 2: произведение с нулевым многочленом -----
+    // ----- ТЕСТ 18: пакетное умножение -----
     {
         test_count++;
-        printf("[TEST 2] Произведение с нулевым многочленом\n");
+        printf("[TEST 18] pol_mul_mod_unit_batch против pol_mul_mod_unit\n");
 
-        new_pol(&A, 0, 5);  // A = 0
-        A.coeffs[0] = 0;
-
-        new_pol(&B, 2, 5);  // B = x^2 + 1
-        B.coeffs[0] = 1; B.coeffs[1] = 0; B.coeffs[2] = 1;
+        ULL moduli[] = { 998244353, 1000000007ULL };
+        const size_t count = 24;
+        int ok = 1;
 
-        new_pol(&M, 2, 5);  // M = x^2 + x + 1 (унитарный)
-        M.coeffs[0] = 1; M.coeffs[1] = 1; M.coeffs[2] = 1;
+        Polynomial* batch_a = calloc(count, sizeof(Polynomial));
+        Polynomial* batch_b = calloc(count, sizeof(Polynomial));
+        Polynomial* batch_r = calloc(count, sizeof(Polynomial));
+        ok = batch_a != NULL && batch_b != NULL && batch_r != NULL;
 
-        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        for (size_t t = 0; t < 2 && ok; t++)
+        {
+            ULL modulo = moduli[t];
+            new_pol(&M, 200, modulo);
+            for (size_t i = 0; i < M.degree; i++) M.coeffs[i] = rand64() % modulo;
+            M.coeffs[M.degree] = 1;
+
+            // последний элемент степени больше deg M идёт общим путём
+            for (size_t i = 0; i < count; i++)
+            {
+                size_t deg = (i + 1 == count) ? 300 : 1 + i * 8;
+                new_pol(&batch_a[i], deg, modulo);
+                new_pol(&batch_b[i], 199 - i, modulo);
+                new_pol(&batch_r[i], 0, modulo);
+                for (size_t j = 0; j <= deg; j++) batch_a[i].coeffs[j] = rand64() % modulo;
+                for (size_t j = 0; j <= 199 - i; j++) batch_b[i].coeffs[j] = rand64() % modulo;
+            }
+
+            int result = pol_mul_mod_unit_batch(batch_a, batch_b, count, &M, batch_r);
+            ok = (result == POL_SUCCESS);
+
+            Polynomial expected;
+            new_pol(&expected, 0, modulo);
+            for (size_t i = 0; i < count && ok; i++)
+            {
+                ok = pol_mul_mod_unit(&batch_a[i], &batch_b[i], &M, &expected) == POL_SUCCESS &&
+                     batch_r[i].degree == expected.degree;
+                for (size_t j = 0; ok && j <= expected.degree; j++)
+                    ok = (batch_r[i].coeffs[j] == expected.coeffs[j]);
+            }
+
+            printf("  %zu произведений mod %llu, deg M = %zu: статус %d\n",
+                   count, modulo, M.degree, result);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                free_pol(&batch_a[i]); free_pol(&batch_b[i]); free_pol(&batch_r[i]);
+            }
+            free_pol(&expected); free_pol(&M);
+        }
 
-        printf("  Вход: A=0, B=x^2+1, M=x^2+x+1 mod 5\n");
-        printf("  Ожидаем: 0\n");
-        printf("  Получили: "); print_polynomial(&R, "");
-        printf("  Статус: %d", result);
+        free(batch_a, count * sizeof(Polynomial));
+        free(batch_b, count * sizeof(Polynomial));
+        free(batch_r, count * sizeof(Polynomial));
 
-        int ok = (result == POL_SUCCESS && R.degree == 0 && R.coeffs[0] == 0);
+        printf("  Результат");
         if (ok)
         {
             printf(" -> ПРОЙДЕН\n");
@@ -115,34 +973,60 @@ int manual_test()
         {
             printf(" -> ПРОВАЛ\n");
         }
-
-        free_pol(&A); free_pol(&B); free_pol(&M);
     }
 
     printf("\n");
 
-    // ----- ТЕСТ 3: модуль степени 0 (M = 1) -----
+    // ----- ТЕСТ 19: параллельное умножение больших многочленов -----
     {
         test_count++;
-        printf("[TEST 3] Модуль степени 0 (M = 1)\n");
-
-        new_pol(&A, 1, 11);  // A = x + 2
-        A.coeffs[0] = 2; A.coeffs[1] = 1;
+        printf("[TEST 19] Параллельное pol_mul_pol против последовательного\n");
 
-        new_pol(&B, 1, 11);  // B = x + 3
-        B.coeffs[0] = 3; B.coeffs[1] = 1;
+        // NTT, КТО и Карацуба (пороги NTT подняты)
+        ULL moduli[] = { 998244353, 1000000007ULL, 1000000007ULL };
+        const size_t deg = 20000;
+        size_t saved_par = g_par_threshold;
+        size_t saved_ntt = g_ntt_threshold;
+        size_t saved_crt = g_ntt_crt_threshold;
+        int ok = 1;
 
-        new_pol(&M, 0, 11);  // M = 1 (унитарный)
-        M.coeffs[0] = 1;
+        pol_set_num_threads(4);
 
-        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+        for (size_t t = 0; t < 3 && ok; t++)
+        {
+            ULL modulo = moduli[t];
+            Polynomial X, Y, serial, parallel;
+            new_pol(&X, deg, modulo);
+            new_pol(&Y, deg - 7, modulo);
+            new_pol(&serial, 0, modulo);
+            new_pol(&parallel, 0, modulo);
+            for (size_t i = 0; i <= X.degree; i++) X.coeffs[i] = rand64() % modulo;
+            for (size_t i = 0; i <= Y.degree; i++) Y.coeffs[i] = rand64() % modulo;
+
+            if (t == 2)
+                g_ntt_threshold = g_ntt_crt_threshold = (size_t)-1;
+
+            g_par_threshold = (size_t)-1;
+            ok = pol_mul_pol(&X, &Y, &serial) == POL_SUCCESS;
+            g_par_threshold = 1024;
+            ok = ok && pol_mul_pol(&X, &Y, &parallel) == POL_SUCCESS &&
+                 parallel.degree == serial.degree;
+            for (size_t i = 0; ok && i <= serial.degree; i++)
+                ok = (parallel.coeffs[i] == serial.coeffs[i]);
+
+            g_ntt_threshold = saved_ntt;
+            g_ntt_crt_threshold = saved_crt;
+
+            printf("  deg %zu x %zu mod %llu (%s): %s\n", X.degree, Y.degree, modulo,
+                   (t == 0) ? "NTT" : (t == 1) ? "КТО" : "Карацуба", ok ? "совпадает" : "различается");
+
+            free_pol(&X); free_pol(&Y); free_pol(&serial); free_pol(&parallel);
+        }
 
-        printf("  Вход: A=x+2, B=x+3, M=1 mod 11\n");
-        printf("  Ожидаем: 0 (любое число mod 1 = 0)\n");
-        printf("  Получили: "); print_polynomial(&R, "");
-        printf("  Статус: %d", result);
+        g_par_threshold = saved_par;
+        pol_set_num_threads(0);
 
-        int ok = (result == POL_SUCCESS && R.degree == 0 && R.coeffs[0] == 0);
+        printf("  Результат");
         if (ok)
         {
             printf(" -> ПРОЙДЕН\n");
@@ -152,65 +1036,463 @@ int manual_test()
         {
             printf(" -> ПРОВАЛ\n");
         }
-
-        free_pol(&A); free_pol(&B); free_pol(&M);
     }
 
     printf("\n");
 
-    // ----- ТЕСТ 4: M не унитарный -----
+    // ----- ТЕСТ 20: файл порогов -----
     {
         test_count++;
-        printf("[TEST 4] M не унитарный (старший коэффициент != 1)\n");
+        printf("[TEST 20] pol_tune_save / pol_tune_load\n");
+
+        const char* path = "pol_tune_test.cfg";
+        size_t saved_kara = g_karatsuba_threshold;
+        size_t saved_newton = g_newton_threshold;
+
+        // запись и чтение возвращают те же значения
+        g_karatsuba_threshold = 24;
+        g_newton_threshold = 500;
+        int saved = pol_tune_save(path);
+        g_karatsuba_threshold = saved_kara;
+        g_newton_threshold = saved_newton;
+        int loaded = pol_tune_load(path);
+        int ok = saved == POL_SUCCESS && loaded == POL_SUCCESS &&
+                 g_karatsuba_threshold == 24 && g_newton_threshold == 500;
+        printf("  запись: %d, чтение: %d, karatsuba = %zu, newton = %zu\n",
+               saved, loaded, g_karatsuba_threshold, g_newton_threshold);
+
+        // файл с ошибкой не меняет ни одного порога
+        FILE* f = fopen(path, "w");
+        if (f != NULL)
+        {
+            fprintf(f, "karatsuba = 40\nnewton = many\n");
+            fclose(f);
+        }
+        int broken = pol_tune_load(path);
+        ok = ok && broken == POL_SYNTAX_ERROR && g_karatsuba_threshold == 24;
+        printf("  файл с ошибкой: %d (ожидаем POL_SYNTAX_ERROR = %d)\n", broken, POL_SYNTAX_ERROR);
 
-        new_pol(&A, 0, 7);  // A = 1
-        A.coeffs[0] = 1;
+        ok = ok && pol_tune_load("no_such_dir/pol_tune.cfg") == POL_IO_ERROR;
 
-        new_pol(&B, 0, 7);  // B = 1
-        B.coeffs[0] = 1;
+        remove(path);
+        g_karatsuba_threshold = saved_kara;
+        g_newton_threshold = saved_newton;
 
-        new_pol(&M, 1, 7);  // M = 2x + 1 (не унитарный, старший коэффициент 2)
-        M.coeffs[0] = 1; M.coeffs[1] = 2;
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
 
-        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+    printf("\n");
 
-        printf("  Вход: A=1, B=1, M=2x+1 mod 7\n");
-        printf("  Ожидаем: POL_INVALID_ARG (9, M не унитарный)\n");
-        printf("  Статус: %d", result);
+    // ----- ТЕСТ 21: генератор случайных данных -----
+    {
+        test_count++;
+        printf("[TEST 21] pol_rng: xoshiro256**, диапазон, пакет многочленов\n");
+
+        // эталон xoshiro256**: состояние {1, 2, 3, 4} даёт 11520, затем 0
+        PolRng rng = { { 1, 2, 3, 4 } };
+        ULL first = pol_rng_next(&rng);
+        ULL second = pol_rng_next(&rng);
+        int ok = first == 11520 && second == 0;
+        printf("  первые числа: %llu, %llu\n", first, second);
+
+        // значения в [0, m), старший коэффициент ненулевой
+        const size_t count = 64, degree = 200;
+        const ULL modulo = 1000000007ULL;
+        Polynomial P1[64], P2[64];
+        memset(P1, 0, sizeof(P1));
+        memset(P2, 0, sizeof(P2));
+
+        pol_rng_seed(&rng, 42);
+        int s1 = pol_rng_pols(&rng, P1, count, degree, modulo);
+        ok = ok && s1 == POL_SUCCESS;
+        for (size_t i = 0; i < count && ok; i++)
+        {
+            ok = P1[i].degree == degree && P1[i].modulo == modulo && P1[i].coeffs[degree] != 0;
+            for (size_t j = 0; j <= degree && ok; j++)
+                ok = P1[i].coeffs[j] < modulo;
+        }
 
-        if (result == POL_INVALID_ARG) {
+        // пакет не зависит от числа потоков
+        int saved_threads = pol_get_num_threads();
+        pol_set_num_threads(1);
+        pol_rng_seed(&rng, 42);
+        int s2 = pol_rng_pols(&rng, P2, count, degree, modulo);
+        pol_set_num_threads(saved_threads);
+        ok = ok && s2 == POL_SUCCESS;
+        for (size_t i = 0; i < count && ok; i++)
+            ok = memcmp(P1[i].coeffs, P2[i].coeffs, (degree + 1) * sizeof(ULL)) == 0;
+
+        // соседние потоки одного seed не совпадают
+        PolRng a, b;
+        pol_rng_stream(&a, 7, 0);
+        pol_rng_stream(&b, 7, 1);
+        ok = ok && pol_rng_next(&a) != pol_rng_next(&b);
+
+        // граница 2^k и граница 1
+        pol_rng_fill(&rng, P2[0].coeffs, degree + 1, 8);
+        for (size_t j = 0; j <= degree && ok; j++)
+            ok = P2[0].coeffs[j] < 8;
+        ok = ok && pol_rng_below(&rng, 1) == 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            free_pol(&P1[i]);
+            free_pol(&P2[i]);
+        }
+
+        printf("  Результат");
+        if (ok)
+        {
             printf(" -> ПРОЙДЕН\n");
             passed_count++;
-        } else {
+        }
+        else
+        {
             printf(" -> ПРОВАЛ\n");
         }
+    }
 
-        free_pol(&A); free_pol(&B); free_pol(&M);
+    printf("\n");
+
+    // ----- ТЕСТ 22: двоичный формат и отображение файла -----
+    {
+        test_count++;
+        printf("[TEST 22] pol_save_bin / pol_load_bin / pol_map_bin\n");
+
+        const char* path = "pol_bin_test.polb";
+        Polynomial P, L, Q, S;
+        new_pol(&P, 0, 2);
+        new_pol(&L, 0, 2);
+        new_pol(&Q, 0, 2);
+        new_pol(&S, 0, 2);
+
+        // упакованная ширина: модуль 10^9 + 7 помещается в 4 байта
+        get_rand_pol(&P, 5000, 1000000007ULL);
+        int saved = pol_save_bin(path, &P, 0);
+        int loaded = pol_load_bin(path, &L);
+        int ok = saved == POL_SUCCESS && loaded == POL_SUCCESS &&
+                 L.degree == P.degree && L.modulo == P.modulo &&
+                 memcmp(L.coeffs, P.coeffs, (P.degree + 1) * sizeof(ULL)) == 0;
+        printf("  ширина 4: запись %d, чтение %d\n", saved, loaded);
+
+        // ширина 8: коэффициенты берутся прямо из отображения
+        PolMapping map;
+        get_rand_pol(&P, 3000, 18446744073709551557ULL);
+        saved = pol_save_bin(path, &P, 8);
+        int mapped = pol_map_bin(path, &map, &Q);
+        ok = ok && saved == POL_SUCCESS && mapped == POL_SUCCESS &&
+             Q.degree == P.degree && Q.modulo == P.modulo &&
+             memcmp(Q.coeffs, P.coeffs, (P.degree + 1) * sizeof(ULL)) == 0;
+        printf("  ширина 8: отображение %d, capacity = %zu\n", mapped, Q.capacity);
+
+        // отображённый многочлен — обычный аргумент операций
+        int mul_status = pol_mul_pol(&Q, &P, &S);
+        ok = ok && mul_status == POL_SUCCESS && S.degree == 2 * P.degree;
+        free_pol(&Q);
+        pol_unmap_bin(&map);
+
+        // и обычный приёмник: короткий результат получает собственный буфер
+        Polynomial F, G, H;
+        ULL m = 18446744073709551557ULL;
+        new_pol(&F, 1, m);
+        new_pol(&G, 1, m);
+        new_pol(&H, 2, m);
+        F.coeffs[0] = 2; F.coeffs[1] = 1;       // x + 2
+        G.coeffs[0] = 3; G.coeffs[1] = 1;       // x + 3
+        H.coeffs[0] = 1; H.coeffs[2] = 1;       // x^2 + 1
+        // (x + 2)(x + 3) = x^2 + 5x + 6 = 5x + 5 mod (x^2 + 1)
+        ok = ok && pol_map_bin(path, &map, &Q) == POL_SUCCESS &&
+             pol_mul_mod_unit(&F, &G, &H, &Q) == POL_SUCCESS &&
+             Q.degree == 1 && Q.coeffs[0] == 5 && Q.coeffs[1] == 5 && Q.capacity > 0;
+        free_pol(&Q);
+        pol_unmap_bin(&map);
+
+        ok = ok && pol_map_bin(path, &map, &Q) == POL_SUCCESS &&
+             str_to_pol("(1,2)", 7, &Q) == POL_SUCCESS &&
+             Q.degree == 1 && Q.modulo == 7 && Q.coeffs[0] == 1 && Q.coeffs[1] == 2;
+        free_pol(&Q);
+        pol_unmap_bin(&map);
+        free_pol(&F);
+        free_pol(&G);
+        free_pol(&H);
+
+        // неприведённый коэффициент в последней порции: файл не остаётся
+        P.coeffs[P.degree - 1] = P.modulo;
+        ok = ok && pol_save_bin(path, &P, 8) == POL_INVALID_ARG;
+        FILE* partial = fopen(path, "rb");
+        ok = ok && partial == NULL;
+        if (partial != NULL)
+            fclose(partial);
+        P.coeffs[P.degree - 1] = 0;
+
+        // узкая ширина для большого модуля и испорченный заголовок
+        ok = ok && pol_save_bin(path, &P, 4) == POL_INVALID_ARG;
+        FILE* f = fopen(path, "wb");
+        if (f != NULL)
+        {
+            fprintf(f, "(1,2,3) — текст, а не POLB...............");
+            fclose(f);
+        }
+        ok = ok && pol_load_bin(path, &L) == POL_SYNTAX_ERROR;
+        ok = ok && pol_map_bin(path, &map, &L) == POL_SYNTAX_ERROR && map.addr == NULL;
+
+        remove(path);
+        free_pol(&P);
+        free_pol(&L);
+        free_pol(&S);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
     }
 
     printf("\n");
 
-    // ----- ТЕСТ 5: деление на нулевой многочлен -----
+    // ----- ТЕСТ 23: однопроходный и потоковый разбор строки -----
     {
         test_count++;
-        printf("[TEST 5] Деление на нулевой многочлен\n");
+        printf("[TEST 23] str_to_pol: длинные числа, переводы строк, pol_read_str\n");
+
+        Polynomial P, L;
+        new_pol(&P, 0, 2);
+        new_pol(&L, 0, 2);
+
+        // 10^30 и -2^128 по модулю 10^9 + 7 — без переполнения
+        int status = str_to_pol("( 1000000000000000000000000000000,\n"
+                                "  -340282366920938463463374607431768211456 )", 1000000007ULL, &P);
+        int ok = status == POL_SUCCESS && P.degree == 1 &&
+                 P.coeffs[0] == 999657007ULL && P.coeffs[1] == 720367730ULL;
+        printf("  длинные числа: статус %d, c0 = %llu, c1 = %llu\n", status,
+               P.coeffs[0], (P.degree >= 1) ? P.coeffs[1] : 0ULL);
+
+        // текст длиннее порции чтения: числа разрезаны границами порций
+        get_rand_pol(&P, 40000, 18446744073709551557ULL);
+        char* text = NULL;
+        size_t text_size = 0;
+        const char* path = "pol_str_test.txt";
+        FILE* f = NULL;
+        if (pol_to_str(&P, &text, &text_size) == POL_SUCCESS && (f = fopen(path, "wb")) != NULL)
+        {
+            fputs(text, f);
+            fputs(" (1,2)", f);
+            fclose(f);
+        }
 
-        new_pol(&A, 0, 13);  // A = 1
-        A.coeffs[0] = 1;
+        f = fopen(path, "rb");
+        int first = (f != NULL) ? pol_read_str(f, P.modulo, &L) : POL_IO_ERROR;
+        ok = ok && first == POL_SUCCESS && L.degree == P.degree &&
+             memcmp(L.coeffs, P.coeffs, (P.degree + 1) * sizeof(ULL)) == 0;
+
+        // поток стоит сразу за ')': следующий многочлен читается тем же вызовом
+        int second = (f != NULL) ? pol_read_str(f, 7, &L) : POL_IO_ERROR;
+        ok = ok && second == POL_SUCCESS && L.degree == 1 && L.coeffs[0] == 1 && L.coeffs[1] == 2;
+        int third = (f != NULL) ? pol_read_str(f, 7, &L) : POL_IO_ERROR;
+        ok = ok && third == POL_INVALID_ARG && L.degree == 1;   // L не тронут
+        printf("  из файла: %d, %d, конец файла: %d\n", first, second, third);
+        if (f != NULL)
+            fclose(f);
+
+        ok = ok && str_to_pol("(1,2", 7, &L) == POL_INVALID_ARG &&
+             str_to_pol("(1,-)", 7, &L) == POL_INVALID_ARG;
+
+        remove(path);
+        if (text != NULL)
+            free(text, text_size);
+        free_pol(&P);
+        free_pol(&L);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
 
-        new_pol(&B, 0, 13);  // B = 1
-        B.coeffs[0] = 1;
+    printf("\n");
 
-        new_pol(&M, 0, 13);  // M = 0
-        M.coeffs[0] = 0;
+    // ----- ТЕСТ 24: запись строки в буфер и в поток -----
+    {
+        test_count++;
+        printf("[TEST 24] pol_to_str_buf / pol_write_str\n");
+
+        Polynomial P, L;
+        new_pol(&P, 3, 1000);
+        new_pol(&L, 0, 2);
+        P.coeffs[0] = 0; P.coeffs[1] = 9; P.coeffs[2] = 10; P.coeffs[3] = 999;
+
+        // "(0,9,10,999)": 12 символов и '\0'
+        char buf[16];
+        size_t len = 0;
+        int fit = pol_to_str_buf(&P, buf, 13, &len);
+        int ok = fit == POL_SUCCESS && len == 12 && strcmp(buf, "(0,9,10,999)") == 0;
+        int small = pol_to_str_buf(&P, buf, 12, &len);
+        ok = ok && small == POL_BUFFER_SMALL && pol_str_bound(&P) >= 13;
+        printf("  в буфер: %d, \"%s\"; на байт меньше: %d\n", fit, (fit == POL_SUCCESS) ? buf : "", small);
+
+        // поток: несколько порций записи, затем обратный разбор
+        const char* path = "pol_write_test.txt";
+        get_rand_pol(&P, 30000, 18446744073709551557ULL);
+        FILE* f = fopen(path, "wb");
+        int written = (f != NULL) ? pol_write_str(f, &P) : POL_IO_ERROR;
+        if (f != NULL)
+            fclose(f);
+
+        f = fopen(path, "rb");
+        int parsed = (f != NULL) ? pol_read_str(f, P.modulo, &L) : POL_IO_ERROR;
+        if (f != NULL)
+            fclose(f);
+        ok = ok && written == POL_SUCCESS && parsed == POL_SUCCESS && L.degree == P.degree &&
+             memcmp(L.coeffs, P.coeffs, (P.degree + 1) * sizeof(ULL)) == 0;
+        printf("  в файл и обратно: %d, %d\n", written, parsed);
+
+        remove(path);
+        free_pol(&P);
+        free_pol(&L);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
+    }
 
-        int result = pol_mul_mod_unit(&A, &B, &M, &R);
+    printf("\n");
 
-        printf("  Вход: A=1, B=1, M=0 mod 13\n");
-        printf("  Ожидаем: POL_ZERO_DIV (5, деление на нулевой многочлен)\n");
-        printf("  Статус: %d", result);
+    // ----- ТЕСТ 25: конвейерная обработка файла заданий -----
+    {
+        test_count++;
+        printf("[TEST 25] pol_jobs_run\n");
+
+        const ULL m = 1000000007ULL;
+        const size_t count = 40;
+        const char* in_path = "pol_jobs_in.txt";
+        const char* out_path = "pol_jobs_out.txt";
+        const char* ref_path = "pol_jobs_ref.txt";
+
+        // вход и ожидаемый выход; среди заданий — синтаксическая ошибка и неунитарный M
+        Polynomial A, B, M, T;
+        new_pol(&A, 0, m);
+        new_pol(&B, 0, m);
+        new_pol(&M, 0, m);
+        new_pol(&T, 0, m);
+        FILE* in = fopen(in_path, "wb");
+        FILE* ref = fopen(ref_path, "wb");
+        int ok = in != NULL && ref != NULL;
+        size_t expect_failed = 0;
+        for (size_t i = 0; i < count && ok; i++)
+        {
+            if (i == 5)
+            {
+                // незакрытый многочлен не захватывает следующую строку
+                fprintf(in, "(1,2 (3) (1,1)\n\n(1,\n");
+                fprintf(ref, "error %d\n", POL_INVALID_ARG);
+                expect_failed++;
+                fprintf(ref, "error %d\n", POL_INVALID_ARG);
+                expect_failed++;
+                continue;
+            }
+
+            get_rand_pol(&A, (size_t)(rand64() % 40), m);
+            get_rand_pol(&B, (size_t)(rand64() % 40), m);
+            get_rand_pol(&M, 1 + (size_t)(rand64() % 16), m);
+            if (i != 11)
+                M.coeffs[M.degree] = 1;
+
+            pol_write_str(in, &A);
+            fputc(' ', in);
+            pol_write_str(in, &B);
+            fputc(' ', in);
+            pol_write_str(in, &M);
+            fputc('\n', in);
+
+            int status = pol_mul_mod_unit(&A, &B, &M, &T);
+            if (status == POL_SUCCESS)
+            {
+                pol_write_str(ref, &T);
+                fputc('\n', ref);
+            }
+            else
+            {
+                fprintf(ref, "error %d\n", status);
+                expect_failed++;
+            }
+        }
+        if (in != NULL)
+            fclose(in);
+        if (ref != NULL)
+            fclose(ref);
+
+        // очередь короче числа заданий: кольцо проходится много раз
+        PolJobsConfig cfg = { m, 2, 3 };
+        PolJobsStats stats;
+        int status = POL_IO_ERROR;
+        in = fopen(in_path, "rb");
+        FILE* out = fopen(out_path, "wb");
+        if (in != NULL && out != NULL)
+            status = pol_jobs_run(in, out, &cfg, &stats);
+        if (in != NULL)
+            fclose(in);
+        if (out != NULL)
+            fclose(out);
+        ok = ok && status == POL_SUCCESS && stats.jobs == count + 1 &&
+             stats.failed == expect_failed && expect_failed == 3;
+        printf("  статус: %d, заданий: %zu, ошибок: %zu\n", status,
+               (status == POL_SUCCESS) ? stats.jobs : 0, (status == POL_SUCCESS) ? stats.failed : 0);
+
+        // выход совпадает с последовательным вычислением побайтно
+        out = fopen(out_path, "rb");
+        ref = fopen(ref_path, "rb");
+        int same = out != NULL && ref != NULL;
+        while (same)
+        {
+            int a = fgetc(out), b = fgetc(ref);
+            same = (a == b);
+            if (a == EOF || b == EOF)
+                break;
+        }
+        if (out != NULL)
+            fclose(out);
+        if (ref != NULL)
+            fclose(ref);
+        ok = ok && same;
+        printf("  выход совпадает с последовательным: %s\n", same ? "да" : "нет");
+
+        remove(in_path);
+        remove(out_path);
+        remove(ref_path);
+        free_pol(&A);
+        free_pol(&B);
+        free_pol(&M);
+        free_pol(&T);
 
-        if (result == POL_ZERO_DIV)
+        printf("  Результат");
+        if (ok)
         {
             printf(" -> ПРОЙДЕН\n");
             passed_count++;
@@ -219,8 +1501,104 @@ int manual_test()
         {
             printf(" -> ПРОВАЛ\n");
         }
+    }
+
+    printf("\n");
+
+    // ----- ТЕСТ 26: упакованные многочлены над GF(2) -----
+    {
+        test_count++;
+        printf("[TEST 26] PolGF2 и pol_mul_mod_unit при modulo == 2 (%s)\n", pol_gf2_kernel());
+
+        Polynomial A, B, M, T, E, G;
+        new_pol(&A, 0, 2);
+        new_pol(&B, 0, 2);
+        new_pol(&M, 0, 2);
+        new_pol(&T, 0, 2);
+        new_pol(&E, 0, 2);
+        new_pol(&G, 0, 2);
+        PolGF2 pa, pb, pm;
+        pol_gf2_new(&pa, 0);
+        pol_gf2_new(&pb, 0);
+        pol_gf2_new(&pm, 0);
+
+        // (x + 1)^2 = x^2 + 1: переносов между коэффициентами нет
+        realloc_coeffs(&A, 1);
+        set_pol_params(&A, 1, 2);
+        A.coeffs[0] = A.coeffs[1] = 1;
+        pol_gf2_from_pol(&A, &pa);
+        int ok = pol_gf2_mul(&pa, &pa, &pb) == POL_SUCCESS && pb.degree == 2 && pb.words[0] == 5;
+
+        // модули: плотный с коротким и с длинным частным и трёхчлен x^233 + x^74 + 1
+        const size_t deg_a[] = { 40, 3000, 232 };
+        const size_t deg_b[] = { 40, 2000, 232 };
+        const size_t deg_m[] = { 70, 4000, 233 };
+        for (int kernel = 1; kernel >= 0; kernel--)
+        {
+            if (kernel && pol_gf2_set_clmul(1) != POL_SUCCESS)
+                continue;
+            if (!kernel)
+                pol_gf2_set_clmul(0);
+
+            for (int k = 0; k < 3; k++)
+            {
+                get_rand_pol(&A, deg_a[k], 2);
+                get_rand_pol(&B, deg_b[k], 2);
+                if (k == 2)
+                {
+                    realloc_coeffs(&M, deg_m[k]);
+                    set_pol_params(&M, deg_m[k], 2);
+                    memset(M.coeffs, 0, (deg_m[k] + 1) * sizeof(ULL));
+                    M.coeffs[233] = M.coeffs[74] = M.coeffs[0] = 1;
+                }
+                else
+                {
+                    get_rand_pol(&M, deg_m[k], 2);
+                }
+
+                // эталон — умножение и деление по ULL на коэффициент
+                pol_mul_pol(&A, &B, &T);
+                modulo_unit_pol(&T, &M, &E);
+                int direct = pol_mul_mod_unit(&A, &B, &M, &G);
+                ok = ok && direct == POL_SUCCESS && G.degree == E.degree &&
+                     memcmp(G.coeffs, E.coeffs, (E.degree + 1) * sizeof(ULL)) == 0;
+
+                pol_gf2_from_pol(&A, &pa);
+                pol_gf2_from_pol(&B, &pb);
+                pol_gf2_from_pol(&M, &pm);
+                int packed = pol_gf2_mul_mod(&pa, &pb, &pm, &pa);
+                if (packed == POL_SUCCESS)
+                    packed = pol_gf2_to_pol(&pa, &G);
+                ok = ok && packed == POL_SUCCESS && G.degree == E.degree &&
+                     memcmp(G.coeffs, E.coeffs, (E.degree + 1) * sizeof(ULL)) == 0;
+            }
+            printf("  %s: %s\n", pol_gf2_kernel(), ok ? "совпадает с эталоном" : "расхождение");
+        }
+        pol_gf2_set_clmul(1);
 
-        free_pol(&A); free_pol(&B); free_pol(&M);
+        get_rand_pol(&A, 10, 3);
+        ok = ok && pol_gf2_from_pol(&A, &pa) == POL_INVALID_MODULO;
+
+        free_pol(&A);
+        free_pol(&B);
+        free_pol(&M);
+        free_pol(&T);
+        free_pol(&E);
+        free_pol(&G);
+        pol_gf2_free(&pa);
+        pol_gf2_free(&pb);
+        pol_gf2_free(&pm);
+
+        printf("  Результат");
+        if (ok)
+        {
+            printf(" -> ПРОЙДЕН\n");
+            passed_count++;
+        }
+        else
+        {
+            printf(" -> ПРОВАЛ\n");
+        }
     }
     free_pol(&R);
 
@@ -345,8 +1723,8 @@ int input_test()
 
 int auto_test()
 {
-    // srand((unsigned)time(NULL));
-    srand(1);
+    // pol_rng_global_seed((ULL)time(NULL));
+    pol_rng_global_seed(1);
 
     int test_variant;
     printf("Choose test variant (1 = fix C vs M, 2 = fix degree of divisor M): ");
@@ -416,9 +1794,12 @@ int auto_test()
     get_rand_pol(&A, deg_A, modulo);
     get_rand_pol(&B, deg_B, modulo);
     get_rand_pol(&M, deg_M, modulo);
+    M.coeffs[deg_M] = 1;
 
-    // Сохраняем начальные значения памяти
-    size_t mem_before = g_current_allocated;
+    // Сохраняем начальные значения памяти (счётчики потока: чужие выделения не мешают)
+    MemStats mem_before, mem_after, mem;
+    mem_reset_peak();
+    mem_thread_snapshot(&mem_before);
 
     int status = pol_mul_mod_unit(&A, &B, &M, &R);
     if (status != POL_SUCCESS)
@@ -428,7 +1809,8 @@ int auto_test()
         return status;
     }
 
-    size_t mem_after = g_current_allocated;
+    mem_thread_snapshot(&mem_after);
+    mem_diff(&mem_before, &mem_after, &mem);
 
     size_t bytes_A = pol_bytes(&A);
     size_t bytes_B = pol_bytes(&B);
@@ -436,22 +1818,145 @@ int auto_test()
     size_t bytes_R = pol_bytes(&R);
 
     // Консольный вывод
-    printf("degA=%zu, degB=%zu, degM=%zu, degR=%zu, bytesA=%zu, bytesB=%zu, bytesM=%zu, bytesR=%zu, mem_delta=%zu\n",
+    printf("degA=%zu, degB=%zu, degM=%zu, degR=%zu, bytesA=%zu, bytesB=%zu, bytesM=%zu, bytesR=%zu, mem_delta=%zu, mem_peak=%zu, allocs=%zu\n",
            A.degree, B.degree, M.degree, R.degree,
            bytes_A, bytes_B, bytes_M, bytes_R,
-           mem_after - mem_before);
+           mem.current, mem.peak, mem.alloc_count);
 
     // CSV вывод
     FILE* f = fopen("result.csv", "a");
     if (f)
     {
-        fprintf(f, "%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu\n",
+        fprintf(f, "%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu\n",
                 A.degree, B.degree, M.degree, R.degree,
                 bytes_A, bytes_B, bytes_M, bytes_R,
-                mem_after - mem_before);
+                mem.current, mem.peak, mem.alloc_count);
         fclose(f);
     }
 
     free_pol(&A); free_pol(&B); free_pol(&M); free_pol(&R);
     return 0;
-}
\ No newline at end of file
+}
+
+int mulmod_bench()
+{
+    static const ULL moduli[] = {
+        1000000007ULL,              // < 2^32
+        2305843009213693951ULL,     // 2^61 - 1
+        18446744073709551557ULL     // 2^64 - 59
+    };
+    const size_t n = 1 << 16;
+    const int rounds = 64;
+
+    ULL* a = malloc(n * sizeof(ULL));
+    ULL* b = malloc(n * sizeof(ULL));
+    ULL* c = malloc(n * sizeof(ULL));
+    if (a == NULL || b == NULL || c == NULL)
+    {
+        free(a, n * sizeof(ULL));
+        free(b, n * sizeof(ULL));
+        free(c, n * sizeof(ULL));
+        return TEST_MEMORY_ERROR;
+    }
+
+    printf("%-22s %10s %10s %8s %10s\n", "modulo", "64-bit ns", "mul_mod ns", "ratio", "wrong");
+
+    for (size_t k = 0; k < sizeof(moduli) / sizeof(moduli[0]); k++)
+    {
+        ULL m = moduli[k];
+        for (size_t i = 0; i < n; i++)
+        {
+            a[i] = rand64() % m;
+            b[i] = rand64() % m;
+        }
+
+        size_t wrong = 0;
+        for (size_t i = 0; i < n; i++)
+            wrong += ((a[i] * b[i]) % m != mul_mod(a[i], b[i], m));
+
+        // c[i] = c[i] * b[i] mod m на месте, чтобы компилятор не вынес цикл
+        for (size_t i = 0; i < n; i++) c[i] = a[i];
+        clock_t start = clock();
+        for (int r = 0; r < rounds; r++)
+            for (size_t i = 0; i < n; i++)
+                c[i] = (c[i] * b[i]) % m;
+        double old_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double)n * rounds);
+
+        for (size_t i = 0; i < n; i++) c[i] = a[i];
+        start = clock();
+        for (int r = 0; r < rounds; r++)
+            for (size_t i = 0; i < n; i++)
+                c[i] = mul_mod(c[i], b[i], m);
+        double new_ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / ((double)n * rounds);
+
+        printf("%-22llu %10.2f %10.2f %8.2f %10zu\n",
+               m, old_ns, new_ns, new_ns / old_ns, wrong);
+    }
+
+    free(a, n * sizeof(ULL));
+    free(b, n * sizeof(ULL));
+    free(c, n * sizeof(ULL));
+    return TEST_SUCCESS;
+}
+
+int alloc_bench()
+{
+    static const size_t degrees[] = { 8, 32, 128, 512 };
+    const ULL modulo = 1000000007ULL;
+    const size_t batch = 256;
+
+    PolModCtx ctx;
+    pol_modctx_init(&ctx, modulo);
+
+    printf("backend: %s\n", mem_backend_name());
+    printf("%-8s %14s %12s\n", "degree", "products/s", "allocs/prod");
+
+    for (size_t k = 0; k < sizeof(degrees) / sizeof(degrees[0]); k++)
+    {
+        size_t deg = degrees[k];
+        int rounds = (int)(200000 / (deg * 4 + 64)) + 1;
+
+        Polynomial M;
+        if (new_pol(&M, deg + 1, modulo) != POL_SUCCESS)
+            return TEST_MEMORY_ERROR;
+        for (size_t i = 0; i <= deg; i++) M.coeffs[i] = rand64() % modulo;
+        M.coeffs[deg + 1] = 1;
+
+        MemStats before, after, d;
+        mem_thread_snapshot(&before);
+        clock_t start = clock();
+
+        // пакет: на каждое произведение свои A, B и R, как при обработке потока задач
+        for (int r = 0; r < rounds; r++)
+        {
+            for (size_t j = 0; j < batch; j++)
+            {
+                Polynomial A, B, R;
+                if (new_pol(&A, deg, modulo) != POL_SUCCESS ||
+                    new_pol(&B, deg, modulo) != POL_SUCCESS ||
+                    new_pol(&R, 0, modulo) != POL_SUCCESS)
+                    return TEST_MEMORY_ERROR;
+
+                for (size_t i = 0; i <= deg; i++)
+                {
+                    A.coeffs[i] = (i * 7 + j) % modulo;
+                    B.coeffs[i] = (i * 13 + r) % modulo;
+                }
+
+                pol_mul_mod_unit_ctx(&A, &B, &M, &R, &ctx);
+                free_pol(&A); free_pol(&B); free_pol(&R);
+            }
+        }
+
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        mem_thread_snapshot(&after);
+        mem_diff(&before, &after, &d);
+
+        double products = (double)rounds * (double)batch;
+        printf("%-8zu %14.0f %12.2f\n", deg, products / seconds, (double)d.alloc_count / products);
+
+        free_pol(&M);
+    }
+
+    return TEST_SUCCESS;
+}